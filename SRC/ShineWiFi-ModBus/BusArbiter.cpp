@@ -0,0 +1,158 @@
+#include "BusArbiter.h"
+
+BusArbiter::BusArbiter() : _WindowStart(0), _Start(0) {
+  const uint32_t budgets[BusClassCount] = {
+      BUS_CONTROL_BUDGET, BUS_TELEMETRY_BUDGET, BUS_DIAGNOSTIC_BUDGET};
+  for (uint8_t c = 0; c < BusClassCount; c++) {
+    sBusClassState_t& state = _Classes[c];
+    state.head = 0;
+    state.count = 0;
+    state.budget = budgets[c];
+    state.used = 0;
+    state.estimate = 0;
+    state.executed = 0;
+    state.rejected = 0;
+    state.busTime = 0;
+  }
+}
+
+const char* BusArbiter::GetClassName(eBusClass_t busClass) {
+  static const char* const names[BusClassCount] = {"control", "telemetry",
+                                                   "diagnostic"};
+  return names[busClass];
+}
+
+void BusArbiter::rollWindow(uint32_t now) {
+  if (now - _WindowStart >= BUS_BUDGET_WINDOW) {
+    for (uint8_t c = 0; c < BusClassCount; c++) {
+      _Classes[c].used = 0;
+    }
+    _WindowStart = now;
+  }
+}
+
+bool BusArbiter::admit(eBusClass_t busClass, uint32_t deadline) {
+  /**
+   * @brief Check if work of a class may use the bus now
+   * @param busClass priority class of the work
+   * @param deadline millis() at which the next poll is due
+   * @returns true if the budget allows it and, except for control work, it
+   * is expected to finish before the deadline
+   */
+  uint32_t now = millis();
+  rollWindow(now);
+  const sBusClassState_t& state = _Classes[busClass];
+  if (state.used >= state.budget) {
+    return false;
+  }
+  if (busClass != BusControl &&
+      (int32_t)(deadline - (now + state.estimate)) < 0) {
+    return false;
+  }
+  return true;
+}
+
+bool BusArbiter::Submit(eBusClass_t busClass, BusJob job) {
+  /**
+   * @brief Queue work to be run by Service()
+   * @param busClass priority class of the work
+   * @param job work to run, it may access the bus
+   * @returns false if the queue of the class is full and the job rejected
+   */
+  sBusClassState_t& state = _Classes[busClass];
+  if (state.count >= BUS_QUEUE_SIZE) {
+    state.rejected++;
+    return false;
+  }
+  state.jobs[(state.head + state.count) % BUS_QUEUE_SIZE] = job;
+  state.count++;
+  return true;
+}
+
+void BusArbiter::Service(uint32_t deadline) {
+  /**
+   * @brief Run queued work in order of priority as long as the budgets and
+   * the next poll allow it. Has to be called in between the polls.
+   * @param deadline millis() at which the next poll is due
+   */
+  for (uint8_t c = 0; c < BusClassCount; c++) {
+    sBusClassState_t& state = _Classes[c];
+    while (state.count > 0 && admit((eBusClass_t)c, deadline)) {
+      BusJob job = state.jobs[state.head];
+      state.jobs[state.head] = nullptr;
+      state.head = (state.head + 1) % BUS_QUEUE_SIZE;
+      state.count--;
+
+      Begin((eBusClass_t)c);
+      job();
+      Release((eBusClass_t)c);
+    }
+  }
+}
+
+bool BusArbiter::Acquire(eBusClass_t busClass, uint32_t deadline) {
+  /**
+   * @brief Admit work that can not be queued, e.g. because a HTTP request is
+   * waiting for the result. Queued work of the same or a higher priority
+   * goes first. Has to be followed by Release().
+   * @param busClass priority class of the work
+   * @param deadline millis() at which the next poll is due
+   * @returns true if the work may use the bus now
+   */
+  for (uint8_t c = 0; c <= busClass; c++) {
+    if (_Classes[c].count > 0) {
+      _Classes[busClass].rejected++;
+      return false;
+    }
+  }
+  if (!admit(busClass, deadline)) {
+    _Classes[busClass].rejected++;
+    return false;
+  }
+  Begin(busClass);
+  return true;
+}
+
+void BusArbiter::Release(eBusClass_t busClass) {
+  sBusClassState_t& state = _Classes[busClass];
+  uint32_t elapsed = millis() - _Start;
+  End(busClass);
+  // follow longer jobs quickly, a missed deadline costs more than a reject
+  if (elapsed > state.estimate) {
+    state.estimate = (state.estimate + elapsed) / 2;
+  } else {
+    state.estimate = (3 * state.estimate + elapsed) / 4;
+  }
+}
+
+void BusArbiter::Begin(eBusClass_t) { _Start = millis(); }
+
+void BusArbiter::End(eBusClass_t busClass) {
+  /**
+   * @brief Charge the bus time since Begin() to the class
+   * @param busClass priority class of the work
+   */
+  sBusClassState_t& state = _Classes[busClass];
+  uint32_t now = millis();
+  uint32_t elapsed = now - _Start;
+  rollWindow(now);
+  state.used += elapsed;
+  state.busTime += elapsed;
+  state.executed++;
+}
+
+uint32_t BusArbiter::GetJobs(eBusClass_t busClass) {
+  return _Classes[busClass].executed;
+}
+
+uint32_t BusArbiter::GetRejected(eBusClass_t busClass) {
+  return _Classes[busClass].rejected;
+}
+
+uint32_t BusArbiter::GetBusTime(eBusClass_t busClass) {
+  return _Classes[busClass].busTime;
+}
+
+uint8_t BusArbiter::GetQueued(eBusClass_t busClass) {
+  return _Classes[busClass].count;
+}
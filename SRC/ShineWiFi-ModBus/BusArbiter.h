@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Arduino.h"
+#include <functional>
+
+#ifndef BUS_QUEUE_SIZE
+#define BUS_QUEUE_SIZE 4
+#endif
+#ifndef BUS_BUDGET_WINDOW
+#define BUS_BUDGET_WINDOW 1000
+#endif
+#ifndef BUS_CONTROL_BUDGET
+#define BUS_CONTROL_BUDGET 1000
+#endif
+#ifndef BUS_TELEMETRY_BUDGET
+#define BUS_TELEMETRY_BUDGET 1000
+#endif
+#ifndef BUS_DIAGNOSTIC_BUDGET
+#define BUS_DIAGNOSTIC_BUDGET 200
+#endif
+
+// in order of priority
+typedef enum {
+  BusControl,     // commands and writes, e.g. MQTT commands, time sync
+  BusTelemetry,   // polling of the register image
+  BusDiagnostic,  // manual register access, e.g. /postCommunicationModbus
+  BusClassCount
+} eBusClass_t;
+
+typedef std::function<void()> BusJob;
+
+// Single point of access to the modbus of one inverter. Work is either queued
+// and run later in order of priority, or admitted to run right away. Every
+// class has a budget of bus time per BUS_BUDGET_WINDOW ms. Work other than
+// control is only started if it is expected to finish before the next poll
+// is due, so diagnostics can not delay the telemetry.
+class BusArbiter {
+ public:
+  BusArbiter();
+  bool Submit(eBusClass_t busClass, BusJob job);
+  void Service(uint32_t deadline);
+  bool Acquire(eBusClass_t busClass, uint32_t deadline);
+  void Release(eBusClass_t busClass);
+  void Begin(eBusClass_t busClass);
+  void End(eBusClass_t busClass);
+  uint32_t GetJobs(eBusClass_t busClass);
+  uint32_t GetRejected(eBusClass_t busClass);
+  uint32_t GetBusTime(eBusClass_t busClass);
+  uint8_t GetQueued(eBusClass_t busClass);
+  static const char* GetClassName(eBusClass_t busClass);
+
+ private:
+  typedef struct {
+    BusJob jobs[BUS_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    uint32_t budget;    // bus time per window [ms]
+    uint32_t used;      // bus time used in the current window [ms]
+    uint32_t estimate;  // expected duration of a job [ms]
+    uint32_t executed;
+    uint32_t rejected;
+    uint32_t busTime;  // total bus time [ms]
+  } sBusClassState_t;
+
+  sBusClassState_t _Classes[BusClassCount];
+  uint32_t _WindowStart;
+  uint32_t _Start;
+
+  bool admit(eBusClass_t busClass, uint32_t deadline);
+  void rollWindow(uint32_t now);
+};
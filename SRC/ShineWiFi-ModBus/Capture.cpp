@@ -0,0 +1,534 @@
+#include "Capture.h"
+
+#if ENABLE_CAPTURE == 1
+#include <TLog.h>
+#include <algorithm>
+#include <math.h>
+
+// Layout of /capture.bin, all values little endian:
+//   header, one column per register, samples of
+//   { uint32_t millis, uint32_t raw value per register }
+typedef struct __attribute__((packed)) {
+  char magic[4];  // "GWCP"
+  uint8_t version;
+  uint8_t registerCount;
+  uint16_t sampleCount;
+  uint16_t triggerSample;  // index of the first sample at/after the trigger
+  uint16_t reserved;
+  uint32_t triggerTime;  // millis() of the trigger
+} sCaptureHeader_t;
+
+typedef struct __attribute__((packed)) {
+  uint16_t address;
+  uint8_t holding;
+  uint8_t size;  // RegisterSize_t
+  float multiplier;
+} sCaptureColumn_t;
+
+static const char* const captureStateNames[] = {"idle", "armed", "running",
+                                                "complete"};
+static const char* const captureRuleOperators[] = {"==", "!=", ">", "<", "~"};
+
+// Print sink that only counts the bytes, used to set the content length
+class CountingPrint : public Print {
+ public:
+  size_t write(uint8_t) override { return 1; }
+  size_t write(const uint8_t*, size_t size) override { return size; }
+};
+
+Capture::Capture(Growatt& inverter)
+    : inverter(inverter),
+      _State(CaptureIdle),
+      _ColumnCount(0),
+      _RegisterCount(0),
+      _RuleCount(0),
+      _InputFragments(0),
+      _HoldingFragments(0),
+      _Samples(NULL),
+      _Stride(0),
+      _PreCapacity(0),
+      _Head(0),
+      _Count(0),
+      _TriggerSample(0),
+      _TriggerTime(0),
+      _LastSample(0) {}
+
+void Capture::begin() {
+  /**
+   * @brief Resolve the configured registers and trigger rules against the
+   * protocol of the inverter and allocate the sample buffer. Has to be called
+   * after Growatt::InitProtocol(), calling it again after another protocol
+   * was selected drops the current capture.
+   */
+  free(_Samples);
+  _Samples = NULL;
+  _State = CaptureIdle;
+  _ColumnCount = 0;
+  _RegisterCount = 0;
+  _RuleCount = 0;
+  _InputFragments = 0;
+  _HoldingFragments = 0;
+  _Head = 0;
+  _Count = 0;
+
+  parseRegisters(F(CAPTURE_REGISTERS));
+  parseRules(F(CAPTURE_TRIGGERS));
+  if (_RegisterCount == 0) {
+    Log.println(F("Capture: no valid registers, disabled"));
+    return;
+  }
+
+  _Stride = 1 + _RegisterCount;
+  _Samples = (uint32_t*)malloc(CAPTURE_BUFFER_SAMPLES * _Stride *
+                               sizeof(uint32_t));
+  if (_Samples == NULL) {
+    Log.println(F("Capture: not enough memory, disabled"));
+    return;
+  }
+  _PreCapacity = std::min<uint32_t>(
+      CAPTURE_BUFFER_SAMPLES / 2,
+      CAPTURE_PRE_TRIGGER / std::max<uint32_t>(CAPTURE_ARMED_INTERVAL, 1) + 1);
+
+  inverter.RegisterCommand("capture/trigger",
+                           [this](const JsonDocument& req, JsonDocument& res,
+                                  Growatt&) {
+                             return handleTrigger(req, res);
+                           });
+  inverter.RegisterCommand("capture/arm", [this](const JsonDocument& req,
+                                                 JsonDocument& res, Growatt&) {
+    return handleArm(req, res);
+  });
+
+  Arm();
+}
+
+void Capture::addFragments(uint16_t index, bool holding) {
+  /**
+   * @brief Mark the fragment which contains the register to be polled
+   * @param index index of the register in the protocol table
+   * @param holding true if the register is a holding register
+   */
+  const sProtocolDefinition_t& protocol = inverter._Protocol;
+  uint8_t count =
+      holding ? protocol.HoldingFragmentCount : protocol.InputFragmentCount;
+  uint16_t address = inverter.GetRegister(holding, index).address;
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (fragmentContains(inverter.GetFragment(holding, i), address)) {
+      if (holding) {
+        _HoldingFragments |= 1 << i;
+      } else {
+        _InputFragments |= 1 << i;
+      }
+      return;
+    }
+  }
+}
+
+uint8_t Capture::addColumn(uint16_t index, bool holding) {
+  /**
+   * @brief Add a register to the ones read by the capture
+   * @param index index of the register in the protocol table
+   * @param holding true if the register is a holding register
+   * @returns column of the register
+   */
+  _Registers[_ColumnCount] = index;
+  _Holding[_ColumnCount] = holding;
+  _Values[_ColumnCount] = 0;
+  addFragments(index, holding);
+  return _ColumnCount++;
+}
+
+void Capture::parseRegisters(const String& list) {
+  /**
+   * @brief Parse the comma separated list of registers to capture
+   * @param list e.g. "InverterStatus,OutputPower"
+   */
+  int start = 0;
+  while (start < (int)list.length() &&
+         _RegisterCount < CAPTURE_MAX_REGISTERS) {
+    int end = list.indexOf(',', start);
+    if (end < 0) end = list.length();
+    String name = list.substring(start, end);
+    name.trim();
+    start = end + 1;
+
+    bool holding;
+    uint16_t reg;
+    if (!inverter.FindRegister(name, holding, reg)) {
+      Log.println("Capture: unknown register " + name);
+      continue;
+    }
+    addColumn(reg, holding);
+    _RegisterCount++;
+  }
+}
+
+void Capture::parseRules(const String& list) {
+  /**
+   * @brief Parse the semicolon separated trigger rules
+   * @param list e.g. "InverterStatus==3;OutputPower~500"
+   */
+  int start = 0;
+  while (start < (int)list.length() && _RuleCount < CAPTURE_MAX_RULES) {
+    int end = list.indexOf(';', start);
+    if (end < 0) end = list.length();
+    String rule = list.substring(start, end);
+    rule.trim();
+    start = end + 1;
+
+    // check the two character operators first
+    int pos = -1;
+    int len = 2;
+    eCaptureRuleType_t type = CaptureRuleEquals;
+    if ((pos = rule.indexOf(F("=="))) >= 0) {
+      type = CaptureRuleEquals;
+    } else if ((pos = rule.indexOf(F("!="))) >= 0) {
+      type = CaptureRuleNotEquals;
+    } else {
+      len = 1;
+      if ((pos = rule.indexOf('>')) >= 0) {
+        type = CaptureRuleAbove;
+      } else if ((pos = rule.indexOf('<')) >= 0) {
+        type = CaptureRuleBelow;
+      } else if ((pos = rule.indexOf('~')) >= 0) {
+        type = CaptureRuleStep;
+      }
+    }
+    if (pos <= 0) {
+      Log.println("Capture: invalid rule " + rule);
+      continue;
+    }
+
+    String name = rule.substring(0, pos);
+    name.trim();
+    bool holding;
+    uint16_t reg;
+    if (!inverter.FindRegister(name, holding, reg)) {
+      Log.println("Capture: unknown register " + name);
+      continue;
+    }
+    sCaptureRule_t& r = _Rules[_RuleCount++];
+    r.column = _ColumnCount;
+    for (uint8_t i = 0; i < _ColumnCount; i++) {
+      if (_Registers[i] == reg && _Holding[i] == holding) {
+        r.column = i;
+        break;
+      }
+    }
+    if (r.column == _ColumnCount) {
+      addColumn(reg, holding);
+    }
+    r.type = type;
+    r.threshold = rule.substring(pos + len).toDouble();
+    r.last = NAN;
+    r.active = false;
+  }
+}
+
+void Capture::Arm() {
+  /**
+   * @brief Drop the current capture and start filling the pre-trigger window
+   */
+  if (_Samples == NULL) return;
+  _Head = 0;
+  _Count = 0;
+  _TriggerSample = 0;
+  _TriggerTime = 0;
+  _Reason = "";
+  for (uint8_t i = 0; i < _RuleCount; i++) {
+    _Rules[i].last = NAN;
+    _Rules[i].active = false;
+  }
+  _State = CaptureArmed;
+  Log.println(F("Capture: armed"));
+}
+
+void Capture::Trigger(const String& reason) {
+  /**
+   * @brief Start a capture on demand. The pre-trigger window is kept if the
+   * capture was armed, a finished capture is replaced.
+   * @param reason reason reported along with the capture
+   */
+  if (_Samples == NULL) return;
+  if (_State != CaptureArmed) {
+    Arm();
+  }
+  _Reason = reason;
+  startCapture(millis());
+}
+
+void Capture::startCapture(uint32_t now) {
+  /**
+   * @brief Move the pre-trigger window to the start of the buffer and switch
+   * to full rate polling
+   * @param now time of the trigger
+   */
+  // bring the pre-trigger ring into chronological order
+  if (_Count == _PreCapacity) {
+    std::rotate(_Samples, _Samples + _Head * _Stride,
+                _Samples + _PreCapacity * _Stride);
+  }
+  // drop samples older than the pre-trigger window
+  uint16_t first = 0;
+  while (first < _Count &&
+         now - _Samples[first * _Stride] > CAPTURE_PRE_TRIGGER) {
+    first++;
+  }
+  memmove(_Samples, _Samples + first * _Stride,
+          (_Count - first) * _Stride * sizeof(uint32_t));
+  _Count -= first;
+
+  // a sample taken at the time of the trigger is part of the capture
+  _TriggerSample = _Count;
+  while (_TriggerSample > 0 &&
+         (int32_t)(_Samples[(_TriggerSample - 1) * _Stride] - now) >= 0) {
+    _TriggerSample--;
+  }
+  _TriggerTime = now;
+  _LastSample = now - CAPTURE_INTERVAL;
+  _State = CaptureRunning;
+
+  Log.print(F("Capture: triggered by "));
+  Log.println(_Reason);
+}
+
+bool Capture::readFragments() {
+  /**
+   * @brief Read the fragments of the capture registers into _Values. The
+   * polls are left alone, the capture neither publishes its values nor
+   * disturbs the learned cadence of the fragments.
+   * @returns true if all fragments were read
+   */
+  for (uint8_t i = 0; i < inverter._Protocol.InputFragmentCount; i++) {
+    if ((_InputFragments & (1 << i)) &&
+        !inverter.ReadFragmentValues(false, i, _Registers, _Holding,
+                                     _ColumnCount, _Values)) {
+      return false;
+    }
+  }
+  for (uint8_t i = 0; i < inverter._Protocol.HoldingFragmentCount; i++) {
+    if ((_HoldingFragments & (1 << i)) &&
+        !inverter.ReadFragmentValues(true, i, _Registers, _Holding,
+                                     _ColumnCount, _Values)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Capture::record(uint32_t now) {
+  uint16_t slot;
+  if (_State == CaptureArmed) {
+    slot = _Head;
+    _Head = (_Head + 1) % _PreCapacity;
+    if (_Count < _PreCapacity) _Count++;
+  } else {
+    slot = _Count++;
+  }
+
+  uint32_t* sample = &_Samples[slot * _Stride];
+  sample[0] = now;
+  for (uint8_t i = 0; i < _RegisterCount; i++) {
+    sample[i + 1] = _Values[i];
+  }
+}
+
+bool Capture::checkRules() {
+  /**
+   * @brief Evaluate the trigger rules on the values just read. A rule only
+   * fires when it starts to match, a persisting fault triggers once.
+   * @returns true if a rule fired, _Reason is set to the rule
+   */
+  bool fired = false;
+  for (uint8_t i = 0; i < _RuleCount; i++) {
+    sCaptureRule_t& rule = _Rules[i];
+    double value = getValue(rule.column, _Values[rule.column]);
+    bool match = false;
+    switch (rule.type) {
+      case CaptureRuleEquals:
+        match = value == rule.threshold;
+        break;
+      case CaptureRuleNotEquals:
+        match = value != rule.threshold;
+        break;
+      case CaptureRuleAbove:
+        match = value > rule.threshold;
+        break;
+      case CaptureRuleBelow:
+        match = value < rule.threshold;
+        break;
+      case CaptureRuleStep:
+        match = !isnan(rule.last) && fabs(value - rule.last) > rule.threshold;
+        break;
+    }
+    // the first sample after arming only initializes the rule
+    if (match && !rule.active && !isnan(rule.last) && !fired) {
+      fired = true;
+      _Reason = String(getRegister(rule.column).name) +
+                captureRuleOperators[rule.type] +
+                String(rule.threshold);
+    }
+    rule.active = match;
+    rule.last = value;
+  }
+  return fired;
+}
+
+void Capture::loop(uint32_t now) {
+  /**
+   * @brief Poll the capture registers. While armed this happens every
+   * CAPTURE_ARMED_INTERVAL ms, after a trigger every CAPTURE_INTERVAL ms
+   * until CAPTURE_DURATION ms passed or the buffer is full.
+   * @param now current millis()
+   */
+  if (_State != CaptureArmed && _State != CaptureRunning) return;
+
+  uint32_t interval =
+      _State == CaptureRunning ? CAPTURE_INTERVAL : CAPTURE_ARMED_INTERVAL;
+  if (now - _LastSample < interval) return;
+  // the capture must neither delay a poll nor queued commands
+  if (!inverter.AcquireBus(BusTelemetry)) return;
+  _LastSample = now;
+
+  bool ok = readFragments();
+  inverter.ReleaseBus(BusTelemetry);
+  if (!ok) return;
+  uint32_t sampleTime = millis();
+  record(sampleTime);
+
+  if (_State == CaptureArmed) {
+    if (checkRules()) {
+      startCapture(sampleTime);
+    }
+  } else if (sampleTime - _TriggerTime >= CAPTURE_DURATION ||
+             _Count >= CAPTURE_BUFFER_SAMPLES) {
+    _State = CaptureComplete;
+    Log.print(F("Capture: complete, samples: "));
+    Log.println(_Count);
+  }
+}
+
+eCaptureState_t Capture::GetState() { return _State; }
+
+sGrowattModbusReg_t Capture::getRegister(uint8_t column) {
+  return inverter.GetRegister(_Holding[column], _Registers[column]);
+}
+
+double Capture::getValue(uint8_t reg, uint32_t raw) {
+  sGrowattModbusReg_t copy = getRegister(reg);
+  copy.value = raw;
+  return inverter.GetRegValue(&copy);
+}
+
+size_t Capture::WriteCsv(Print& out) {
+  /**
+   * @brief Write the capture as CSV, the time is relative to the trigger
+   * @param out destination
+   * @returns number of bytes written
+   */
+  size_t n = out.print(F("time_ms"));
+  for (uint8_t i = 0; i < _RegisterCount; i++) {
+    n += out.print(',');
+    n += out.print(getRegister(i).name);
+  }
+  n += out.print('\n');
+
+  if (_State != CaptureRunning && _State != CaptureComplete) return n;
+
+  for (uint16_t s = 0; s < _Count; s++) {
+    const uint32_t* sample = &_Samples[s * _Stride];
+    n += out.print((int32_t)(sample[0] - _TriggerTime));
+    for (uint8_t i = 0; i < _RegisterCount; i++) {
+      uint8_t digits = 0;
+      for (float r = getRegister(i).resolution; r < 0.99 && digits < 4;
+           r *= 10) {
+        digits++;
+      }
+      n += out.print(',');
+      n += out.print(getValue(i, sample[i + 1]), digits);
+    }
+    n += out.print('\n');
+  }
+  return n;
+}
+
+size_t Capture::GetCsvSize() {
+  CountingPrint counter;
+  return WriteCsv(counter);
+}
+
+size_t Capture::WriteBinary(Print& out) {
+  /**
+   * @brief Write the capture in the compact binary format, raw register
+   * values are scaled with the multiplier of their column
+   * @param out destination
+   * @returns number of bytes written
+   */
+  bool valid = _State == CaptureRunning || _State == CaptureComplete;
+  sCaptureHeader_t header = {{'G', 'W', 'C', 'P'},
+                             1,
+                             _RegisterCount,
+                             valid ? _Count : (uint16_t)0,
+                             _TriggerSample,
+                             0,
+                             _TriggerTime};
+  size_t n = out.write((const uint8_t*)&header, sizeof(header));
+
+  for (uint8_t i = 0; i < _RegisterCount; i++) {
+    sGrowattModbusReg_t reg = getRegister(i);
+    sCaptureColumn_t column = {reg.address, _Holding[i], (uint8_t)reg.size,
+                               reg.multiplier};
+    n += out.write((const uint8_t*)&column, sizeof(column));
+  }
+  n += out.write((const uint8_t*)_Samples,
+                 header.sampleCount * _Stride * sizeof(uint32_t));
+  return n;
+}
+
+size_t Capture::GetBinarySize() {
+  bool valid = _State == CaptureRunning || _State == CaptureComplete;
+  return sizeof(sCaptureHeader_t) +
+         _RegisterCount * sizeof(sCaptureColumn_t) +
+         (valid ? _Count * _Stride * sizeof(uint32_t) : 0);
+}
+
+void Capture::CreateJson(JsonDocument& doc) {
+  doc["State"] = captureStateNames[_State];
+  doc["Reason"] = _Reason;
+  doc["Samples"] = _Count;
+  doc["Capacity"] = CAPTURE_BUFFER_SAMPLES;
+  doc["TriggerSample"] = _TriggerSample;
+  JsonArray registers = doc.createNestedArray("Registers");
+  for (uint8_t i = 0; i < _RegisterCount; i++) {
+    registers.add(getRegister(i).name);
+  }
+  JsonArray rules = doc.createNestedArray("Rules");
+  for (uint8_t i = 0; i < _RuleCount; i++) {
+    const sCaptureRule_t& rule = _Rules[i];
+    rules.add(String(getRegister(rule.column).name) +
+              captureRuleOperators[rule.type] + String(rule.threshold));
+  }
+}
+
+std::tuple<bool, String> Capture::handleTrigger(const JsonDocument& req,
+                                                JsonDocument& res) {
+  if (_Samples == NULL) {
+    return std::make_tuple(false, "capture is disabled");
+  }
+  Trigger(req.containsKey("reason") ? req["reason"].as<String>()
+                                    : String(F("mqtt")));
+  CreateJson(res);
+  return std::make_tuple(true, "");
+}
+
+std::tuple<bool, String> Capture::handleArm(const JsonDocument&,
+                                            JsonDocument& res) {
+  if (_Samples == NULL) {
+    return std::make_tuple(false, "capture is disabled");
+  }
+  Arm();
+  CreateJson(res);
+  return std::make_tuple(true, "");
+}
+#endif
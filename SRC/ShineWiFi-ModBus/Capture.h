@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Config.h"
+
+#if ENABLE_CAPTURE == 1
+#include <Arduino.h>
+#include "Growatt.h"
+
+#ifndef CAPTURE_REGISTERS
+#define CAPTURE_REGISTERS "InverterStatus,OutputPower"
+#endif
+#ifndef CAPTURE_TRIGGERS
+#define CAPTURE_TRIGGERS "InverterStatus==3"
+#endif
+#ifndef CAPTURE_INTERVAL
+#define CAPTURE_INTERVAL 0
+#endif
+#ifndef CAPTURE_ARMED_INTERVAL
+#define CAPTURE_ARMED_INTERVAL 1000
+#endif
+#ifndef CAPTURE_PRE_TRIGGER
+#define CAPTURE_PRE_TRIGGER 10000
+#endif
+#ifndef CAPTURE_DURATION
+#define CAPTURE_DURATION 30000
+#endif
+#ifndef CAPTURE_BUFFER_SAMPLES
+#define CAPTURE_BUFFER_SAMPLES 256
+#endif
+
+#define CAPTURE_MAX_REGISTERS 8
+#define CAPTURE_MAX_RULES 4
+#define CAPTURE_MAX_COLUMNS (CAPTURE_MAX_REGISTERS + CAPTURE_MAX_RULES)
+
+typedef enum {
+  CaptureIdle,      // no valid registers or out of memory
+  CaptureArmed,     // filling the pre-trigger window, checking the rules
+  CaptureRunning,   // polling at full rate after a trigger
+  CaptureComplete   // capture is kept until it is armed again
+} eCaptureState_t;
+
+typedef enum {
+  CaptureRuleEquals,     // Name==Value
+  CaptureRuleNotEquals,  // Name!=Value
+  CaptureRuleAbove,      // Name>Value
+  CaptureRuleBelow,      // Name<Value
+  CaptureRuleStep        // Name~Value, change between two samples > Value
+} eCaptureRuleType_t;
+
+typedef struct {
+  uint8_t column;  // register read by the capture
+  eCaptureRuleType_t type;
+  double threshold;
+  double last;  // value of the previous sample
+  bool active;  // the rule matched the previous sample
+} sCaptureRule_t;
+
+class Capture {
+ public:
+  Capture(Growatt& inverter);
+  void begin();
+  void loop(uint32_t now);
+  void Arm();
+  void Trigger(const String& reason);
+  eCaptureState_t GetState();
+  size_t WriteCsv(Print& out);
+  size_t WriteBinary(Print& out);
+  size_t GetCsvSize();
+  size_t GetBinarySize();
+  void CreateJson(JsonDocument& doc);
+
+ private:
+  Growatt& inverter;
+  eCaptureState_t _State;
+  String _Reason;
+  // registers read by the capture, the captured ones first followed by the
+  // ones only the rules use
+  uint16_t _Registers[CAPTURE_MAX_COLUMNS];  // index in the protocol table
+  bool _Holding[CAPTURE_MAX_COLUMNS];
+  uint32_t _Values[CAPTURE_MAX_COLUMNS];  // raw values of the last sample
+  uint8_t _ColumnCount;
+  uint8_t _RegisterCount;  // captured registers
+  sCaptureRule_t _Rules[CAPTURE_MAX_RULES];
+  uint8_t _RuleCount;
+  uint16_t _InputFragments;    // bitmask of the input fragments to poll
+  uint16_t _HoldingFragments;  // bitmask of the holding fragments to poll
+  uint32_t* _Samples;          // timestamp followed by the raw values
+  uint16_t _Stride;            // words per sample
+  uint16_t _PreCapacity;       // samples of the pre-trigger ring
+  uint16_t _Head;              // next slot of the pre-trigger ring
+  uint16_t _Count;
+  uint16_t _TriggerSample;  // first sample after the trigger
+  uint32_t _TriggerTime;
+  uint32_t _LastSample;
+
+  void addFragments(uint16_t index, bool holding);
+  uint8_t addColumn(uint16_t index, bool holding);
+  sGrowattModbusReg_t getRegister(uint8_t column);
+  void parseRegisters(const String& list);
+  void parseRules(const String& list);
+  bool readFragments();
+  void record(uint32_t now);
+  bool checkRules();
+  void startCapture(uint32_t now);
+  double getValue(uint8_t reg, uint32_t raw);
+  std::tuple<bool, String> handleTrigger(const JsonDocument& req,
+                                         JsonDocument& res);
+  std::tuple<bool, String> handleArm(const JsonDocument& req,
+                                     JsonDocument& res);
+};
+#endif
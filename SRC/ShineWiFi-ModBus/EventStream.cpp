@@ -0,0 +1,211 @@
+#include "EventStream.h"
+#include "ResponseCache.h"
+
+#include <new>
+
+#ifdef ESP32
+#include <lwip/sockets.h>
+#endif
+
+static const char KEEPALIVE[] = ":\n\n";
+
+EventStream::EventStream(Growatt* inverters, uint8_t count)
+    : _Inverters(inverters), _Count(count) {
+  for (uint8_t i = 0; i < EVENT_STREAM_CLIENTS; i++) {
+    _Clients[i].active = false;
+  }
+  for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+    _Generations[i] = 0;
+    _Versions[i] = 0;
+    _Synced[i] = false;
+  }
+}
+
+bool EventStream::Add(WiFiClient& client, uint8_t inverter) {
+  /**
+   * @brief Answer a request with an event stream and send the snapshot
+   * @param client connection of the request, it is kept open
+   * @param inverter index of the inverter whose values are pushed
+   * @returns false if EVENT_STREAM_CLIENTS clients are connected already
+   */
+  uint8_t slot = 0;
+  while (slot < EVENT_STREAM_CLIENTS && _Clients[slot].active) slot++;
+  if (slot == EVENT_STREAM_CLIENTS) return false;
+
+  client.setNoDelay(true);
+  client.print(
+      F("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\nConnection: keep-alive\r\n\r\n"));
+  sEventClient_t& c = _Clients[slot];
+  c.client = client;
+  c.inverter = inverter;
+  c.active = true;
+  c.lastWrite = millis();
+  c.frame.reset();
+  c.size = c.sent = 0;
+
+  Growatt& source = _Inverters[inverter];
+  size_t size;
+  std::shared_ptr<const char> snapshot;
+  uint32_t generation;
+  {
+    SnapshotLock lock(&source);
+    generation = source.GetGeneration();
+    snapshot = createFrame(
+        "snapshot", [&](Print& out) { source.WriteUIValues(out); }, size);
+  }
+  // values newer than the ones the next update is compared to would not be
+  // updated, the client gets a snapshot then
+  c.needsSnapshot = !sendFrame(c, snapshot, size) ||
+                    !_Synced[inverter] || generation != _Generations[inverter];
+  return true;
+}
+
+void EventStream::loop() {
+  /**
+   * @brief Publish the values of new polls, continue the frames being sent,
+   * drop closed or stuck connections and keep idle ones alive
+   */
+  const uint32_t now = millis();
+  for (uint8_t i = 0; i < EVENT_STREAM_CLIENTS; i++) {
+    sEventClient_t& c = _Clients[i];
+    if (!c.active) continue;
+    if (c.sent < c.size) flush(c);
+    if (!c.client.connected() ||
+        (c.sent < c.size && now - c.lastWrite >= EVENT_STREAM_KEEPALIVE)) {
+      c.client.stop();
+      c.frame.reset();
+      c.active = false;
+    } else if (now - c.lastWrite >= EVENT_STREAM_KEEPALIVE) {
+      // not freed, the frame is static
+      sendFrame(c, std::shared_ptr<const char>(KEEPALIVE, [](const char*) {}),
+                strlen(KEEPALIVE));
+    }
+  }
+  for (uint8_t i = 0; i < _Count; i++) {
+    if (_Inverters[i].GetGeneration() != _Generations[i]) publish(i);
+  }
+}
+
+uint8_t EventStream::GetClientCount() {
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < EVENT_STREAM_CLIENTS; i++) {
+    if (_Clients[i].active) count++;
+  }
+  return count;
+}
+
+void EventStream::publish(uint8_t inverter) {
+  /**
+   * @brief Send the values that changed with a poll. Without clients the
+   * update is skipped and the clients of the next one get a snapshot.
+   * @param inverter index of the inverter that was polled
+   */
+  Growatt& source = _Inverters[inverter];
+  bool clients = false;
+  for (uint8_t i = 0; i < EVENT_STREAM_CLIENTS; i++) {
+    clients |= _Clients[i].active && _Clients[i].inverter == inverter;
+  }
+  if (!clients) {
+    _Generations[inverter] = source.GetGeneration();
+    _Synced[inverter] = false;
+    return;
+  }
+
+  // both frames show the values the next update is compared to
+  size_t updateSize = 0;
+  size_t snapshotSize;
+  std::shared_ptr<const char> update;
+  std::shared_ptr<const char> snapshot;
+  {
+    SnapshotLock lock(&source);
+    _Generations[inverter] = source.GetGeneration();
+    // the fields change with the protocol
+    if (_Versions[inverter] != source.GetProtocolVersion()) {
+      _Versions[inverter] = source.GetProtocolVersion();
+      _Synced[inverter] = false;
+    }
+    if (_Synced[inverter]) {
+      update = createFrame(
+          "update", [&](Print& out) { source.WriteUIChanges(out); },
+          updateSize);
+    }
+    snapshot = createFrame(
+        "snapshot", [&](Print& out) { source.WriteUIValues(out); },
+        snapshotSize);
+    source.MarkUIValuesSent();
+  }
+
+  for (uint8_t i = 0; i < EVENT_STREAM_CLIENTS; i++) {
+    sEventClient_t& c = _Clients[i];
+    if (!c.active || c.inverter != inverter) continue;
+    if (_Synced[inverter] && !c.needsSnapshot) {
+      c.needsSnapshot = !sendFrame(c, update, updateSize);
+    } else {
+      c.needsSnapshot = !sendFrame(c, snapshot, snapshotSize);
+    }
+  }
+  _Synced[inverter] = true;
+}
+
+std::shared_ptr<const char> EventStream::createFrame(
+    const char* event, std::function<void(Print&)> write, size_t& size) {
+  /**
+   * @brief Format an event, write() produces the data
+   * @param size set to the length of the frame
+   * @returns the frame, empty if there is no memory for it
+   */
+  LengthPrint length;
+  write(length);
+  size = strlen("event: \ndata: \n\n") + strlen(event) + length.GetLength();
+  char* frame = new (std::nothrow) char[size];
+  if (frame == NULL) return std::shared_ptr<const char>();
+  BufferPrint out(frame, size);
+  out.print(F("event: "));
+  out.print(event);
+  out.print(F("\ndata: "));
+  write(out);
+  out.print(F("\n\n"));
+  return std::shared_ptr<const char>(frame, std::default_delete<char[]>());
+}
+
+bool EventStream::sendFrame(sEventClient_t& c,
+                            std::shared_ptr<const char> frame, size_t size) {
+  /**
+   * @brief Start sending a frame, loop() sends what the connection does not
+   * take at once
+   * @returns false if the frame was skipped, the client did not take the
+   * previous one yet
+   */
+  if (!frame || c.sent < c.size) return false;
+  c.frame = frame;
+  c.size = size;
+  c.sent = 0;
+  flush(c);
+  return true;
+}
+
+void EventStream::flush(sEventClient_t& c) {
+  /**
+   * @brief Write as much of the current frame as the connection takes
+   * without waiting. A connection that fails is closed, the browser
+   * reconnects.
+   */
+  const uint8_t* data = (const uint8_t*)c.frame.get() + c.sent;
+  size_t remaining = c.size - c.sent;
+#ifdef ESP32
+  // WiFiClient::write() waits until everything is sent
+  ssize_t written = send(c.client.fd(), data, remaining, MSG_DONTWAIT);
+  if (written < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) c.client.stop();
+    written = 0;
+  }
+#else
+  // write() only waits if there is no room for the data
+  size_t written = min(remaining, (size_t)c.client.availableForWrite());
+  if (written > 0) written = c.client.write(data, written);
+#endif
+  if (written > 0) c.lastWrite = millis();
+  c.sent += written;
+  if (c.sent == c.size) c.frame.reset();
+}
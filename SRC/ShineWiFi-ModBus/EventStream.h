@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Arduino.h"
+#include "Config.h"
+#include "Growatt.h"
+#include <WiFiClient.h>
+#include <functional>
+#include <memory>
+
+#ifndef EVENT_STREAM_CLIENTS
+#define EVENT_STREAM_CLIENTS 4
+#endif
+// a comment line is sent to idle clients, connections that died are noticed.
+// A client that does not take any data for this long is dropped.
+#ifndef EVENT_STREAM_KEEPALIVE
+#define EVENT_STREAM_KEEPALIVE 15000
+#endif
+
+// Pushes the values of the web UI to the browsers as server-sent events
+// (/events). A client gets all values when it connects ("snapshot", like
+// /ui/values), then one "update" with the [field, value] pairs that changed
+// after every poll. The frames are written without blocking, as much as
+// the connection takes in every loop(). A client that did not take the
+// previous frame yet skips an update and gets a snapshot instead at the next
+// poll. All methods have to be called from the task that serves the web
+// server.
+class EventStream {
+ public:
+  EventStream(Growatt* inverters, uint8_t count);
+  bool Add(WiFiClient& client, uint8_t inverter);
+  void loop();
+  uint8_t GetClientCount();
+
+ private:
+  typedef struct {
+    WiFiClient client;
+    uint8_t inverter;
+    bool active;
+    bool needsSnapshot;                 // missed an update
+    uint32_t lastWrite;                 // millis() of the last progress
+    std::shared_ptr<const char> frame;  // being sent, shared by the clients
+    size_t size;
+    size_t sent;
+  } sEventClient_t;
+
+  Growatt* _Inverters;
+  uint8_t _Count;
+  sEventClient_t _Clients[EVENT_STREAM_CLIENTS];
+  uint32_t _Generations[NUM_INVERTERS];  // the values were marked sent at
+  uint16_t _Versions[NUM_INVERTERS];     // protocol of the fields
+  bool _Synced[NUM_INVERTERS];           // the last update was sent
+
+  void publish(uint8_t inverter);
+  std::shared_ptr<const char> createFrame(const char* event,
+                                         std::function<void(Print&)> write,
+                                         size_t& size);
+  bool sendFrame(sEventClient_t& client, std::shared_ptr<const char> frame,
+                 size_t size);
+  void flush(sEventClient_t& client);
+};
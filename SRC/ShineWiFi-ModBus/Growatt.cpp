@@ -1,6 +1,7 @@
 #include <ModbusMaster.h>
 #include <ArduinoJson.h>
 #include <TLog.h>
+#include <sys/time.h>
 
 #include "GrowattTypes.h"
 #include "Growatt.h"
@@ -9,30 +10,54 @@
 #error Please rename Config.h.example to Config.h
 #endif
 
-#if GROWATT_MODBUS_VERSION == 120
 #include "Growatt120.h"
-#elif GROWATT_MODBUS_VERSION == 124
 #include "Growatt124.h"
-#elif GROWATT_MODBUS_VERSION == 305
 #include "Growatt305.h"
-#elif GROWATT_MODBUS_VERSION == 307
 #include "Growatt307.h"
-#elif GROWATT_MODBUS_VERSION == 3000
 #include "GrowattTLXH.h"
-#elif GROWATT_MODBUS_VERSION == 5000
 #include "GrowattSPF.h"
-#elif GROWATT_MODBUS_VERSION == 6000
 #include "GrowattBP.h"
-#else
-#error "Unsupported Growatt Modbus version"
-#endif
 
-ModbusMaster Modbus;
 
 // Constructor
-Growatt::Growatt() {
+Growatt::Growatt()
+    : _Scheduler(REFRESH_TIMER, POLL_ALIGN_TO_WALLCLOCK == 1) {
   _eDevice = Undef_stick;
+  _InverterId = 1;
   _PacketCnt = 0;
+  _Generation = 0;
+  _CycleStart = 0;
+  _PublishTime = 0;
+  _ProtocolVersion = 0;
+  _NameIndex = NULL;
+  _NameIndexSize = 0;
+  _Names = NULL;
+  _NamePool = NULL;
+  _JsonDocument = NULL;
+  _RegisterFragments = NULL;
+  _RegisterGroups = NULL;
+  _PollInputValues = NULL;
+  _PollHoldingValues = NULL;
+  _UIValues = NULL;
+  _UIValid = NULL;
+  _MetricNames = NULL;
+  _MetricNamePool = NULL;
+  _DuplicateNames = false;
+  memset(&_Protocol, 0, sizeof(_Protocol));
+  memset(_InputCadence, 0, sizeof(_InputCadence));
+  memset(_HoldingCadence, 0, sizeof(_HoldingCadence));
+  memset(_SnapshotInputCadence, 0, sizeof(_SnapshotInputCadence));
+  memset(_SnapshotHoldingCadence, 0, sizeof(_SnapshotHoldingCadence));
+#ifdef ESP32
+  _SnapshotMutex = xSemaphoreCreateMutex();
+#endif
+  memset(_SerializeMicros, 0, sizeof(_SerializeMicros));
+  memset(_GzipInput, 0, sizeof(_GzipInput));
+  memset(_GzipOutput, 0, sizeof(_GzipOutput));
+  memset(_GzipMicros, 0, sizeof(_GzipMicros));
+  memset(_JsonCapacity, 0, sizeof(_JsonCapacity));
+  memset(_JsonLastCapacity, 0, sizeof(_JsonLastCapacity));
+  memset(_JsonLastUsage, 0, sizeof(_JsonLastUsage));
 
   handlers = std::map<String, CommandHandlerFunc>();
 
@@ -56,54 +81,678 @@ Growatt::Growatt() {
                                        JsonDocument& res, Growatt& inverter) {
     return handleModbusSet(req, res, *this);
   });
+
+  RegisterCommand("value/get", [this](const JsonDocument& req,
+                                      JsonDocument& res, Growatt&) {
+    return handleValueGet(req, res, *this);
+  });
 }
 
-void Growatt::InitProtocol() {
-/**
- * @brief Initialize the protocol struct
- * @param version The version of the modbus protocol to use
- */
-#if GROWATT_MODBUS_VERSION == 120
-  init_growatt120(_Protocol, *this);
-#elif GROWATT_MODBUS_VERSION == 124
-  init_growatt124(_Protocol, *this);
-#elif GROWATT_MODBUS_VERSION == 305
-  init_growatt305(_Protocol, *this);
-#elif GROWATT_MODBUS_VERSION == 307
-  init_growatt307(_Protocol, *this);
-#elif GROWATT_MODBUS_VERSION == 3000
-  init_growattTLXH(_Protocol, *this);
-#elif GROWATT_MODBUS_VERSION == 5000
-  init_growattSPF(_Protocol, *this);
-#elif GROWATT_MODBUS_VERSION == 6000
-  init_growattBP(_Protocol, *this);
+bool Growatt::InitProtocol(uint16_t version) {
+  /**
+   * @brief Initialize the protocol struct. All protocol tables are part of
+   * the image, selecting one only allocates the RAM for its values. A
+   * register map file on LittleFS replaces the tables of the protocol.
+   * @param version The version of the modbus protocol to use
+   * @returns false if the version is not supported
+   */
+  // the tables change under the outputs
+  SnapshotLock lock(this);
+  // the tables are set up in a copy, the current protocol stays as it is
+  // until the new one is known to be supported
+  sProtocolDefinition_t protocol = _Protocol;
+  bool supported = true;
+  // protocols without group tables have no groups
+  protocol.InputGroupCount = 0;
+  protocol.HoldingGroupCount = 0;
+  switch (version) {
+    case 120:
+      init_growatt120(protocol, *this);
+      break;
+    case 124:
+      init_growatt124(protocol, *this);
+      break;
+    case 305:
+      init_growatt305(protocol, *this);
+      break;
+    case 307:
+      init_growatt307(protocol, *this);
+      break;
+    case 3000:
+      init_growattTLXH(protocol, *this);
+      break;
+    case 5000:
+      init_growattSPF(protocol, *this);
+      break;
+    case 6000:
+      init_growattBP(protocol, *this);
+      break;
+    default:
+      supported = false;
+  }
+  bool namesInRam = false;
+#if ENABLE_REGISTER_MAP_FILE == 1
+  // a map file can also add a protocol without built-in tables
+  if (_RegisterMap.Load(RegisterMap::GetPath(version), version, protocol)) {
+    Log.print(F("Loaded register map for protocol "));
+    Log.println(version);
+    supported = true;
+    namesInRam = true;
+  }
+#endif
+  if (!supported) return false;
+  _Protocol = protocol;
+  _ProtocolVersion = version;
+
+  // only the values live in RAM, sized exactly for the protocol
+  delete[] _Protocol.InputValues;
+  delete[] _Protocol.HoldingValues;
+  _Protocol.InputValues = new uint32_t[_Protocol.InputRegisterCount]();
+  _Protocol.HoldingValues = new uint32_t[_Protocol.HoldingRegisterCount]();
+  delete[] _PollInputValues;
+  delete[] _PollHoldingValues;
+  _PollInputValues = new uint32_t[_Protocol.InputRegisterCount]();
+  _PollHoldingValues = new uint32_t[_Protocol.HoldingRegisterCount]();
+  delete[] _UIValues;
+  _UIValues = NULL;
+  delete[] _UIValid;
+  _UIValid = NULL;
+  memset(_InputCadence, 0, sizeof(_InputCadence));
+  memset(_HoldingCadence, 0, sizeof(_HoldingCadence));
+  memset(_SnapshotInputCadence, 0, sizeof(_SnapshotInputCadence));
+  memset(_SnapshotHoldingCadence, 0, sizeof(_SnapshotHoldingCadence));
+  _GotData = false;
+  _Generation++;
+  buildNameIndex();
+  mapRegisterFragments();
+  mapRegisterGroups();
+  internNames(namesInRam);
+  buildMetricNames();
+  planJsonCapacity();
+  return true;
+}
+
+static uint32_t nameHash(const char* name) {
+  // case-insensitive FNV-1a, the name may be in flash
+  uint32_t hash = 2166136261u;
+  for (char c; (c = pgm_read_byte(name)) != 0; name++) {
+    hash = (hash ^ (uint8_t)tolower(c)) * 16777619u;
+  }
+  return hash;
+}
+
+void Growatt::buildNameIndex() {
+  /**
+   * @brief Build the open addressing hash table that maps register names to
+   * their slot in the protocol tables, see FindRegister()
+   */
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  // at most half full, so a probe ends at an empty entry quickly
+  uint16_t size = 1;
+  while (size < 2 * count) size <<= 1;
+  if (size != _NameIndexSize) {
+    delete[] _NameIndex;
+    _NameIndex = new uint16_t[size];
+    _NameIndexSize = size;
+  }
+  memset(_NameIndex, 0, size * sizeof(uint16_t));
+
+  // input registers first, a duplicate name resolves to the first register
+  // of its probe sequence like in the previous linear search
+  for (uint16_t slot = 0; slot < count; slot++) {
+    const bool holding = slot >= _Protocol.InputRegisterCount;
+    const uint16_t index =
+        holding ? slot - _Protocol.InputRegisterCount : slot;
+    const sGrowattRegisterDef_t def = readRegisterDef(
+        holding ? _Protocol.HoldingRegisters : _Protocol.InputRegisters,
+        index);
+    uint16_t i = nameHash(def.name) & (size - 1);
+    while (_NameIndex[i] != 0) i = (i + 1) & (size - 1);
+    _NameIndex[i] = slot + 1;  // 0 marks an empty entry
+  }
+}
+
+void Growatt::internNames(bool namesInRam) {
+  /**
+   * @brief Collect the register names used as JSON keys. ArduinoJson stores
+   * a `const char*` key as pointer but copies a flash string into every
+   * document, so the keys have to be readable as plain RAM/ROM strings. They
+   * stay valid until the next InitProtocol().
+   * @param namesInRam the names of the tables are already in RAM, e.g. from
+   * a register map file
+   */
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  delete[] _Names;
+  delete[] _NamePool;
+  _Names = new const char*[count];
+  _NamePool = NULL;
+
+  for (uint16_t slot = 0; slot < count; slot++) {
+    const bool holding = slot >= _Protocol.InputRegisterCount;
+    const uint16_t index =
+        holding ? slot - _Protocol.InputRegisterCount : slot;
+    const sGrowattRegisterDef_t def = readRegisterDef(
+        holding ? _Protocol.HoldingRegisters : _Protocol.InputRegisters,
+        index);
+    _Names[slot] = def.name;
+  }
+#ifdef ESP8266
+  // the flash of the ESP8266 only allows aligned 32 bit reads, copy the
+  // names into one pool
+  if (namesInRam) return;
+  size_t size = 0;
+  for (uint16_t slot = 0; slot < count; slot++) {
+    size += strlen_P(_Names[slot]) + 1;
+  }
+  _NamePool = new char[size];
+  char* name = _NamePool;
+  for (uint16_t slot = 0; slot < count; slot++) {
+    strcpy_P(name, _Names[slot]);
+    _Names[slot] = name;
+    name += strlen(name) + 1;
+  }
+#else
+  (void)namesInRam;  // flash is memory mapped
+#endif
+}
+
+void Growatt::buildMetricNames() {
+  /**
+   * @brief Convert the register names to metric names once, a scrape only
+   * appends them. Registers sharing a name share the string, only the first
+   * one is marked to get the # TYPE line.
+   */
+  _DuplicateNames = false;
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  delete[] _MetricNames;
+  delete[] _MetricNamePool;
+  _MetricNames = new uint16_t[count];
+
+  size_t size = 0;
+  for (uint16_t slot = 0; slot < count; slot++) {
+    // at most one '_' per character
+    size += 2 * strlen(_Names[slot]) + 1;
+  }
+  _MetricNamePool = new char[size];
+
+  size_t used = 0;
+  for (uint16_t slot = 0; slot < count; slot++) {
+    bool holding;
+    uint16_t index;
+    FindRegister(_Names[slot], holding, index);
+    const uint16_t first =
+        holding ? _Protocol.InputRegisterCount + index : index;
+    if (first != slot) {
+      _DuplicateNames = true;
+      _MetricNames[slot] = _MetricNames[first] & ~METRIC_NAME_FIRST;
+      continue;
+    }
+    camelCaseToSnakeCase(_Names[slot], _MetricNamePool + used);
+    _MetricNames[slot] = used | METRIC_NAME_FIRST;
+    used += strlen(_MetricNamePool + used) + 1;
+  }
+}
+
+const char* Growatt::registerName(bool holding, uint16_t index) {
+  return _Names[holding ? _Protocol.InputRegisterCount + index : index];
+}
+
+size_t Growatt::valueTextSize(bool holding, uint16_t index) {
+  /**
+   * @brief Longest text setScaledValue() copies into a document for a
+   * register, found by formatting the extreme raw values of its size
+   * @returns bytes including the terminator, 0 if stored as plain number
+   */
+  sGrowattModbusReg_t reg = GetRegister(holding, index);
+  uint8_t shift = 16;
+  if (is32Bit(reg.size)) {
+    shift = 0;
+  } else if (reg.size == SIZE_8BIT_L || reg.size == SIZE_8BIT_H) {
+    shift = 24;
+  }
+  const uint32_t extremes[] = {0x7FFFFFFF, 0x80000000, 0xFFFFFFFF};
+  size_t size = 0;
+  for (uint32_t raw : extremes) {
+    reg.value = raw >> shift;
+    const int64_t scaled = GetRegScaled(&reg);
+    if (reg.decimals == 0 && scaled >= INT32_MIN && scaled <= INT32_MAX) {
+      continue;
+    }
+    char buffer[SCALED_TEXT_SIZE];
+    size = max(size, FormatScaled(buffer, scaled, reg.decimals) + 1);
+  }
+  return size;
+}
+
+void Growatt::planJsonCapacity() {
+  /**
+   * @brief Compute the worst case capacity of the JSON documents for the
+   * protocol and allocate the document of the UI output. Keys are interned
+   * and not copied, see internNames().
+   */
+  uint16_t uiMembers = 0;
+  size_t uiTexts = 0;
+  size_t longestName = 0;
+  for (uint8_t holding = 0; holding < 2; holding++) {
+    const uint16_t count = holding ? _Protocol.HoldingRegisterCount
+                                   : _Protocol.InputRegisterCount;
+    for (uint16_t i = 0; i < count; i++) {
+      const sGrowattRegisterDef_t def = readRegisterDef(
+          holding ? _Protocol.HoldingRegisters : _Protocol.InputRegisters, i);
+      if (def.frontend || def.plot) {
+        uiMembers++;
+        uiTexts += valueTextSize(holding, i);
+        if (def.labels != NULL) uiTexts += GROWATT_LABEL_SIZE + 2;
+      }
+      longestName = max(longestName, strlen(registerName(holding, i)));
+    }
+  }
+#if SIMULATE_INVERTER == 1
+  // the simulated output holds literals only
+  uiMembers = 12;
+  uiTexts = 0;
+#endif
+  _JsonCapacity[JsonUI] = JSON_OBJECT_SIZE(uiMembers + 1) +
+                          (uiMembers + 1) * JSON_ARRAY_SIZE(3) + uiTexts +
+                          JSON_HOSTNAME_SIZE;
+
+  // command, success, message, correlationId and the largest handler result
+  size_t commandList = JSON_OBJECT_SIZE(1) + JSON_ARRAY_SIZE(handlers.size());
+  for (auto it = handlers.begin(); it != handlers.end(); ++it) {
+    commandList += it->first.length() + 1;
+  }
+  const size_t valueGet =
+      JSON_OBJECT_SIZE(2) + longestName + 1 + SCALED_TEXT_SIZE;
+  _JsonCapacity[JsonCommand] =
+      JSON_OBJECT_SIZE(4) + JSON_COMMAND_MESSAGE_SIZE +
+      max(max(commandList, valueGet), (size_t)JSON_COMMAND_HANDLER_SIZE);
+
+  const size_t capacity = _JsonCapacity[JsonUI];
+  if (_JsonDocument == NULL || _JsonDocument->capacity() != capacity) {
+    delete _JsonDocument;
+    _JsonDocument = new DynamicJsonDocument(capacity);
+  }
+}
+
+size_t Growatt::GetJsonCapacity(eGrowattJson_t type) {
+  /**
+   * @brief Worst case capacity of a document for the active protocol
+   * @param type the document
+   * @returns capacity in bytes, for JsonCommand without the request
+   */
+  return _JsonCapacity[type];
+}
+
+JsonDocument& Growatt::GetJsonDocument(eGrowattJson_t type) {
+  /**
+   * @brief Get the cleared document for CreateUIJson(). It is allocated
+   * once per protocol and reused, the previous user has to be done with it.
+   * @param type JsonUI
+   * @returns the document
+   */
+  if (_JsonDocument == NULL) {
+    _JsonDocument = new DynamicJsonDocument(_JsonCapacity[type]);
+  }
+  _JsonDocument->clear();
+  return *_JsonDocument;
+}
+
+size_t Growatt::GetCommandRequestCapacity(size_t length) {
+  /**
+   * @brief Capacity that parses any JSON request of the given length, every
+   * value takes at least two characters and all strings are copied
+   * @param length size of the payload
+   * @returns capacity in bytes
+   */
+  return JSON_ARRAY_SIZE(length / 2 + 1) + length + 1;
+}
+
+size_t Growatt::GetCommandResultCapacity(const String& command,
+                                         size_t length) {
+  /**
+   * @brief Capacity of the result of a command. The request can be copied
+   * into it, e.g. the correlationId, and the command name appears in the
+   * result and in the message for an unknown command.
+   * @param command the command
+   * @param length size of the request payload
+   * @returns capacity in bytes
+   */
+  return _JsonCapacity[JsonCommand] + length + 2 * (command.length() + 1);
+}
+
+void Growatt::recordJsonUsage(eGrowattJson_t type, const JsonDocument& doc) {
+  _JsonLastCapacity[type] = doc.capacity();
+  _JsonLastUsage[type] = doc.memoryUsage();
+}
+
+void Growatt::mapRegisterFragments() {
+  /**
+   * @brief Remember the fragment of every register, the age of a value is
+   * the age of its fragment
+   */
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  delete[] _RegisterFragments;
+  _RegisterFragments = new uint8_t[count];
+  for (uint16_t slot = 0; slot < count; slot++) {
+    const bool holding = slot >= _Protocol.InputRegisterCount;
+    const uint16_t index =
+        holding ? slot - _Protocol.InputRegisterCount : slot;
+    const sGrowattRegisterDef_t def = readRegisterDef(
+        holding ? _Protocol.HoldingRegisters : _Protocol.InputRegisters,
+        index);
+    const uint8_t fragmentCount = holding ? _Protocol.HoldingFragmentCount
+                                          : _Protocol.InputFragmentCount;
+    // the tables are checked, every register is part of a fragment
+    _RegisterFragments[slot] = 0;
+    for (uint8_t f = 0; f < fragmentCount; f++) {
+      const sGrowattReadFragment_t frag = GetFragment(holding, f);
+      if (def.address >= frag.StartAddress &&
+          def.address < frag.StartAddress + frag.FragmentSize) {
+        _RegisterFragments[slot] = f;
+        break;
+      }
+    }
+  }
+}
+
+void Growatt::mapRegisterGroups() {
+  /**
+   * @brief Resolve the groups of every register from the address ranges of
+   * the protocol, a selection by group then only tests bits
+   */
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  delete[] _RegisterGroups;
+  _RegisterGroups = new uint8_t[count];
+  for (uint16_t slot = 0; slot < count; slot++) {
+    const bool holding = slot >= _Protocol.InputRegisterCount;
+    const uint16_t index =
+        holding ? slot - _Protocol.InputRegisterCount : slot;
+    const sGrowattRegisterDef_t def = readRegisterDef(
+        holding ? _Protocol.HoldingRegisters : _Protocol.InputRegisters,
+        index);
+    const sGrowattRegisterGroup_t* table =
+        holding ? _Protocol.HoldingGroups : _Protocol.InputGroups;
+    const uint8_t groupCount =
+        holding ? _Protocol.HoldingGroupCount : _Protocol.InputGroupCount;
+    _RegisterGroups[slot] = 0;
+    for (uint8_t g = 0; g < groupCount; g++) {
+      const sGrowattRegisterGroup_t group = readGroupDef(table, g);
+      if (def.address >= group.FirstAddress &&
+          def.address <= group.LastAddress) {
+        _RegisterGroups[slot] |= group.Groups;
+      }
+    }
+  }
+}
+
+const sGrowattFragmentCadence_t& Growatt::GetRegisterCadence(bool holding,
+                                                             uint16_t index) {
+  /**
+   * @brief Get the read times of the fragment a register belongs to, as of
+   * the last PublishValues()
+   * @param holding true for a holding register, false for an input register
+   * @param index index of the register in the protocol table
+   * @returns the cadence of the fragment
+   */
+  const uint16_t slot = holding ? _Protocol.InputRegisterCount + index : index;
+  const uint8_t fragment = _RegisterFragments[slot];
+  return holding ? _SnapshotHoldingCadence[fragment]
+                 : _SnapshotInputCadence[fragment];
+}
+
+bool Growatt::IsValueValid(bool holding, uint16_t index, uint32_t now) {
+  /**
+   * @brief Check if the value of a register was read and is not older than
+   * MAX_VALUE_AGE
+   * @param holding true for a holding register, false for an input register
+   * @param index index of the register in the protocol table
+   * @param now current millis()
+   * @returns true if the value may be served
+   */
+#if SIMULATE_INVERTER == 1
+  (void)holding;
+  (void)index;
+  (void)now;
+  return true;
 #else
-#error "Unsupported Growatt Modbus version"
+  const sGrowattFragmentCadence_t& cadence = GetRegisterCadence(holding, index);
+  if (cadence.LastRead == 0) return false;
+  return MAX_VALUE_AGE == 0 || now - cadence.LastRead <= MAX_VALUE_AGE;
 #endif
 }
 
-void Growatt::begin(Stream& serial) {
+bool Growatt::HasValidValues() {
+  /**
+   * @brief Check if there is anything to serve, a failed poll keeps the
+   * values of the previous ones until they are too old
+   * @returns true if at least one value is valid
+   */
+#if SIMULATE_INVERTER == 1
+  return true;
+#else
+  const uint32_t now = millis();
+  for (uint16_t i = 0; i < _Protocol.InputRegisterCount; i++) {
+    if (IsValueValid(false, i, now)) return true;
+  }
+  for (uint16_t i = 0; i < _Protocol.HoldingRegisterCount; i++) {
+    if (IsValueValid(true, i, now)) return true;
+  }
+  return false;
+#endif
+}
+
+uint32_t Growatt::GetGeneration() {
+  /**
+   * @brief Generation of the values, it advances with every poll and
+   * protocol change. Outputs built from the same generation only differ in
+   * the values of the stick itself, e.g. the uptime.
+   * @returns the generation
+   */
+  return _Generation;
+}
+
+bool Growatt::FindRegister(const String& name, bool& holding,
+                           uint16_t& index) {
+  /**
+   * @brief Look up a register by its name, case-insensitive
+   * @param name name of the register
+   * @param holding set to true if it is a holding register
+   * @param index set to the index of the register in the protocol table
+   * @returns false if the protocol has no register of that name
+   */
+  if (_NameIndexSize == 0) return false;
+  const uint16_t mask = _NameIndexSize - 1;
+  for (uint16_t i = nameHash(name.c_str()) & mask; _NameIndex[i] != 0;
+       i = (i + 1) & mask) {
+    const uint16_t slot = _NameIndex[i] - 1;
+    holding = slot >= _Protocol.InputRegisterCount;
+    index = holding ? slot - _Protocol.InputRegisterCount : slot;
+    const sGrowattRegisterDef_t def = readRegisterDef(
+        holding ? _Protocol.HoldingRegisters : _Protocol.InputRegisters,
+        index);
+    if (strcasecmp_P(name.c_str(), def.name) == 0) return true;
+  }
+  return false;
+}
+
+// names of the eGrowattGroup_t bits
+static const char* const GROUP_NAMES[GROUP_COUNT] = {
+    "pv", "grid", "battery", "load", "energy", "status", "diagnostics",
+    "settings"};
+
+static bool nextListItem(const String& list, int& start, String& item) {
+  // items of a comma separated list, surrounding spaces are dropped
+  if (start > (int)list.length()) return false;
+  int end = list.indexOf(',', start);
+  if (end < 0) end = list.length();
+  item = list.substring(start, end);
+  item.trim();
+  start = end + 1;
+  return true;
+}
+
+uint8_t Growatt::ParseGroups(const String& list, String& unknown) {
+  /**
+   * @brief Parse a comma separated list of group names, e.g. "pv,grid"
+   * @param unknown set to the first name that is not a group
+   * @returns the eGrowattGroup_t bits of the list
+   */
+  uint8_t groups = 0;
+  String item;
+  for (int start = 0; nextListItem(list, start, item);) {
+    if (item.isEmpty()) continue;
+    uint8_t bit = 0;
+    while (bit < GROUP_COUNT && !item.equalsIgnoreCase(GROUP_NAMES[bit])) {
+      bit++;
+    }
+    if (bit == GROUP_COUNT) {
+      if (unknown.isEmpty()) unknown = item;
+      continue;
+    }
+    groups |= 1 << bit;
+  }
+  return groups;
+}
+
+const char* Growatt::GetGroupName(uint8_t bit) {
+  /**
+   * @param bit number of the eGrowattGroup_t bit
+   * @returns name of the group as used in the query arguments
+   */
+  return bit < GROUP_COUNT ? GROUP_NAMES[bit] : "";
+}
+
+bool Growatt::Select(RegisterSelection& selection, const String& groups,
+                     const String& names, String& unknown) {
+  /**
+   * @brief Restrict an output to the registers of some groups and to some
+   * registers by name. Both lists empty select all registers.
+   * @param groups comma separated group names, see ParseGroups()
+   * @param names comma separated register names
+   * @param unknown set to the first group or name that does not exist
+   * @returns false if a group or name does not exist
+   */
+  delete[] selection._Bits;
+  selection._Bits = NULL;
+  selection._Groups = 0;
+  if (groups.isEmpty() && names.isEmpty()) return true;
+
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  selection._Bits = new uint32_t[(count + 31) / 32]();
+  selection._Groups = ParseGroups(groups, unknown);
+  if (selection._Groups != 0) {
+    for (uint16_t slot = 0; slot < count; slot++) {
+      if (_RegisterGroups[slot] & selection._Groups) {
+        selection._Bits[slot / 32] |= 1UL << (slot % 32);
+      }
+    }
+  }
+  String item;
+  for (int start = 0; nextListItem(names, start, item);) {
+    if (item.isEmpty()) continue;
+    bool holding;
+    uint16_t index;
+    if (!FindRegister(item, holding, index)) {
+      if (unknown.isEmpty()) unknown = item;
+      continue;
+    }
+    const uint16_t slot =
+        holding ? _Protocol.InputRegisterCount + index : index;
+    selection._Bits[slot / 32] |= 1UL << (slot % 32);
+    // the value of a repeated name may come from any of its registers
+    for (uint16_t other = 0; _DuplicateNames && other < count; other++) {
+      if (strcmp(_Names[other], _Names[slot]) == 0) {
+        selection._Bits[other / 32] |= 1UL << (other % 32);
+      }
+    }
+  }
+  return unknown.isEmpty();
+}
+
+uint16_t Growatt::GetProtocolVersion() { return _ProtocolVersion; }
+
+uint16_t Growatt::DetectProtocol() {
+  /**
+   * @brief Guess the modbus protocol of the inverter from the input register
+   * ranges it answers. 307 and 5000 share their ranges with 124 and 120 and
+   * can only be selected manually.
+   * @returns the detected protocol version, 0 if the inverter did not answer
+   */
+#if SIMULATE_INVERTER == 1
+  return GROWATT_MODBUS_VERSION ? GROWATT_MODBUS_VERSION : 124;
+#else
+  // most specific range first, TL-X(H) and storage inverters also answer the
+  // lower ranges
+  static const struct {
+    uint16_t address;
+    uint16_t version;
+  } signatures[] = {
+      {3000, 3000},  // TL-X(H)
+      {4014, 6000},  // BP
+      {1009, 124},   // storage (SPH)
+      {100, 120},
+      {0, 305},
+  };
+  uint16_t version = 0;
+
+  _Bus.Begin(BusDiagnostic);
+  for (uint8_t i = 0; i < sizeof(signatures) / sizeof(signatures[0]); i++) {
+    if (_Modbus.readInputRegisters(signatures[i].address, 1) ==
+        _Modbus.ku8MBSuccess) {
+      version = signatures[i].version;
+      break;
+    }
+  }
+  _Bus.End(BusDiagnostic);
+  return version;
+#endif
+}
+
+void Growatt::beginSerial(HardwareSerial& serial, uint32_t baud, int8_t rxPin,
+                          int8_t txPin) {
+#ifdef ESP32
+  serial.begin(baud, SERIAL_8N1, rxPin, txPin);
+#else
+  // the ESP8266 UART pins are fixed
+  (void)rxPin;
+  (void)txPin;
+  serial.begin(baud);
+#endif
+}
+
+void Growatt::begin(HardwareSerial& serial, int8_t rxPin, int8_t txPin) {
   /**
    * @brief Set up communication with the inverter
-   * @param serial The serial interface
+   * @param serial The UART the inverter is connected to
+   * @param rxPin RX pin of the UART, -1 for the default pin (ESP32 only)
+   * @param txPin TX pin of the UART, -1 for the default pin (ESP32 only)
    */
 #if SIMULATE_INVERTER == 1
+  (void)serial;
+  (void)rxPin;
+  (void)txPin;
   _eDevice = SIMULATE_DEVICE;
 #else
   uint8_t res;
   // init communication with the inverter
-  Serial.begin(9600);
-  Modbus.begin(1, serial);
-  res = Modbus.readInputRegisters(0, 1);
-  if (res == Modbus.ku8MBSuccess) {
+  beginSerial(serial, 9600, rxPin, txPin);
+  _Modbus.begin(1, serial);
+  res = _Modbus.readInputRegisters(0, 1);
+  if (res == _Modbus.ku8MBSuccess) {
     _eDevice = ShineWiFi_S;  // Serial
   } else {
     delay(1000);
-    Serial.begin(115200);
-    Modbus.begin(1, serial);
-    Modbus.setResponseTimeout(250);
-    res = Modbus.readInputRegisters(0, 1);
-    if (res == Modbus.ku8MBSuccess) {
+    beginSerial(serial, 115200, rxPin, txPin);
+    _Modbus.begin(1, serial);
+    _Modbus.setResponseTimeout(250);
+    res = _Modbus.readInputRegisters(0, 1);
+    if (res == _Modbus.ku8MBSuccess) {
       _eDevice = ShineWiFi_X;  // USB
     }
     delay(1000);
@@ -111,129 +760,480 @@ void Growatt::begin(Stream& serial) {
 #endif
 }
 
-eDevice_t Growatt::GetWiFiStickType() {
+eDevice_t Growatt::GetWiFiStickType() {
+  /**
+   * @brief After initialisation the type of the wifi stick is known
+   * @returns eDevice_t type of the wifi stick
+   */
+
+  return _eDevice;
+}
+
+void Growatt::SetInverterId(uint8_t id) {
+  /**
+   * @brief Set the number of the inverter, used to label the outputs if
+   * several inverters are connected
+   * @param id number of the inverter, starting at 1
+   */
+  _InverterId = id;
+}
+
+uint8_t Growatt::GetInverterId() { return _InverterId; }
+
+bool Growatt::ReadInputFragment(uint8_t fragment) {
+  /**
+   * @brief Read a single input register fragment from the inverter, the
+   * values are served after the next PublishValues()
+   * @param fragment index of the fragment in the protocol definition
+   * @returns true if data was read successfully, false otherwise
+   */
+  const sGrowattReadFragment_t frag =
+      readFragmentDef(_Protocol.InputReadFragments, fragment);
+  uint16_t registerAddress;
+  uint8_t res;
+
+#ifdef DEBUG_MODBUS_OUTPUT
+  Log.printf("Modbus: read Segment from 0x%02X with len: %d ...",
+             frag.StartAddress, frag.FragmentSize);
+#endif
+  res = _Modbus.readInputRegisters(frag.StartAddress, frag.FragmentSize);
+  if (res != _Modbus.ku8MBSuccess) {
+#ifdef DEBUG_MODBUS_OUTPUT
+    Log.println(F("failed"));
+#endif
+    return false;
+  }
+#ifdef DEBUG_MODBUS_OUTPUT
+  Log.println(F("ok"));
+#endif
+
+  for (int j = 0; j < _Protocol.InputRegisterCount; j++) {
+    const sGrowattRegisterDef_t reg =
+        readRegisterDef(_Protocol.InputRegisters, j);
+    // make sure the register we try to read is in the fragment
+    if (reg.address < frag.StartAddress ||
+        reg.address >= frag.StartAddress + frag.FragmentSize)
+      continue;
+    // let's say the register address is 1013 and read window is 1000-1050
+    // that means the response in the buffer is on position 1013 - 1000 = 13
+    registerAddress = reg.address - frag.StartAddress;
+    _PollInputValues[j] = responseValue(reg.size, registerAddress);
+  }
+  updateCadence(_InputCadence[fragment], frag.FragmentSize, millis());
+  return true;
+}
+
+bool Growatt::ReadFragmentValues(bool holding, uint8_t fragment,
+                                 const uint16_t* indexes, const bool* types,
+                                 uint8_t count, uint32_t* values) {
+  /**
+   * @brief Read a fragment for a caller with its own buffer, e.g. the
+   * capture. Neither the polled values nor the learned cadence change.
+   * @param holding true for a holding fragment, false for an input fragment
+   * @param fragment index of the fragment in the protocol definition
+   * @param indexes indexes of the registers in the protocol tables
+   * @param types true for the holding registers in indexes
+   * @param count number of registers
+   * @param values receives the raw values of the registers in the fragment,
+   * the other entries are left unchanged
+   * @returns true if data was read successfully, false otherwise
+   */
+  const sGrowattReadFragment_t frag = GetFragment(holding, fragment);
+  uint8_t res =
+      holding ? _Modbus.readHoldingRegisters(frag.StartAddress,
+                                             frag.FragmentSize)
+              : _Modbus.readInputRegisters(frag.StartAddress,
+                                           frag.FragmentSize);
+  if (res != _Modbus.ku8MBSuccess) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (types[i] != holding) continue;
+    const sGrowattRegisterDef_t reg = readRegisterDef(
+        holding ? _Protocol.HoldingRegisters : _Protocol.InputRegisters,
+        indexes[i]);
+    if (!fragmentContains(frag, reg.address)) continue;
+    values[i] = responseValue(reg.size, reg.address - frag.StartAddress);
+  }
+  return true;
+}
+
+uint32_t Growatt::responseValue(RegisterSize_t size, uint16_t offset) {
+  /**
+   * @brief Get the raw value of a register from the modbus response buffer
+   * @param size size of the register
+   * @param offset position of the register in the response
+   * @returns the raw register value
+   */
+  switch (size) {
+    case SIZE_32BIT:
+    case SIZE_32BIT_S:
+      return ((uint32_t)_Modbus.getResponseBuffer(offset) << 16) +
+             _Modbus.getResponseBuffer(offset + 1);
+    case SIZE_8BIT_L:
+      return _Modbus.getResponseBuffer(offset) & 0xff;
+    case SIZE_8BIT_H:
+      return _Modbus.getResponseBuffer(offset) >> 8;
+    default:
+      return _Modbus.getResponseBuffer(offset);
+  }
+}
+
+bool Growatt::ReadInputRegisters(bool retry) {
+  /**
+   * @brief Read the input registers from the inverter
+   * @param retry true to repeat the fragments that failed in this poll cycle
+   * @returns true if data was read successfully, false otherwise
+   */
+  uint32_t now = millis();
+
+  // read each fragment separately
+  for (int i = 0; i < _Protocol.InputFragmentCount; i++) {
+    if (!fragmentDue(_InputCadence[i], now) &&
+        !(retry && fragmentFailedInCycle(_InputCadence[i]))) {
+      continue;
+    }
+    _InputCadence[i].LastAttempt = now;
+    if (!ReadInputFragment(i)) return false;
+  }
+  return true;
+}
+
+bool Growatt::ReadHoldingFragment(uint8_t fragment) {
+  /**
+   * @brief Read a single holding register fragment from the inverter, the
+   * values are served after the next PublishValues()
+   * @param fragment index of the fragment in the protocol definition
+   * @returns true if data was read successfully, false otherwise
+   */
+  const sGrowattReadFragment_t frag =
+      readFragmentDef(_Protocol.HoldingReadFragments, fragment);
+  uint16_t registerAddress;
+  uint8_t res;
+
+  res = _Modbus.readHoldingRegisters(frag.StartAddress, frag.FragmentSize);
+  if (res != _Modbus.ku8MBSuccess) {
+    return false;
+  }
+
+  for (int j = 0; j < _Protocol.HoldingRegisterCount; j++) {
+    const sGrowattRegisterDef_t reg =
+        readRegisterDef(_Protocol.HoldingRegisters, j);
+    if (reg.address < frag.StartAddress ||
+        reg.address >= frag.StartAddress + frag.FragmentSize)
+      continue;
+    registerAddress = reg.address - frag.StartAddress;
+    _PollHoldingValues[j] = responseValue(reg.size, registerAddress);
+  }
+  updateCadence(_HoldingCadence[fragment], frag.FragmentSize, millis());
+  return true;
+}
+
+bool Growatt::ReadHoldingRegisters(bool retry) {
+  /**
+   * @brief Read the holding registers from the inverter
+   * @param retry true to repeat the fragments that failed in this poll cycle
+   * @returns true if data was read successfully, false otherwise
+   */
+  uint32_t now = millis();
+
+  // read each fragment separately
+  for (int i = 0; i < _Protocol.HoldingFragmentCount; i++) {
+    if (!fragmentDue(_HoldingCadence[i], now) &&
+        !(retry && fragmentFailedInCycle(_HoldingCadence[i]))) {
+      continue;
+    }
+    _HoldingCadence[i].LastAttempt = now;
+    if (!ReadHoldingFragment(i)) return false;
+  }
+  return true;
+}
+
+void Growatt::updateCadence(sGrowattFragmentCadence_t& cadence, uint8_t size,
+                            uint32_t now) {
+  /**
+   * @brief Update the learned update period of a fragment from the words
+   * which are still in the modbus response buffer
+   * @param cadence cadence of the fragment that was just read
+   * @param size number of words in the response buffer
+   * @param now time of the read
+   */
+  // FNV-1a over the raw words, a change of any word changes the checksum
+  uint32_t checksum = 2166136261u;
+  for (uint8_t i = 0; i < size; i++) {
+    checksum = (checksum ^ _Modbus.getResponseBuffer(i)) * 16777619u;
+  }
+
+  if (cadence.LastRead == 0) {
+    cadence.LastChange = now;
+  } else if (checksum != cadence.Checksum) {
+    // the first change only tells us the phase, not the period
+    if (cadence.Changes > 0) {
+      uint32_t interval = now - cadence.LastChange;
+      if (cadence.Period == 0) {
+        cadence.Period = interval;
+      } else if (interval < cadence.Period) {
+        // intervals without a changed value are multiples of the real period,
+        // so follow shorter intervals quickly and longer ones slowly
+        cadence.Period = (cadence.Period + interval) / 2;
+      } else {
+        cadence.Period = (7 * cadence.Period + interval) / 8;
+      }
+    }
+    cadence.Changes++;
+    cadence.LastChange = now;
+  }
+  cadence.Checksum = checksum;
+  cadence.LastRead = now;
+
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  cadence.LastReadTime = tv.tv_sec < WALLCLOCK_VALID_EPOCH
+                             ? 0
+                             : (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+uint32_t Growatt::fragmentNextPoll(const sGrowattFragmentCadence_t& cadence,
+                                   uint32_t now) {
+  /**
+   * @brief Calculate when a fragment should be read next. The poll is placed
+   * shortly after the next expected update of the inverter.
+   * @param cadence cadence of the fragment
+   * @param now current time
+   * @returns millis() timestamp of the next read
+   */
+  uint32_t period = cadence.Period ? cadence.Period : REFRESH_TIMER;
+  period = constrain(period, (uint32_t)CADENCE_MIN_INTERVAL,
+                     (uint32_t)CADENCE_MAX_INTERVAL);
+  if (cadence.LastAttempt == 0) return now;
+  // a fragment that was never read or whose last read failed is retried
+  // at the poll rate, an offline inverter must not keep the bus busy
+  if (fragmentFailed(cadence)) {
+    return cadence.LastAttempt +
+           max((uint32_t)REFRESH_TIMER, (uint32_t)CADENCE_MIN_INTERVAL);
+  }
+  if (cadence.Period == 0) {
+    return cadence.LastRead + period;
+  }
+  // give the inverter some slack to finish its update
+  const uint32_t margin = period / 10;
+  uint32_t sinceChange = cadence.LastRead - cadence.LastChange;
+  uint32_t next =
+      cadence.LastChange + (sinceChange / period + 1) * period + margin;
+  if (next - cadence.LastRead > CADENCE_MAX_INTERVAL) {
+    next = cadence.LastRead + CADENCE_MAX_INTERVAL;
+  }
+  return next;
+}
+
+bool Growatt::fragmentFailed(const sGrowattFragmentCadence_t& cadence) {
+  /**
+   * @brief Check if the values of a fragment are missing or older than its
+   * last attempted read
+   * @param cadence cadence of the fragment
+   * @returns true if the last read of the fragment failed
+   */
+  return cadence.LastAttempt != 0 &&
+         (cadence.LastRead == 0 ||
+          (int32_t)(cadence.LastAttempt - cadence.LastRead) > 0);
+}
+
+bool Growatt::fragmentFailedInCycle(const sGrowattFragmentCadence_t& cadence) {
+  /**
+   * @brief Check if a fragment failed in the current poll cycle, the retries
+   * of ReadData() repeat it instead of waiting for the backoff
+   * @param cadence cadence of the fragment
+   * @returns true if the fragment failed since the cycle started
+   */
+  return fragmentFailed(cadence) &&
+         (int32_t)(cadence.LastAttempt - _CycleStart) >= 0;
+}
+
+bool Growatt::fragmentsFailed() {
+  /**
+   * @brief Check if any fragment is missing its latest values, e.g. one that
+   * is held back after a failed read
+   * @returns true if the values of a fragment are not current
+   */
+  for (int i = 0; i < _Protocol.InputFragmentCount; i++) {
+    if (fragmentFailed(_InputCadence[i])) return true;
+  }
+  for (int i = 0; i < _Protocol.HoldingFragmentCount; i++) {
+    if (fragmentFailed(_HoldingCadence[i])) return true;
+  }
+  return false;
+}
+
+bool Growatt::fragmentDue(const sGrowattFragmentCadence_t& cadence,
+                          uint32_t now) {
+  /**
+   * @brief Check if a fragment has to be read in this poll cycle
+   * @param cadence cadence of the fragment
+   * @param now current time
+   * @returns true if the fragment should be read
+   */
+#if ENABLE_CADENCE_TUNING == 1
+  return (int32_t)(now - fragmentNextPoll(cadence, now)) >= 0;
+#else
+  (void)cadence;
+  (void)now;
+  return true;
+#endif
+}
+
+uint32_t Growatt::GetNextPollTime() {
+  /**
+   * @brief Get the time of the next poll according to the learned update
+   * periods of all fragments. Without cadence tuning all fragments are read
+   * every REFRESH_TIMER ms.
+   * @returns millis() timestamp at which the next fragment is due
+   */
+  uint32_t now = millis();
+  uint32_t next = now + CADENCE_MAX_INTERVAL;
+  for (int i = 0; i < _Protocol.InputFragmentCount; i++) {
+    uint32_t t = fragmentNextPoll(_InputCadence[i], now);
+    if ((int32_t)(t - next) < 0) next = t;
+  }
+  for (int i = 0; i < _Protocol.HoldingFragmentCount; i++) {
+    uint32_t t = fragmentNextPoll(_HoldingCadence[i], now);
+    if ((int32_t)(t - next) < 0) next = t;
+  }
+  return next;
+}
+
+bool Growatt::PollDue(uint32_t now) {
+  /**
+   * @brief Check if the inverter should be read now. The fixed-rate
+   * scheduler keeps the poll period independent of how long a cycle takes,
+   * with cadence tuning the learned update periods decide after the first
+   * read.
+   * @param now current millis()
+   * @returns true if ReadData() should be called
+   */
+#if ENABLE_CADENCE_TUNING == 1
+  // without a first read, e.g. while the inverter is not detected, there is
+  // no cadence yet, fall back to the fixed poll rate
+  if (fragmentsAttempted()) {
+    return (int32_t)(now - GetNextPollTime()) >= 0;
+  }
+#endif
+  uint32_t missed = _Scheduler.GetMissedTicks();
+  bool due = _Scheduler.Due(now);
+  if (_Scheduler.GetMissedTicks() != missed) {
+    Log.print(F("Missed poll ticks: "));
+    Log.println(_Scheduler.GetMissedTicks() - missed);
+  }
+  return due;
+}
+
+uint32_t Growatt::nextPollDeadline() {
+#if ENABLE_CADENCE_TUNING == 1
+  if (fragmentsAttempted()) return GetNextPollTime();
+#endif
+  return _Scheduler.GetNextDeadline();
+}
+
+bool Growatt::fragmentsAttempted() {
+  /**
+   * @brief Check if any fragment was read since the protocol was set up,
+   * successful or not
+   * @returns true if the learned cadence decides about the polls
+   */
+  for (int i = 0; i < _Protocol.InputFragmentCount; i++) {
+    if (_InputCadence[i].LastAttempt != 0) return true;
+  }
+  for (int i = 0; i < _Protocol.HoldingFragmentCount; i++) {
+    if (_HoldingCadence[i].LastAttempt != 0) return true;
+  }
+  return false;
+}
+
+bool Growatt::QueueBusJob(eBusClass_t busClass, BusJob job) {
+  /**
+   * @brief Queue work that accesses the modbus, it is run by ServiceBus()
+   * @param busClass priority class of the work
+   * @param job work to run
+   * @returns false if the queue is full and the job was rejected
+   */
+  return _Bus.Submit(busClass, job);
+}
+
+void Growatt::ServiceBus() {
+  /**
+   * @brief Run the queued bus work that fits in before the next poll
+   */
+  _Bus.Service(nextPollDeadline());
+}
+
+bool Growatt::AcquireBus(eBusClass_t busClass) {
   /**
-   * @brief After initialisation the type of the wifi stick is known
-   * @returns eDevice_t type of the wifi stick
+   * @brief Get the bus for work that can not be queued. Diagnostic work is
+   * only admitted within its budget and if it does not delay the next poll.
+   * @param busClass priority class of the work
+   * @returns true if the bus may be used, ReleaseBus() has to follow
    */
-
-  return _eDevice;
+  return _Bus.Acquire(busClass, nextPollDeadline());
 }
 
-bool Growatt::ReadInputRegisters() {
+void Growatt::ReleaseBus(eBusClass_t busClass) { _Bus.Release(busClass); }
+
+bool Growatt::ReadData(bool retry) {
   /**
-   * @brief Read the input registers from the inverter
+   * @brief Reads the data from the inverter and updates the internal data
+   * structures
+   * @param retry true if the previous call of this poll cycle failed, the
+   * fragments that failed are repeated right away
    * @returns true if data was read successfully, false otherwise
    */
-  uint16_t registerAddress;
-  uint8_t res;
-  int j = 0;
 
-  // read each fragment separately
-  for (int i = 0; i < _Protocol.InputFragmentCount; i++) {
-#ifdef DEBUG_MODBUS_OUTPUT
-    Log.printf("Modbus: read Segment from 0x%02X with len: %d ...",
-               _Protocol.InputReadFragments[i].StartAddress,
-               _Protocol.InputReadFragments[i].FragmentSize);
-#endif
-    res =
-        Modbus.readInputRegisters(_Protocol.InputReadFragments[i].StartAddress,
-                                  _Protocol.InputReadFragments[i].FragmentSize);
-    if (res == Modbus.ku8MBSuccess) {
-#ifdef DEBUG_MODBUS_OUTPUT
-      Log.println(F("ok"));
-#endif
-      for (; j < _Protocol.InputRegisterCount; j++) {
-        // make sure the register we try to read is in the fragment
-        if (_Protocol.InputRegisters[j].address >=
-            _Protocol.InputReadFragments[i].StartAddress) {
-          // when we exceed the fragment size, skip to new fragment
-          if (_Protocol.InputRegisters[j].address >=
-              _Protocol.InputReadFragments[i].StartAddress +
-                  _Protocol.InputReadFragments[i].FragmentSize)
-            break;
-          // let's say the register address is 1013 and read window is 1000-1050
-          // that means the response in the buffer is on position 1013 - 1000 =
-          // 13
-          registerAddress = _Protocol.InputRegisters[j].address -
-                            _Protocol.InputReadFragments[i].StartAddress;
-          if (_Protocol.InputRegisters[j].size == SIZE_16BIT ||
-              _Protocol.InputRegisters[j].size == SIZE_16BIT_S) {
-            _Protocol.InputRegisters[j].value =
-                Modbus.getResponseBuffer(registerAddress);
-          } else {
-            _Protocol.InputRegisters[j].value =
-                (Modbus.getResponseBuffer(registerAddress) << 16) +
-                Modbus.getResponseBuffer(registerAddress + 1);
-          }
-        }
-      }
-    } else {
-#ifdef DEBUG_MODBUS_OUTPUT
-      Log.println(F("failed"));
-#endif
-      return false;
-    }
+  _PacketCnt++;
+  if (!retry) {
+    _CycleStart = millis();
   }
-#if GROWATT_MODBUS_VERSION == 3000
-  _Protocol.InputRegisters[P3000_INVERTER_STATUS].value &= 0xff;
-  _Protocol.InputRegisters[P3000_INVERTER_RUNSTATE].value >>= 8;
-  _Protocol.InputRegisters[P3000_BDC_SYSSTATE].value &= 0xff;
-  _Protocol.InputRegisters[P3000_BDC_SYSMODE].value >>= 8;
-#endif
-  return true;
+  _Bus.Begin(BusTelemetry);
+  // a fragment held back after a failed read still has its old values, so
+  // the poll only succeeds once every fragment is current again
+  _GotData = ReadInputRegisters(retry) && ReadHoldingRegisters(retry) &&
+             !fragmentsFailed();
+  _Bus.End(BusTelemetry);
+  // a failed poll changes the outputs too, Stale and aged out values
+  PublishValues();
+  return _GotData;
 }
 
-bool Growatt::ReadHoldingRegisters() {
+void Growatt::PublishValues() {
   /**
-   * @brief Read the holding registers from the inverter
-   * @returns true if data was read successfully, false otherwise
+   * @brief Make the values read since the last call the ones that are
+   * served. The outputs never see the values of a poll in progress.
    */
-  uint16_t registerAddress;
-  uint8_t res;
-
-  // read each fragment separately
-  for (int i = 0; i < _Protocol.HoldingFragmentCount; i++) {
-    res = Modbus.readHoldingRegisters(
-        _Protocol.HoldingReadFragments[i].StartAddress,
-        _Protocol.HoldingReadFragments[i].FragmentSize);
-    if (res == Modbus.ku8MBSuccess) {
-      for (int j = 0; j < _Protocol.HoldingRegisterCount; j++) {
-        if (_Protocol.HoldingRegisters[j].address >=
-                _Protocol.HoldingReadFragments[i].StartAddress &&
-            _Protocol.HoldingRegisters[j].address <
-                _Protocol.HoldingReadFragments[i].StartAddress +
-                    _Protocol.HoldingReadFragments[i].FragmentSize) {
-          registerAddress = _Protocol.HoldingRegisters[j].address -
-                            _Protocol.HoldingReadFragments[i].StartAddress;
-          if (_Protocol.HoldingRegisters[j].size == SIZE_16BIT ||
-              _Protocol.HoldingRegisters[j].size == SIZE_16BIT_S) {
-            _Protocol.HoldingRegisters[j].value =
-                Modbus.getResponseBuffer(registerAddress);
-          } else {
-            _Protocol.HoldingRegisters[j].value =
-                (Modbus.getResponseBuffer(registerAddress) << 16) +
-                Modbus.getResponseBuffer(registerAddress + 1);
-          }
-        }
-      }
-    } else {
-      return false;
-    }
-  }
-  return true;
+  SnapshotLock lock(this);
+  memcpy(_Protocol.InputValues, _PollInputValues,
+         _Protocol.InputRegisterCount * sizeof(uint32_t));
+  memcpy(_Protocol.HoldingValues, _PollHoldingValues,
+         _Protocol.HoldingRegisterCount * sizeof(uint32_t));
+  memcpy(_SnapshotInputCadence, _InputCadence, sizeof(_InputCadence));
+  memcpy(_SnapshotHoldingCadence, _HoldingCadence, sizeof(_HoldingCadence));
+  _PublishTime = millis();
+  _Generation++;
 }
 
-bool Growatt::ReadData() {
+void Growatt::LockSnapshot() {
   /**
-   * @brief Reads the data from the inverter and updates the internal data
-   * structures
-   * @returns true if data was read successfully, false otherwise
+   * @brief Keep PublishValues() and InitProtocol() from changing the values
+   * and tables while another task builds an output, e.g. the web server
+   * task. loop() does not need it, the values only change while it polls or
+   * waits for the poll tasks. See SnapshotLock.
    */
+#ifdef ESP32
+  xSemaphoreTake(_SnapshotMutex, portMAX_DELAY);
+#endif
+}
 
-  _PacketCnt++;
-  _GotData = ReadInputRegisters() && ReadHoldingRegisters();
-  return _GotData;
+void Growatt::UnlockSnapshot() {
+#ifdef ESP32
+  xSemaphoreGive(_SnapshotMutex);
+#endif
 }
 
 sGrowattModbusReg_t Growatt::GetInputRegister(uint16_t reg) {
@@ -245,7 +1245,7 @@ sGrowattModbusReg_t Growatt::GetInputRegister(uint16_t reg) {
   if (_GotData == false) {
     ReadData();
   }
-  return _Protocol.InputRegisters[reg];
+  return GetRegister(false, reg);
 }
 
 sGrowattModbusReg_t Growatt::GetHoldingRegister(uint16_t reg) {
@@ -257,7 +1257,38 @@ sGrowattModbusReg_t Growatt::GetHoldingRegister(uint16_t reg) {
   if (_GotData == false) {
     ReadData();
   }
-  return _Protocol.HoldingRegisters[reg];
+  return GetRegister(true, reg);
+}
+
+sGrowattModbusReg_t Growatt::GetRegister(bool holding, uint16_t index) {
+  /**
+   * @brief Get a register of the protocol along with its last value, the
+   * definition is copied from the flash resident protocol table
+   * @param holding true for a holding register, false for an input register
+   * @param index index of the register in the protocol table
+   * @returns the register
+   */
+  const sGrowattRegisterDef_t def = readRegisterDef(
+      holding ? _Protocol.HoldingRegisters : _Protocol.InputRegisters, index);
+  const uint32_t value = holding ? _Protocol.HoldingValues[index]
+                                 : _Protocol.InputValues[index];
+  return sGrowattModbusReg_t{
+      def.address,    value,          def.size,  FPSTR(def.name),
+      def.multiplier, def.resolution, def.unit,  def.frontend,
+      def.plot,       def.decimals,   def.scale, def.divisor,
+      def.labels};
+}
+
+sGrowattReadFragment_t Growatt::GetFragment(bool holding, uint8_t index) {
+  /**
+   * @brief Get a read fragment of the protocol
+   * @param holding true for a holding fragment, false for an input fragment
+   * @param index index of the fragment in the protocol table
+   * @returns the fragment
+   */
+  return readFragmentDef(
+      holding ? _Protocol.HoldingReadFragments : _Protocol.InputReadFragments,
+      index);
 }
 
 bool Growatt::ReadHoldingReg(uint16_t adr, uint16_t* result) {
@@ -268,9 +1299,9 @@ bool Growatt::ReadHoldingReg(uint16_t adr, uint16_t* result) {
  * @returns true if successful
  */
 #if SIMULATE_INVERTER != 1
-  uint8_t res = Modbus.readHoldingRegisters(adr, 1);
-  if (res == Modbus.ku8MBSuccess) {
-    *result = Modbus.getResponseBuffer(0);
+  uint8_t res = _Modbus.readHoldingRegisters(adr, 1);
+  if (res == _Modbus.ku8MBSuccess) {
+    *result = _Modbus.getResponseBuffer(0);
     return true;
   }
   return false;
@@ -288,9 +1319,9 @@ bool Growatt::ReadHoldingReg(uint16_t adr, uint32_t* result) {
  * @returns true if successful
  */
 #if SIMULATE_INVERTER != 1
-  uint8_t res = Modbus.readHoldingRegisters(adr, 2);
-  if (res == Modbus.ku8MBSuccess) {
-    *result = (Modbus.getResponseBuffer(0) << 16) + Modbus.getResponseBuffer(1);
+  uint8_t res = _Modbus.readHoldingRegisters(adr, 2);
+  if (res == _Modbus.ku8MBSuccess) {
+    *result = (_Modbus.getResponseBuffer(0) << 16) + _Modbus.getResponseBuffer(1);
     return true;
   }
   return false;
@@ -308,10 +1339,10 @@ bool Growatt::ReadHoldingRegFrag(uint16_t adr, uint8_t size, uint16_t* result) {
    * @param result pointer to the result
    * @returns true if successful
    */
-  uint8_t res = Modbus.readHoldingRegisters(adr, size);
-  if (res == Modbus.ku8MBSuccess) {
+  uint8_t res = _Modbus.readHoldingRegisters(adr, size);
+  if (res == _Modbus.ku8MBSuccess) {
     for (int i = 0; i < size; i++) {
-      result[i] = Modbus.getResponseBuffer(i);
+      result[i] = _Modbus.getResponseBuffer(i);
     }
     return true;
   }
@@ -326,11 +1357,11 @@ bool Growatt::ReadHoldingRegFrag(uint16_t adr, uint8_t size, uint32_t* result) {
    * @param result pointer to the result
    * @returns true if successful
    */
-  uint8_t res = Modbus.readHoldingRegisters(adr, size * 2);
-  if (res == Modbus.ku8MBSuccess) {
+  uint8_t res = _Modbus.readHoldingRegisters(adr, size * 2);
+  if (res == _Modbus.ku8MBSuccess) {
     for (int i = 0; i < size; i++) {
-      result[i] = (Modbus.getResponseBuffer(i * 2) << 16) +
-                  Modbus.getResponseBuffer(i * 2 + 1);
+      result[i] = (_Modbus.getResponseBuffer(i * 2) << 16) +
+                  _Modbus.getResponseBuffer(i * 2 + 1);
     }
     return true;
   }
@@ -345,8 +1376,8 @@ bool Growatt::WriteHoldingReg(uint16_t adr, uint16_t value) {
  * @returns true if successful
  */
 #if SIMULATE_INVERTER != 1
-  uint8_t res = Modbus.writeSingleRegister(adr, value);
-  if (res == Modbus.ku8MBSuccess) {
+  uint8_t res = _Modbus.writeSingleRegister(adr, value);
+  if (res == _Modbus.ku8MBSuccess) {
     return true;
   }
   return false;
@@ -364,10 +1395,10 @@ bool Growatt::WriteHoldingRegFrag(uint16_t adr, uint8_t size, uint16_t* value) {
    * @returns true if successful
    */
   for (int i = 0; i < size; i++) {
-    Modbus.setTransmitBuffer(i, value[i]);
+    _Modbus.setTransmitBuffer(i, value[i]);
   }
-  uint8_t res = Modbus.writeMultipleRegisters(adr, size);
-  if (res == Modbus.ku8MBSuccess) {
+  uint8_t res = _Modbus.writeMultipleRegisters(adr, size);
+  if (res == _Modbus.ku8MBSuccess) {
     return true;
   }
   return false;
@@ -381,9 +1412,9 @@ bool Growatt::ReadInputReg(uint16_t adr, uint16_t* result) {
  * @returns true if successful
  */
 #if SIMULATE_INVERTER != 1
-  uint8_t res = Modbus.readInputRegisters(adr, 1);
-  if (res == Modbus.ku8MBSuccess) {
-    *result = Modbus.getResponseBuffer(0);
+  uint8_t res = _Modbus.readInputRegisters(adr, 1);
+  if (res == _Modbus.ku8MBSuccess) {
+    *result = _Modbus.getResponseBuffer(0);
     return true;
   }
   return false;
@@ -401,9 +1432,9 @@ bool Growatt::ReadInputReg(uint16_t adr, uint32_t* result) {
  * @returns true if successful
  */
 #if SIMULATE_INVERTER != 1
-  uint8_t res = Modbus.readInputRegisters(adr, 2);
-  if (res == Modbus.ku8MBSuccess) {
-    *result = (Modbus.getResponseBuffer(0) << 16) + Modbus.getResponseBuffer(1);
+  uint8_t res = _Modbus.readInputRegisters(adr, 2);
+  if (res == _Modbus.ku8MBSuccess) {
+    *result = (_Modbus.getResponseBuffer(0) << 16) + _Modbus.getResponseBuffer(1);
     return true;
   }
   return false;
@@ -413,119 +1444,317 @@ bool Growatt::ReadInputReg(uint16_t adr, uint32_t* result) {
 #endif
 }
 
-double Growatt::roundByResolution(const double& value,
-                                  const float& resolution) {
-  double res = 1 / resolution;
-  return int32_t(value * res + 0.5) / res;
-}
-
-double Growatt::getRegValue(sGrowattModbusReg_t* reg) {
-  double result = 0;
-  RegisterSize_t size = reg->size;
-  const float& mult = reg->multiplier;
-  const uint32_t& value = reg->value;
-  const float& resolution = reg->resolution;
-
-  switch (size) {
+int64_t Growatt::GetRegScaled(sGrowattModbusReg_t* reg) {
+  /**
+   * @brief Decode a register to a fixed-point integer without floating point
+   * math, the value is the result / 10^reg->decimals
+   * @param reg the register
+   * @returns the scaled value
+   */
+  int64_t result;
+  switch (reg->size) {
     case SIZE_16BIT_S:
-      result = (mult == (int)mult)
-                   ? (int16_t)value * mult
-                   : roundByResolution((int16_t)value * mult, resolution);
+      result = (int16_t)reg->value;
       break;
     case SIZE_32BIT_S:
-      result = (mult == (int)mult)
-                   ? (int32_t)value * mult
-                   : roundByResolution((int32_t)value * mult, resolution);
+      result = (int32_t)reg->value;
       break;
     default:
-      result = (mult == (int)mult)
-                   ? value * mult
-                   : roundByResolution(value * mult, resolution);
+      result = reg->value;
+  }
+  result *= reg->scale;
+  if (reg->divisor > 1) {
+    // round half away from zero
+    const int64_t half = reg->divisor / 2;
+    result = (result + (result < 0 ? -half : half)) / reg->divisor;
   }
   return result;
 }
 
+size_t Growatt::FormatScaled(char* buffer, int64_t scaled, uint8_t decimals) {
+  /**
+   * @brief Format a fixed-point value with exactly `decimals` digits after
+   * the decimal point, e.g. 2301 with 1 decimal -> "230.1". All outputs use
+   * this, so a register reads the same everywhere.
+   * @param buffer receives the zero terminated text, SCALED_TEXT_SIZE chars
+   * @param scaled the fixed-point value, see GetRegScaled()
+   * @param decimals digits after the decimal point
+   * @returns length of the text
+   */
+  char digits[20];
+  uint8_t count = 0;
+  uint64_t magnitude = scaled < 0 ? -(uint64_t)scaled : scaled;
+  // 64 bit divisions are expensive on the ESP8266, most values fit in 32 bit
+  while (magnitude > UINT32_MAX) {
+    digits[count++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  }
+  uint32_t remaining = magnitude;
+  do {
+    digits[count++] = '0' + remaining % 10;
+    remaining /= 10;
+  } while (remaining > 0 || count <= decimals);
+
+  size_t length = 0;
+  if (scaled < 0) buffer[length++] = '-';
+  while (count > 0) {
+    buffer[length++] = digits[--count];
+    if (count == decimals && count > 0) buffer[length++] = '.';
+  }
+  buffer[length] = '\0';
+  return length;
+}
+
+size_t Growatt::FormatRegValue(sGrowattModbusReg_t* reg, char* buffer) {
+  return FormatScaled(buffer, GetRegScaled(reg), reg->decimals);
+}
+
+const char* Growatt::GetRegLabel(sGrowattModbusReg_t* reg) {
+  /**
+   * @brief Label of the current value of an enum register, e.g. "Normal
+   * Operation" for the inverter status
+   * @param reg the register
+   * @returns PROGMEM string, NULL if the register or the value has no label
+   */
+  if (reg->labels == NULL) return NULL;
+  sGrowattLabelTable_t table;
+  memcpy_P(&table, reg->labels, sizeof(table));
+  if (reg->value >= table.count) return NULL;
+  return (const char*)pgm_read_ptr(&table.labels[reg->value]);
+}
+
+double Growatt::ScaledToDouble(int64_t scaled, uint8_t decimals) {
+  static const double powers[] = {1, 10, 100, 1000};
+  return decimals == 0 ? scaled : scaled / powers[decimals];
+}
+
+double Growatt::GetRegValue(sGrowattModbusReg_t* reg) {
+  return ScaledToDouble(GetRegScaled(reg), reg->decimals);
+}
+
 bool Growatt::GetSingleValueByName(const String& name, double& value) {
-  for (int i = 0; i < _Protocol.InputRegisterCount; i++) {
-    if (name.equalsIgnoreCase(_Protocol.InputRegisters[i].name)) {
-      value = getRegValue(&_Protocol.InputRegisters[i]);
-      return true;
-    }
+  bool holding;
+  uint16_t index;
+  if (!FindRegister(name, holding, index)) return false;
+  sGrowattModbusReg_t reg = GetRegister(holding, index);
+  value = GetRegValue(&reg);
+  return true;
+}
+
+bool Growatt::GetSingleValueByName(const String& name, char* value) {
+  /**
+   * @brief Get the formatted value of a register, see FormatScaled()
+   * @param name name of the register
+   * @param value receives the text, SCALED_TEXT_SIZE chars
+   * @returns false if there is no register of that name
+   */
+  bool holding;
+  uint16_t index;
+  if (!FindRegister(name, holding, index)) return false;
+  sGrowattModbusReg_t reg = GetRegister(holding, index);
+  FormatRegValue(&reg, value);
+  return true;
+}
+
+// Integer registers are stored as numbers, ArduinoJson prints them like
+// FormatScaled(). Others are stored as preformatted text.
+template <typename T>
+static void setScaledValue(T&& dst, int64_t scaled, uint8_t decimals) {
+  if (decimals == 0 && scaled >= INT32_MIN && scaled <= INT32_MAX) {
+    dst.set((int32_t)scaled);
+  } else {
+    char buffer[SCALED_TEXT_SIZE];
+    const size_t length = Growatt::FormatScaled(buffer, scaled, decimals);
+    dst.set(serialized(buffer, length));  // char* is copied into the pool
   }
-  for (int i = 0; i < _Protocol.HoldingRegisterCount; i++) {
-    if (name.equalsIgnoreCase(_Protocol.HoldingRegisters[i].name)) {
-      value = getRegValue(&_Protocol.HoldingRegisters[i]);
-      return true;
-    }
+}
+
+void Growatt::SampleSystem(sGrowattSystemSample_t& sample) {
+  /**
+   * @brief Sample the values of the stick for WriteJson(). A length
+   * measuring and a writing pass share the sample, so their text matches.
+   */
+  sample.now = millis();
+  sample.rssi = WiFi.RSSI();
+  sample.heapFree = ESP.getFreeHeap();
+#ifdef ESP32
+  sample.heapSize = ESP.getHeapSize();
+  sample.heapMaxAlloc = ESP.getMaxAllocHeap();
+  sample.heapMinFree = ESP.getMinFreeHeap();
+  sample.heapFragmentation =
+      100 - (100 * ESP.getMaxAllocHeap() / ESP.getFreeHeap());
+#else
+  static uint32_t heap_min_free = ESP.getFreeHeap();
+  heap_min_free = min(ESP.getFreeHeap(), heap_min_free);
+  sample.heapSize = 0;
+  sample.heapMaxAlloc = ESP.getMaxFreeBlockSize();
+  sample.heapMinFree = heap_min_free;
+  sample.heapFragmentation = ESP.getHeapFragmentation();
+#endif
+}
+
+// a number member, formatted like setScaledValue() stores it
+static void writeScaled(JsonWriter& json, const char* key, int64_t scaled,
+                        uint8_t decimals = 0) {
+  char buffer[SCALED_TEXT_SIZE];
+  Growatt::FormatScaled(buffer, scaled, decimals);
+  json.Key(key);
+  json.Raw(buffer);
+}
+
+uint16_t Growatt::jsonValueSlot(uint16_t slot, uint32_t now) {
+  /**
+   * @brief A JSON document keeps the position of the first register of a
+   * name and the value of the last one. Register maps may repeat names.
+   * @returns slot whose value is written under the name of slot, 0xFFFF if
+   * the name was already written
+   */
+  if (!_DuplicateNames) return slot;
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  uint16_t value = slot;
+  for (uint16_t other = 0; other < count; other++) {
+    if (other == slot || strcmp(_Names[other], _Names[slot]) != 0) continue;
+    const bool holding = other >= _Protocol.InputRegisterCount;
+    const uint16_t index =
+        holding ? other - _Protocol.InputRegisterCount : other;
+    if (!IsValueValid(holding, index, now)) continue;
+    if (other < slot) return 0xFFFF;
+    value = other;
   }
-  return false;
+  return value;
 }
 
-void Growatt::CreateJson(JsonDocument& doc, const String& MacAddress,
-                         const String& Hostname) {
+void Growatt::WriteJson(Print& out, const String& MacAddress,
+                        const String& Hostname,
+                        const sGrowattSystemSample_t& sample,
+                        const RegisterSelection* selection) {
+  /**
+   * @brief Write the values as JSON object straight from the register
+   * tables, the output of /status and MQTT
+   * @param out destination, e.g. a buffered client or a LengthPrint
+   * @param Hostname left out if empty
+   * @param sample values of the stick, see SampleSystem()
+   * @param selection registers to write, NULL for all. The values of the
+   * stick are only written along with the diagnostics group.
+   */
+  const uint32_t start = micros();
+  JsonWriter json(out);
+  json.BeginObject();
   if (!Hostname.isEmpty()) {
-    doc["Hostname"] = Hostname;
+    json.Key("Hostname");
+    json.Text(Hostname.c_str());
   }
+#if NUM_INVERTERS > 1
+  writeScaled(json, "Inverter", _InverterId);
+#endif
 #if SIMULATE_INVERTER != 1
-  for (int i = 0; i < _Protocol.InputRegisterCount; i++)
-    doc[_Protocol.InputRegisters[i].name] =
-        getRegValue(&_Protocol.InputRegisters[i]);
-
-  for (int i = 0; i < _Protocol.HoldingRegisterCount; i++)
-    doc[_Protocol.HoldingRegisters[i].name] =
-        getRegValue(&_Protocol.HoldingRegisters[i]);
+  // values of failed polls are left out once they are too old
+  const uint32_t now = sample.now;
+  uint32_t oldestRead = now;
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  for (uint16_t slot = 0; slot < count; slot++) {
+    const bool holding = slot >= _Protocol.InputRegisterCount;
+    const uint16_t index =
+        holding ? slot - _Protocol.InputRegisterCount : slot;
+    if (selection != NULL && !selection->Contains(slot)) continue;
+    if (!IsValueValid(holding, index, now)) continue;
+    const uint32_t read = GetRegisterCadence(holding, index).LastRead;
+    if ((int32_t)(read - oldestRead) < 0) oldestRead = read;
+
+    const uint16_t valueSlot = jsonValueSlot(slot, now);
+    if (valueSlot == 0xFFFF) continue;
+    const bool valueHolding = valueSlot >= _Protocol.InputRegisterCount;
+    sGrowattModbusReg_t reg = GetRegister(
+        valueHolding,
+        valueHolding ? valueSlot - _Protocol.InputRegisterCount : valueSlot);
+    writeScaled(json, _Names[slot], GetRegScaled(&reg), reg.decimals);
+#if PUBLISH_VALUE_LABELS == 1
+    jsonAddLabel(json, _Names[slot], &reg);
+#endif
+  }
+  writeScaled(json, "DataAgeMs", now - oldestRead);
+  json.Key("Stale");
+  json.Raw(_GotData ? "false" : "true");
 #else
 #warning simulating the inverter
-  doc["Status"] = 1;
-  doc["DcPower"] = 230;
-  doc["DcVoltage"] = 70.5;
-  doc["DcInputCurrent"] = 8.5;
-  doc["AcFreq"] = 50.00;
-  doc["AcVoltage"] = 230.0;
-  doc["AcPower"] = 0.00;
-  doc["EnergyToday"] = 0.3;
-  doc["EnergyTotal"] = 49.1;
-  doc["OperatingTime"] = 123456;
-  doc["Temperature"] = 21.12;
-  doc["AccumulatedEnergy"] = 320;
+  writeScaled(json, "Status", 1);
+  writeScaled(json, "DcPower", 230);
+  writeScaled(json, "DcVoltage", 705, 1);
+  writeScaled(json, "DcInputCurrent", 85, 1);
+  writeScaled(json, "AcFreq", 50);
+  writeScaled(json, "AcVoltage", 230);
+  writeScaled(json, "AcPower", 0);
+  writeScaled(json, "EnergyToday", 3, 1);
+  writeScaled(json, "EnergyTotal", 491, 1);
+  writeScaled(json, "OperatingTime", 123456);
+  writeScaled(json, "Temperature", 2112, 2);
+  writeScaled(json, "AccumulatedEnergy", 320);
 #endif  // SIMULATE_INVERTER
-  doc["Mac"] = MacAddress;
-  doc["Cnt"] = _PacketCnt;
-  doc["Uptime"] = millis() / 1000;
-  doc["WifiRSSI"] = WiFi.RSSI();
-  doc["HeapFree"] = ESP.getFreeHeap();
+  json.Key("Mac");
+  json.Text(MacAddress.c_str());
+  if (selection == NULL || selection->HasGroup(GroupDiagnostics)) {
+    writeScaled(json, "Cnt", _PacketCnt);
+    writeScaled(json, "Uptime", sample.now / 1000);
+    writeScaled(json, "WifiRSSI", sample.rssi);
+    writeScaled(json, "HeapFree", sample.heapFree);
 #ifdef ESP32
-  doc["HeapSize"] = ESP.getHeapSize();
-  doc["HeapMaxAlloc"] = ESP.getMaxAllocHeap();
-  doc["HeapMinFree"] = ESP.getMinFreeHeap();
-  doc["HeapFragmentation"] =
-      100 - (100 * ESP.getMaxAllocHeap() / ESP.getFreeHeap());
-#else
-  static uint32_t heap_min_free = ESP.getFreeHeap();
-  heap_min_free = min(ESP.getFreeHeap(), heap_min_free);
-  doc["HeapMaxAlloc"] = ESP.getMaxFreeBlockSize();
-  doc["HeapMinFree"] = heap_min_free;
-  doc["HeapFragmentation"] = ESP.getHeapFragmentation();
+    writeScaled(json, "HeapSize", sample.heapSize);
 #endif
+    writeScaled(json, "HeapMaxAlloc", sample.heapMaxAlloc);
+    writeScaled(json, "HeapMinFree", sample.heapMinFree);
+    writeScaled(json, "HeapFragmentation", sample.heapFragmentation);
+  }
+  json.EndObject();
+  _SerializeMicros[OutputStatus] = micros() - start;
+}
 
-  if (doc.overflowed()) {
-    Log.println(
-        F("WARN CreateJson: JsonDocument overflowed! Output will be "
-          "truncated."));
+#if PUBLISH_VALUE_LABELS == 1
+void Growatt::jsonAddLabel(JsonWriter& json, const char* name,
+                           sGrowattModbusReg_t* reg) {
+  const char* label = GetRegLabel(reg);
+  if (label != NULL) {
+    json.Key(name, "Label");
+    json.TextP(label);
   }
 }
+#endif
+
+// the UI shows the label of an enum register in parentheses instead of a unit
+static void addUILabel(JsonArray& arr, const char* label) {
+  char text[GROWATT_LABEL_SIZE + 2];
+  text[0] = '(';
+  strncpy_P(text + 1, label, GROWATT_LABEL_SIZE - 1);
+  text[GROWATT_LABEL_SIZE] = '\0';
+  strcat(text, ")");
+  arr.add(text);  // char* is copied into the pool
+}
+
+// units of the UI, indexed by RegisterUnit_t
+static const char* const UI_UNITS[] = {"",   "W",  "kWh", "V",  "A",
+                                       "s",  "%",  "Hz",  "°C", "VA",
+                                       "mA", "kOhm", "var"};
+
+#if SIMULATE_INVERTER == 1
+// the values CreateUIJson() simulates
+static const struct {
+  const char* name;
+  const char* unit;
+  const char* value;
+} SIMULATED_UI[] = {
+    {"Status", "(Normal Operation)", "1"}, {"DcPower", "W", "230"},
+    {"DcVoltage", "V", "70.5"},           {"DcInputCurrent", "A", "8.5"},
+    {"AcFreq", "Hz", "50"},               {"AcVoltage", "V", "230"},
+    {"AcPower", "W", "0"},                {"EnergyToday", "kWh", "0.3"},
+    {"EnergyTotal", "kWh", "49.1"},       {"OperatingTime", "s", "123456"},
+    {"Temperature", "C", "21.12"},        {"AccumulatedEnergy", "kWh", "320"}};
+#endif
 
 void Growatt::CreateUIJson(JsonDocument& doc, const String& Hostname) {
+  const uint32_t start = micros();
 #if SIMULATE_INVERTER != 1
-  const char* unitStr[] = {"",   "W",  "kWh", "V",  "A",    "s",  "%",
-                           "Hz", "°C", "VA",  "mA", "kOhm", "var"};
-  const char* statusStr[] = {"(Waiting)", "(Normal Operation)", "", "(Error)"};
-  const int statusStrLength = sizeof(statusStr) / sizeof(char*);
-  const char* priorityStr[] = {"(Load First)", "(Battery First)",
-                               "(Grid First)"};
-  const int priorityStrLength = sizeof(priorityStr) / sizeof(char*);
-  const char* bdcModeStr[] = {"(idle)", "(charging)", "(discharging)"};
-  const int bdcModeStrLength = sizeof(bdcModeStr) / sizeof(char*);
+  const char* const* unitStr = UI_UNITS;
 
   if (!Hostname.isEmpty()) {
     JsonArray arr = doc.createNestedArray("Hostname");
@@ -535,46 +1764,45 @@ void Growatt::CreateUIJson(JsonDocument& doc, const String& Hostname) {
   }
 
   for (int i = 0; i < _Protocol.InputRegisterCount; i++) {
-    if (_Protocol.InputRegisters[i].frontend == true ||
-        _Protocol.InputRegisters[i].plot == true) {
-      JsonArray arr = doc.createNestedArray(_Protocol.InputRegisters[i].name);
-
-      // value
-      arr.add(getRegValue(&_Protocol.InputRegisters[i]));
-
-      if ((String(_Protocol.InputRegisters[i].name) == F("InverterStatus") ||
-           String(_Protocol.InputRegisters[i].name) == F("BDCSysState")) &&
-          _Protocol.InputRegisters[i].value < statusStrLength) {
-        arr.add(statusStr[_Protocol.InputRegisters[i].value]);  // use unit for
-                                                                // status
-      } else if (String(_Protocol.InputRegisters[i].name) == F("BDCSysMode") &&
-                 _Protocol.InputRegisters[i].value < bdcModeStrLength) {
-        arr.add(bdcModeStr[_Protocol.InputRegisters[i].value]);
-      } else if (String(_Protocol.InputRegisters[i].name) == F("Priority") &&
-                 _Protocol.InputRegisters[i].value < priorityStrLength) {
-        arr.add(priorityStr[_Protocol.InputRegisters[i].value]);
+    sGrowattModbusReg_t reg = GetRegister(false, i);
+    if (reg.frontend == true || reg.plot == true) {
+      const char* name = registerName(false, i);
+      JsonArray arr = doc.createNestedArray(name);
+
+      // value, null once it is too old
+      JsonVariant value = arr.add();
+      if (IsValueValid(false, i, _PublishTime)) {
+        setScaledValue(value, GetRegScaled(&reg), reg.decimals);
+      }
+
+      const char* label = GetRegLabel(&reg);
+      if (label != NULL) {
+        addUILabel(arr, label);  // use unit for the label
       } else {
-        arr.add(unitStr[_Protocol.InputRegisters[i].unit]);  // unit
+        arr.add(unitStr[reg.unit]);  // unit
       }
-      arr.add(_Protocol.InputRegisters[i].plot);  // should be plotted
+      arr.add(reg.plot);  // should be plotted
     }
   }
   for (int i = 0; i < _Protocol.HoldingRegisterCount; i++) {
-    if (_Protocol.HoldingRegisters[i].frontend == true ||
-        _Protocol.HoldingRegisters[i].plot == true) {
-      JsonArray arr = doc.createNestedArray(_Protocol.HoldingRegisters[i].name);
-
-      // value
-      arr.add(getRegValue(&_Protocol.HoldingRegisters[i]));
+    sGrowattModbusReg_t reg = GetRegister(true, i);
+    if (reg.frontend == true || reg.plot == true) {
+      const char* name = registerName(true, i);
+      JsonArray arr = doc.createNestedArray(name);
+
+      // value, null once it is too old
+      JsonVariant value = arr.add();
+      if (IsValueValid(true, i, _PublishTime)) {
+        setScaledValue(value, GetRegScaled(&reg), reg.decimals);
+      }
 
-      if (String(_Protocol.HoldingRegisters[i].name) == F("InverterStatus") &&
-          _Protocol.HoldingRegisters[i].value < statusStrLength) {
-        arr.add(statusStr[_Protocol.HoldingRegisters[i].value]);  // use unit
-                                                                  // for status
+      const char* label = GetRegLabel(&reg);
+      if (label != NULL) {
+        addUILabel(arr, label);  // use unit for the label
       } else {
-        arr.add(unitStr[_Protocol.HoldingRegisters[i].unit]);  // unit
+        arr.add(unitStr[reg.unit]);  // unit
       }
-      arr.add(_Protocol.HoldingRegisters[i].plot);  // should be plotted
+      arr.add(reg.plot);  // should be plotted
     }
   }
 #else
@@ -634,6 +1862,215 @@ void Growatt::CreateUIJson(JsonDocument& doc, const String& Hostname) {
         F("WARN CreateUIJson: JsonDocument overflowed! Output will be "
           "truncated."));
   }
+  recordJsonUsage(JsonUI, doc);
+  _SerializeMicros[OutputUI] = micros() - start;
+}
+
+bool Growatt::isUIField(uint16_t slot, sGrowattModbusReg_t& reg) {
+  /**
+   * @brief Check if a register is shown in the web UI
+   * @param slot slot of the register, input registers first
+   * @param reg receives the register
+   * @returns true if it is shown as value or in the chart
+   */
+  const bool holding = slot >= _Protocol.InputRegisterCount;
+  reg = GetRegister(holding,
+                    holding ? slot - _Protocol.InputRegisterCount : slot);
+  return reg.frontend == true || reg.plot == true;
+}
+
+bool Growatt::isUIValueValid(uint16_t slot) {
+  /**
+   * @brief Check the age of a value of the web UI. It is judged at the time
+   * of the last PublishValues(), so the UI outputs only change along with
+   * the generation their responses and events are keyed on.
+   * @param slot slot of the register, input registers first
+   * @returns true if the value is shown, false if it is sent as null
+   */
+  const bool holding = slot >= _Protocol.InputRegisterCount;
+  return IsValueValid(holding,
+                      holding ? slot - _Protocol.InputRegisterCount : slot,
+                      _PublishTime);
+}
+
+void Growatt::WriteUIMeta(Print& out, const String& Hostname) {
+  /**
+   * @brief Write what the web UI needs to show the values of
+   * WriteUIValues(): the names, units, plot flags and the label tables of
+   * the fields. It only changes with the protocol.
+   * @param Hostname left out if empty
+   */
+  const uint32_t start = micros();
+  JsonWriter json(out);
+  json.BeginObject();
+  json.Key("Protocol");
+  json.Raw(String(_ProtocolVersion).c_str());
+  if (!Hostname.isEmpty()) {
+    json.Key("Hostname");
+    json.Text(Hostname.c_str());
+  }
+#if SIMULATE_INVERTER != 1
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  sGrowattModbusReg_t reg;
+  json.Key("Names");
+  json.BeginArray();
+  for (uint16_t slot = 0; slot < count; slot++) {
+    if (!isUIField(slot, reg)) continue;
+    json.Element();
+    json.Text(_Names[slot]);
+  }
+  json.EndArray();
+  json.Key("Units");
+  json.BeginArray();
+  for (uint16_t slot = 0; slot < count; slot++) {
+    if (!isUIField(slot, reg)) continue;
+    json.Element();
+    json.Text(UI_UNITS[reg.unit]);
+  }
+  json.EndArray();
+  json.Key("Plot");
+  json.BeginArray();
+  for (uint16_t slot = 0; slot < count; slot++) {
+    if (!isUIField(slot, reg)) continue;
+    json.Element();
+    json.Raw(reg.plot ? "true" : "false");
+  }
+  json.EndArray();
+  // the label of a value is shown instead of the unit
+  json.Key("Labels");
+  json.BeginArray();
+  for (uint16_t slot = 0; slot < count; slot++) {
+    if (!isUIField(slot, reg)) continue;
+    json.Element();
+    if (reg.labels == NULL) {
+      json.Raw("null");
+      continue;
+    }
+    sGrowattLabelTable_t table;
+    memcpy_P(&table, reg.labels, sizeof(table));
+    json.BeginArray();
+    for (uint8_t i = 0; i < table.count; i++) {
+      const char* label = (const char*)pgm_read_ptr(&table.labels[i]);
+      json.Element();
+      if (label != NULL) {
+        json.TextP(label);
+      } else {
+        json.Raw("null");
+      }
+    }
+    json.EndArray();
+  }
+  json.EndArray();
+#else
+  const char* keys[] = {"Names", "Units", "Plot", "Labels"};
+  for (uint8_t k = 0; k < 4; k++) {
+    json.Key(keys[k]);
+    json.BeginArray();
+    for (auto field : SIMULATED_UI) {
+      json.Element();
+      if (k == 0) json.Text(field.name);
+      if (k == 1) json.Text(field.unit);
+      if (k == 2) json.Raw("false");
+      if (k == 3) json.Raw("null");
+    }
+    json.EndArray();
+  }
+#endif
+  json.EndObject();
+  _SerializeMicros[OutputUIMeta] = micros() - start;
+}
+
+void Growatt::WriteUIValues(Print& out) {
+  /**
+   * @brief Write the values of the web UI as array, in the order of the
+   * fields of WriteUIMeta()
+   */
+  const uint32_t start = micros();
+  JsonWriter json(out);
+  json.BeginArray();
+#if SIMULATE_INVERTER != 1
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  sGrowattModbusReg_t reg;
+  char buffer[SCALED_TEXT_SIZE];
+  for (uint16_t slot = 0; slot < count; slot++) {
+    if (!isUIField(slot, reg)) continue;
+    json.Element();
+    if (!isUIValueValid(slot)) {
+      json.Raw("null");
+      continue;
+    }
+    FormatScaled(buffer, GetRegScaled(&reg), reg.decimals);
+    json.Raw(buffer);
+  }
+#else
+  for (auto field : SIMULATED_UI) {
+    json.Element();
+    json.Raw(field.value);
+  }
+#endif
+  json.EndArray();
+  _SerializeMicros[OutputUIValues] = micros() - start;
+}
+
+void Growatt::WriteUIChanges(Print& out) {
+  /**
+   * @brief Write the values of the web UI that changed since
+   * MarkUIValuesSent() as array of [field, value] pairs, all of them
+   * before the first call. The field is the position in WriteUIValues().
+   */
+  JsonWriter json(out);
+  json.BeginArray();
+#if SIMULATE_INVERTER != 1
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  sGrowattModbusReg_t reg;
+  char buffer[SCALED_TEXT_SIZE];
+  uint16_t field = 0;
+  for (uint16_t slot = 0; slot < count; slot++) {
+    if (!isUIField(slot, reg)) continue;
+    const bool valid = isUIValueValid(slot);
+    if (_UIValues == NULL || _UIValid[slot] != valid ||
+        (valid && _UIValues[slot] != reg.value)) {
+      json.Element();
+      json.BeginArray();
+      json.Element();
+      json.Raw(String(field).c_str());
+      json.Element();
+      if (valid) {
+        FormatScaled(buffer, GetRegScaled(&reg), reg.decimals);
+        json.Raw(buffer);
+      } else {
+        json.Raw("null");
+      }
+      json.EndArray();
+    }
+    field++;
+  }
+#endif
+  json.EndArray();
+}
+
+void Growatt::MarkUIValuesSent() {
+  /**
+   * @brief Remember the current values as the ones the web UI has, see
+   * WriteUIChanges()
+   */
+  const uint16_t count =
+      _Protocol.InputRegisterCount + _Protocol.HoldingRegisterCount;
+  // allocated on the first use, compared on the raw values
+  if (_UIValues == NULL) {
+    _UIValues = new uint32_t[count];
+    _UIValid = new bool[count];
+  }
+  for (uint16_t slot = 0; slot < count; slot++) {
+    const bool holding = slot >= _Protocol.InputRegisterCount;
+    _UIValues[slot] =
+        holding ? _Protocol.HoldingValues[slot - _Protocol.InputRegisterCount]
+                : _Protocol.InputValues[slot];
+    _UIValid[slot] = isUIValueValid(slot);
+  }
 }
 
 void Growatt::camelCaseToSnakeCase(const String& input, char* output) {
@@ -649,72 +2086,292 @@ void Growatt::camelCaseToSnakeCase(const String& input, char* output) {
   output[outputIndex] = '\0';
 }
 
-void Growatt::metricsAddValue(const String& name, const double& value,
-                              const float& resolution, String& metrics,
+#if PUBLISH_VALUE_LABELS == 1
+void Growatt::metricsAddLabel(sGrowattModbusReg_t* reg, Print& metrics,
                               const String& labels) {
-  const String svalue =
-      (resolution == 1) ? String((int32_t)value) : String(value);
+  // info style metric, the label of the current value is a label
+  const char* label = GetRegLabel(reg);
+  if (label != NULL) {
+    metricsAddValue(String(reg->name) + F("Label"), 1, 0, metrics,
+                    labels + F(",label=\"") + FPSTR(label) + F("\""));
+  }
+}
+#endif
+
+void Growatt::metricsAddLine(const char* name, int64_t scaled,
+                             uint8_t decimals, Print& metrics,
+                             const String& labels, uint64_t timestamp) {
+  /**
+   * @brief Append a sample, piece by piece to avoid temporary Strings
+   * @param name metric name without the growatt_ prefix
+   * @param timestamp sample time in ms, 0 for none
+   */
+  char value[SCALED_TEXT_SIZE];
+  metrics.print(F("growatt_"));
+  metrics.print(name);
+  metrics.print('{');
+  metrics.print(labels);
+  metrics.print(F("} "));
+  FormatScaled(value, scaled, decimals);
+  metrics.print(value);
+  if (timestamp != 0) {
+    FormatScaled(value, timestamp, 0);
+    metrics.print(' ');
+    metrics.print(value);
+  }
+  metrics.print('\n');
+}
+
+void Growatt::metricsAddValue(const String& name, int64_t scaled,
+                              uint8_t decimals, Print& metrics,
+                              const String& labels, uint64_t timestamp) {
   char nameSnakeCase[name.length() + 10];
   camelCaseToSnakeCase(name, nameSnakeCase);
-  metrics +=
-      "growatt_" + String(nameSnakeCase) + "{" + labels + "} " + svalue + "\n";
+  metricsAddLine(nameSnakeCase, scaled, decimals, metrics, labels, timestamp);
+}
+
+void Growatt::metricsAddRegister(bool holding, uint16_t index, Print& metrics,
+                                 uint64_t timestamp) {
+  /**
+   * @brief Append the sample of a register with its precomputed name
+   * @param timestamp sample time in ms, 0 for none
+   */
+  const uint16_t slot = holding ? _Protocol.InputRegisterCount + index : index;
+  const char* name =
+      _MetricNamePool + (_MetricNames[slot] & ~METRIC_NAME_FIRST);
+#if NUM_INVERTERS == 1
+  // with several inverters the samples of a metric are not grouped, which
+  // the exposition format requires for # TYPE
+  if (_MetricNames[slot] & METRIC_NAME_FIRST) {
+    metrics.print(F("# TYPE growatt_"));
+    metrics.print(name);
+    metrics.print(F(" gauge\n"));
+  }
+#endif
+  sGrowattModbusReg_t reg = GetRegister(holding, index);
+  metricsAddLine(name, GetRegScaled(&reg), reg.decimals, metrics,
+                 _MetricLabels, timestamp);
 }
 
-void Growatt::CreateMetrics(String& metrics, const String& MacAddress,
-                            const String& Hostname) {
-  String labels;
+const String& Growatt::metricsLabels(const String& MacAddress,
+                                     const String& Hostname) {
+  /**
+   * @brief Labels of all metrics of the inverter, only rebuilt when the
+   * MAC address or hostname changed
+   * @returns the labels
+   */
+  if (MacAddress == _MetricLabelsMac && Hostname == _MetricLabelsHostname &&
+      !_MetricLabels.isEmpty()) {
+    return _MetricLabels;
+  }
+  _MetricLabelsMac = MacAddress;
+  _MetricLabelsHostname = Hostname;
   if (Hostname == DEFAULT_HOSTNAME) {
-    labels = "mac=\"" + MacAddress + "\"";
+    _MetricLabels = "mac=\"" + MacAddress + "\"";
   } else {
-    labels = "mac=\"" + MacAddress + "\",name=\"" + Hostname + "\"";
+    _MetricLabels = "mac=\"" + MacAddress + "\",name=\"" + Hostname + "\"";
+  }
+#if NUM_INVERTERS > 1
+  _MetricLabels += ",inverter=\"" + String(_InverterId) + "\"";
+#endif
+  return _MetricLabels;
+}
+
+void Growatt::metricsAddCadence(const sGrowattFragmentCadence_t& cadence,
+                                const char* type, uint16_t address,
+                                Print& metrics, const String& labels) {
+  const String fragmentLabels = labels + ",type=\"" + type +
+                                "\",fragment=\"" + String(address) + "\"";
+  metricsAddValue("FragmentUpdatePeriodMs", cadence.Period, 0, metrics,
+                  fragmentLabels);
+  metricsAddValue("FragmentUpdates", cadence.Changes, 0, metrics,
+                  fragmentLabels);
+  if (cadence.LastRead != 0) {
+    metricsAddValue("FragmentAgeMs", millis() - cadence.LastRead, 0, metrics,
+                    fragmentLabels);
   }
+}
+
+void Growatt::metricsAddBus(eBusClass_t busClass, Print& metrics,
+                            const String& labels) {
+  const String classLabels = labels + ",class=\"" +
+                             BusArbiter::GetClassName(busClass) + "\"";
+  metricsAddValue("BusJobs", _Bus.GetJobs(busClass), 0, metrics, classLabels);
+  metricsAddValue("BusRejected", _Bus.GetRejected(busClass), 0, metrics,
+                  classLabels);
+  metricsAddValue("BusTimeMs", _Bus.GetBusTime(busClass), 0, metrics,
+                  classLabels);
+  metricsAddValue("BusQueued", _Bus.GetQueued(busClass), 0, metrics,
+                  classLabels);
+}
+
+void Growatt::CreateMetrics(Print& metrics, const String& MacAddress,
+                            const String& Hostname,
+                            const RegisterSelection* selection) {
+  /**
+   * @brief Write the metrics in the Prometheus exposition format
+   * @param selection registers to write, NULL for all. The metrics of the
+   * stick are only written along with the diagnostics group.
+   */
+  const uint32_t start = micros();
+  const String& labels = metricsLabels(MacAddress, Hostname);
+  const bool diagnostics =
+      selection == NULL || selection->HasGroup(GroupDiagnostics);
 #if SIMULATE_INVERTER != 1
-  for (int i = 0; i < _Protocol.InputRegisterCount; i++)
-    metricsAddValue(_Protocol.InputRegisters[i].name,
-                    getRegValue(&_Protocol.InputRegisters[i]),
-                    _Protocol.InputRegisters[i].resolution, metrics, labels);
+  // samples carry the time they were read, too old ones are left out
+  const uint32_t now = millis();
+  for (int i = 0; i < _Protocol.InputRegisterCount; i++) {
+    if (selection != NULL && !selection->Contains(i)) continue;
+    if (!IsValueValid(false, i, now)) continue;
+    metricsAddRegister(false, i, metrics,
+                       GetRegisterCadence(false, i).LastReadTime);
+#if PUBLISH_VALUE_LABELS == 1
+    sGrowattModbusReg_t reg = GetRegister(false, i);
+    metricsAddLabel(&reg, metrics, labels);
+#endif
+  }
+
+  for (int i = 0; i < _Protocol.HoldingRegisterCount; i++) {
+    if (selection != NULL &&
+        !selection->Contains(_Protocol.InputRegisterCount + i)) {
+      continue;
+    }
+    if (!IsValueValid(true, i, now)) continue;
+    metricsAddRegister(true, i, metrics,
+                       GetRegisterCadence(true, i).LastReadTime);
+#if PUBLISH_VALUE_LABELS == 1
+    sGrowattModbusReg_t reg = GetRegister(true, i);
+    metricsAddLabel(&reg, metrics, labels);
+#endif
+  }
 
-  for (int i = 0; i < _Protocol.HoldingRegisterCount; i++)
-    metricsAddValue(_Protocol.HoldingRegisters[i].name,
-                    getRegValue(&_Protocol.HoldingRegisters[i]),
-                    _Protocol.HoldingRegisters[i].resolution, metrics, labels);
+  // learned update periods of the inverter per fragment
+  for (int i = 0; diagnostics && i < _Protocol.InputFragmentCount; i++)
+    metricsAddCadence(_SnapshotInputCadence[i], "input",
+                      GetFragment(false, i).StartAddress, metrics, labels);
+  for (int i = 0; diagnostics && i < _Protocol.HoldingFragmentCount; i++)
+    metricsAddCadence(_SnapshotHoldingCadence[i], "holding",
+                      GetFragment(true, i).StartAddress, metrics, labels);
 
 #else
 #warning simulating the inverter
-  metricsAddValue("Status", 1, 1, metrics, labels);
-  metricsAddValue("DcPower", 230, 0.1, metrics, labels);
-  metricsAddValue("DcVoltage", 70.5, 0.1, metrics, labels);
-  metricsAddValue("DcInputCurrent", 8.5, 0.1, metrics, labels);
-  metricsAddValue("AcFreq", 50.00, 0.01, metrics, labels);
-  metricsAddValue("AcVoltage", 230.0, 0.1, metrics, labels);
-  metricsAddValue("AcPower", 0.0, 0.1, metrics, labels);
-  metricsAddValue("EnergyToday", 0.3, 0.1, metrics, labels);
-  metricsAddValue("EnergyTotal", 49.1, 0.1, metrics, labels);
-  metricsAddValue("OperatingTime", 123456, 0.1, metrics, labels);
-  metricsAddValue("Temperature", 21.12, 0.1, metrics, labels);
-  metricsAddValue("AccumulatedEnergy", 320, 0.1, metrics, labels);
+  metricsAddValue("Status", 1, 0, metrics, labels);
+  metricsAddValue("DcPower", 2300, 1, metrics, labels);
+  metricsAddValue("DcVoltage", 705, 1, metrics, labels);
+  metricsAddValue("DcInputCurrent", 85, 1, metrics, labels);
+  metricsAddValue("AcFreq", 5000, 2, metrics, labels);
+  metricsAddValue("AcVoltage", 2300, 1, metrics, labels);
+  metricsAddValue("AcPower", 0, 1, metrics, labels);
+  metricsAddValue("EnergyToday", 3, 1, metrics, labels);
+  metricsAddValue("EnergyTotal", 491, 1, metrics, labels);
+  metricsAddValue("OperatingTime", 123456, 0, metrics, labels);
+  metricsAddValue("Temperature", 211, 1, metrics, labels);
+  metricsAddValue("AccumulatedEnergy", 320, 0, metrics, labels);
 #endif  // SIMULATE_INVERTER
-  metricsAddValue("Cnt", _PacketCnt, 1, metrics, labels);
-  metricsAddValue("Uptime", millis() / 1000, 1, metrics, labels);
-  metricsAddValue("WifiRSSI", WiFi.RSSI(), 1, metrics, labels);
+  if (!diagnostics) {
+    _SerializeMicros[OutputMetrics] = micros() - start;
+    return;
+  }
+  metricsAddValue("Cnt", _PacketCnt, 0, metrics, labels);
+  // time of the previous run for the metrics themselves
+  const char* outputs[OutputCount] = {"status", "ui", "ui_meta", "ui_values",
+                                      "metrics"};
+  for (uint8_t o = 0; o < OutputCount; o++) {
+    metricsAddValue("SerializeMicros", _SerializeMicros[o], 0, metrics,
+                    labels + ",output=\"" + outputs[o] + "\"");
+  }
+#if GZIP_RESPONSES == 1 && defined(ESP32)
+  for (uint8_t o = 0; o < OutputCount; o++) {
+    const String outputLabels = labels + ",output=\"" + outputs[o] + "\"";
+    metricsAddValue("GzipInputBytes", _GzipInput[o], 0, metrics, outputLabels);
+    metricsAddValue("GzipOutputBytes", _GzipOutput[o], 0, metrics,
+                    outputLabels);
+    metricsAddValue("GzipMicros", _GzipMicros[o], 0, metrics, outputLabels);
+  }
+#endif
+  // headroom of the last JSON documents
+  const char* documents[JsonCount] = {"ui", "command"};
+  for (uint8_t d = 0; d < JsonCount; d++) {
+    const String documentLabels =
+        labels + ",document=\"" + documents[d] + "\"";
+    metricsAddValue("JsonCapacity", _JsonLastCapacity[d], 0, metrics,
+                    documentLabels);
+    metricsAddValue("JsonUsage", _JsonLastUsage[d], 0, metrics,
+                    documentLabels);
+  }
+  for (uint8_t c = 0; c < BusClassCount; c++) {
+    metricsAddBus((eBusClass_t)c, metrics, labels);
+  }
+#if ENABLE_CADENCE_TUNING != 1
+  metricsAddValue("PollTicks", _Scheduler.GetTicks(), 0, metrics, labels);
+  metricsAddValue("PollMissedTicks", _Scheduler.GetMissedTicks(), 0, metrics,
+                  labels);
+  metricsAddValue("PollAligned", _Scheduler.IsAligned(), 0, metrics, labels);
+#endif
+  metricsAddValue("Uptime", millis() / 1000, 0, metrics, labels);
+  metricsAddValue("WifiRSSI", WiFi.RSSI(), 0, metrics, labels);
 
-  metricsAddValue("HeapFree", ESP.getFreeHeap(), 1, metrics, labels);
+  metricsAddValue("HeapFree", ESP.getFreeHeap(), 0, metrics, labels);
 #ifdef ESP32
-  metricsAddValue("HeapSize", ESP.getHeapSize(), 1, metrics, labels);
-  metricsAddValue("HeapMaxAlloc", ESP.getMaxAllocHeap(), 1, metrics, labels);
-  metricsAddValue("HeapMinFree", ESP.getMinFreeHeap(), 1, metrics, labels);
+  metricsAddValue("HeapSize", ESP.getHeapSize(), 0, metrics, labels);
+  metricsAddValue("HeapMaxAlloc", ESP.getMaxAllocHeap(), 0, metrics, labels);
+  metricsAddValue("HeapMinFree", ESP.getMinFreeHeap(), 0, metrics, labels);
   metricsAddValue("HeapFragmentation",
-                  100 - (100 * ESP.getMaxAllocHeap() / ESP.getFreeHeap()), 1,
+                  100 - (100 * ESP.getMaxAllocHeap() / ESP.getFreeHeap()), 0,
                   metrics, labels);
 #else
   static uint32_t heap_min_free = ESP.getFreeHeap();
   heap_min_free = min(ESP.getFreeHeap(), heap_min_free);
-  metricsAddValue("HeapMaxAlloc", ESP.getMaxFreeBlockSize(), 1, metrics,
+  metricsAddValue("HeapMaxAlloc", ESP.getMaxFreeBlockSize(), 0, metrics,
                   labels);
-  metricsAddValue("HeapMinFree", heap_min_free, 1, metrics, labels);
-  metricsAddValue("HeapFragmentation", ESP.getHeapFragmentation(), 1, metrics,
+  metricsAddValue("HeapMinFree", heap_min_free, 0, metrics, labels);
+  metricsAddValue("HeapFragmentation", ESP.getHeapFragmentation(), 0, metrics,
                   labels);
 #endif
+  _SerializeMicros[OutputMetrics] = micros() - start;
+}
+
+void Growatt::RecordGzip(eGrowattOutput_t output, size_t input,
+                         size_t compressed, uint32_t duration) {
+  /**
+   * @brief Add a gzip compressed response to the totals in the metrics
+   * @param input size of the uncompressed body
+   * @param compressed size of the gzip stream
+   * @param duration µs to compress and send it
+   */
+  _GzipInput[output] += input;
+  _GzipOutput[output] += compressed;
+  _GzipMicros[output] += duration;
+}
+
+RegisterSelection::RegisterSelection() : _Bits(NULL), _Groups(0) {}
+
+RegisterSelection::~RegisterSelection() { delete[] _Bits; }
+
+SnapshotLock::SnapshotLock(Growatt* inverters, uint8_t count)
+    : _Inverters(inverters), _Count(count) {
+  // always in the same order, the poll tasks only take their own
+  for (uint8_t i = 0; i < _Count; i++) _Inverters[i].LockSnapshot();
+}
+
+SnapshotLock::~SnapshotLock() { Unlock(); }
+
+void SnapshotLock::Unlock() {
+  /**
+   * @brief Release the snapshots before the lock goes out of scope
+   */
+  for (uint8_t i = _Count; i > 0; i--) _Inverters[i - 1].UnlockSnapshot();
+  _Count = 0;
+}
+
+bool RegisterSelection::IsAll() const { return _Bits == NULL; }
+
+bool RegisterSelection::Contains(uint16_t slot) const {
+  return _Bits == NULL || (_Bits[slot / 32] & (1UL << (slot % 32))) != 0;
+}
+
+bool RegisterSelection::HasGroup(eGrowattGroup_t group) const {
+  return _Bits == NULL || (_Groups & group) != 0;
 }
 
 void Growatt::RegisterCommand(const String& command,
@@ -756,6 +2413,7 @@ void Growatt::HandleCommand(const String& command, const byte* payload,
   res["command"] = command;
   res["success"] = success;
   res["message"] = message;
+  recordJsonUsage(JsonCommand, res);
 }
 
 std::tuple<bool, String> Growatt::handleEcho(const JsonDocument& req,
@@ -848,6 +2506,29 @@ std::tuple<bool, String> Growatt::handleModbusGet(const JsonDocument& req,
   return std::make_tuple(true, "success");
 }
 
+std::tuple<bool, String> Growatt::handleValueGet(const JsonDocument& req,
+                                                 JsonDocument& res,
+                                                 Growatt& inverter) {
+  if (!req.containsKey("name")) {
+    return std::make_tuple(false, "'name' field is required");
+  }
+
+  bool holding;
+  uint16_t index;
+  if (!inverter.FindRegister(req["name"].as<String>(), holding, index)) {
+    return std::make_tuple(false, "Unknown register");
+  }
+  if (!inverter.IsValueValid(holding, index, millis())) {
+    return std::make_tuple(false, "Value expired");
+  }
+  sGrowattModbusReg_t reg = inverter.GetRegister(holding, index);
+  res["name"] = registerName(holding, index);
+  char value[SCALED_TEXT_SIZE];
+  inverter.FormatRegValue(&reg, value);
+  res["value"] = serialized(value);
+  return std::make_tuple(true, "success");
+}
+
 std::tuple<bool, String> Growatt::handleModbusSet(const JsonDocument& req,
                                                   JsonDocument& res,
                                                   Growatt& inverter) {
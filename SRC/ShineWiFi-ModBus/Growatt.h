@@ -1,8 +1,111 @@
 #pragma once
 #include "GrowattTypes.h"
 #include "Config.h"
+#include "PollScheduler.h"
+#include "BusArbiter.h"
+#include "RegisterMap.h"
+#include "JsonWriter.h"
+#include <ModbusMaster.h>
 #include <map>
 
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
+
+#ifndef GROWATT_MODBUS_VERSION
+#define GROWATT_MODBUS_VERSION 0
+#endif
+
+#ifndef NUM_INVERTERS
+#define NUM_INVERTERS 1
+#endif
+
+#ifndef ENABLE_CADENCE_TUNING
+#define ENABLE_CADENCE_TUNING 0
+#endif
+#ifndef CADENCE_MIN_INTERVAL
+#define CADENCE_MIN_INTERVAL 1000
+#endif
+#ifndef CADENCE_MAX_INTERVAL
+#define CADENCE_MAX_INTERVAL 60000
+#endif
+#ifndef POLL_ALIGN_TO_WALLCLOCK
+#define POLL_ALIGN_TO_WALLCLOCK 0
+#endif
+#ifndef MAX_VALUE_AGE
+#define MAX_VALUE_AGE 300000
+#endif
+#ifndef PUBLISH_VALUE_LABELS
+#define PUBLISH_VALUE_LABELS 0
+#endif
+#ifndef GZIP_RESPONSES
+#define GZIP_RESPONSES 0
+#endif
+#ifndef GZIP_MIN_SIZE
+#define GZIP_MIN_SIZE 1024
+#endif
+
+// text of a fixed-point value: sign, 20 digits, point, terminator
+#define SCALED_TEXT_SIZE 24
+
+// outputs whose serialization time and compression are measured
+typedef enum {
+  OutputStatus,    // WriteJson()
+  OutputUI,        // CreateUIJson()
+  OutputUIMeta,    // WriteUIMeta()
+  OutputUIValues,  // WriteUIValues()
+  OutputMetrics,   // CreateMetrics()
+  OutputCount
+} eGrowattOutput_t;
+
+// first register of a metric name, it gets the # TYPE line
+#define METRIC_NAME_FIRST 0x8000
+
+// JSON documents whose capacity is planned for the protocol
+typedef enum {
+  JsonUI,       // CreateUIJson()
+  JsonCommand,  // result of HandleCommand()
+  JsonCount
+} eGrowattJson_t;
+
+// longest strings copied into the documents besides the register values
+#define JSON_HOSTNAME_SIZE 31         // portal allows 30 characters
+#define JSON_COMMAND_MESSAGE_SIZE 96  // fixed texts of the handlers
+// largest result of the protocol commands, the battery/grid first settings
+// with three time slots holding two "HH:MM" strings each
+#define JSON_COMMAND_HANDLER_SIZE \
+  (JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(3) + 3 * JSON_OBJECT_SIZE(4) + 36)
+
+// values of the stick in the /status output
+typedef struct {
+  uint32_t now;  // millis()
+  int32_t rssi;
+  uint32_t heapFree;
+  uint32_t heapSize;  // ESP32 only
+  uint32_t heapMaxAlloc;
+  uint32_t heapMinFree;
+  uint32_t heapFragmentation;
+} sGrowattSystemSample_t;
+
+// Registers an output is restricted to, one bit per slot (input registers
+// first), see Growatt::Select(). A selection without bits is everything.
+class RegisterSelection {
+ public:
+  RegisterSelection();
+  ~RegisterSelection();
+  RegisterSelection(const RegisterSelection&) = delete;
+  RegisterSelection& operator=(const RegisterSelection&) = delete;
+  bool IsAll() const;
+  bool Contains(uint16_t slot) const;
+  bool HasGroup(eGrowattGroup_t group) const;
+
+ private:
+  friend class Growatt;
+  uint32_t* _Bits;  // NULL selects all registers
+  uint8_t _Groups;  // eGrowattGroup_t bits asked for
+};
+
 class Growatt {
  public:
   Growatt();
@@ -10,18 +113,52 @@ class Growatt {
   using CommandHandlerFunc = std::function<std::tuple<bool, String>(
       const JsonDocument& req, JsonDocument& res, Growatt& inverter)>;
 
-  void begin(Stream& serial);
-  void InitProtocol();
+  void begin(HardwareSerial& serial, int8_t rxPin = -1, int8_t txPin = -1);
+  bool InitProtocol(uint16_t version);
+  uint16_t GetProtocolVersion();
+  uint16_t DetectProtocol();
   void RegisterCommand(const String& command, CommandHandlerFunc handler);
   void HandleCommand(const String& command, const byte* payload,
                      const unsigned int length, JsonDocument& req,
                      JsonDocument& res);
-  bool ReadInputRegisters();
-  bool ReadHoldingRegisters();
-  bool ReadData();
+  static size_t GetCommandRequestCapacity(size_t length);
+  size_t GetCommandResultCapacity(const String& command, size_t length);
+  size_t GetJsonCapacity(eGrowattJson_t type);
+  JsonDocument& GetJsonDocument(eGrowattJson_t type);
+  bool ReadInputRegisters(bool retry = false);
+  bool ReadHoldingRegisters(bool retry = false);
+  bool ReadInputFragment(uint8_t fragment);
+  bool ReadHoldingFragment(uint8_t fragment);
+  bool ReadFragmentValues(bool holding, uint8_t fragment,
+                          const uint16_t* indexes, const bool* types,
+                          uint8_t count, uint32_t* values);
+  bool ReadData(bool retry = false);
+  void PublishValues();
+  void LockSnapshot();
+  void UnlockSnapshot();
+  uint32_t GetNextPollTime();
+  bool PollDue(uint32_t now);
+  bool QueueBusJob(eBusClass_t busClass, BusJob job);
+  void ServiceBus();
+  bool AcquireBus(eBusClass_t busClass);
+  void ReleaseBus(eBusClass_t busClass);
   eDevice_t GetWiFiStickType();
+  void SetInverterId(uint8_t id);
+  uint8_t GetInverterId();
   sGrowattModbusReg_t GetInputRegister(uint16_t reg);
   sGrowattModbusReg_t GetHoldingRegister(uint16_t reg);
+  sGrowattModbusReg_t GetRegister(bool holding, uint16_t index);
+  sGrowattReadFragment_t GetFragment(bool holding, uint8_t index);
+  bool FindRegister(const String& name, bool& holding, uint16_t& index);
+  static uint8_t ParseGroups(const String& list, String& unknown);
+  static const char* GetGroupName(uint8_t bit);
+  bool Select(RegisterSelection& selection, const String& groups,
+              const String& names, String& unknown);
+  bool HasValidValues();
+  uint32_t GetGeneration();
+  bool IsValueValid(bool holding, uint16_t index, uint32_t now);
+  const sGrowattFragmentCadence_t& GetRegisterCadence(bool holding,
+                                                      uint16_t index);
   bool ReadInputReg(uint16_t adr, uint32_t* result);
   bool ReadInputReg(uint16_t adr, uint16_t* result);
   bool ReadHoldingReg(uint16_t adr, uint32_t* result);
@@ -30,26 +167,128 @@ class Growatt {
   bool ReadHoldingRegFrag(uint16_t adr, uint8_t size, uint32_t* result);
   bool WriteHoldingReg(uint16_t adr, uint16_t value);
   bool WriteHoldingRegFrag(uint16_t adr, uint8_t size, uint16_t* value);
+  int64_t GetRegScaled(sGrowattModbusReg_t* reg);
+  static double ScaledToDouble(int64_t scaled, uint8_t decimals);
+  static size_t FormatScaled(char* buffer, int64_t scaled, uint8_t decimals);
+  size_t FormatRegValue(sGrowattModbusReg_t* reg, char* buffer);
+  const char* GetRegLabel(sGrowattModbusReg_t* reg);
+  double GetRegValue(sGrowattModbusReg_t* reg);
   bool GetSingleValueByName(const String& name, double& value);
-  void CreateJson(JsonDocument& doc, const String& MacAddress,
-                  const String& Hostname);
+  bool GetSingleValueByName(const String& name, char* value);
+  static void SampleSystem(sGrowattSystemSample_t& sample);
+  void WriteJson(Print& out, const String& MacAddress, const String& Hostname,
+                 const sGrowattSystemSample_t& sample,
+                 const RegisterSelection* selection = NULL);
   void CreateUIJson(JsonDocument& doc, const String& Hostname);
-  void CreateMetrics(String& metrics, const String& MacAddress,
-                     const String& Hostname);
+  void WriteUIMeta(Print& out, const String& Hostname);
+  void WriteUIValues(Print& out);
+  void WriteUIChanges(Print& out);
+  void MarkUIValuesSent();
+  void CreateMetrics(Print& metrics, const String& MacAddress,
+                     const String& Hostname,
+                     const RegisterSelection* selection = NULL);
+  void RecordGzip(eGrowattOutput_t output, size_t input, size_t compressed,
+                  uint32_t duration);
 
  private:
+  ModbusMaster _Modbus;
   eDevice_t _eDevice;
+  uint8_t _InverterId;
+  uint16_t _ProtocolVersion;
+  uint16_t* _NameIndex;  // slot + 1 of the register, 0 for an empty entry
+  uint16_t _NameIndexSize;
+  const char** _Names;  // JSON keys of all registers, input registers first
+  char* _NamePool;      // RAM copy of the names where flash is not readable
+  uint16_t* _MetricNames;  // offset in _MetricNamePool | METRIC_NAME_FIRST
+  char* _MetricNamePool;   // snake case names of the registers
+  String _MetricLabels;    // labels of all metrics, see metricsLabels()
+  String _MetricLabelsMac;
+  String _MetricLabelsHostname;
+  bool _DuplicateNames;  // a register map repeats a name
   bool _GotData;
   uint32_t _PacketCnt;
+  uint32_t _Generation;  // advances with every poll, see GetGeneration()
+  uint32_t _CycleStart;  // millis() of the first ReadData() of a poll cycle
+  uint32_t _PublishTime;  // millis() of the last PublishValues()
   std::map<String, CommandHandlerFunc> handlers;
+  PollScheduler _Scheduler;
+  BusArbiter _Bus;
+  // the polls read into these, PublishValues() copies them to the values of
+  // _Protocol and the snapshot of the cadence the outputs are built from
+  uint32_t* _PollInputValues;
+  uint32_t* _PollHoldingValues;
+  sGrowattFragmentCadence_t _InputCadence[MAX_READ_FRAGMENTS];
+  sGrowattFragmentCadence_t _HoldingCadence[MAX_READ_FRAGMENTS];
+  sGrowattFragmentCadence_t _SnapshotInputCadence[MAX_READ_FRAGMENTS];
+  sGrowattFragmentCadence_t _SnapshotHoldingCadence[MAX_READ_FRAGMENTS];
+#ifdef ESP32
+  SemaphoreHandle_t _SnapshotMutex;  // see LockSnapshot()
+#endif
+  uint8_t* _RegisterFragments;             // fragment of every register
+  uint8_t* _RegisterGroups;                // eGrowattGroup_t bits of it
+  uint32_t _SerializeMicros[OutputCount];  // duration of the last run
+  uint32_t _GzipInput[OutputCount];        // totals of the gzip responses
+  uint32_t _GzipOutput[OutputCount];
+  uint32_t _GzipMicros[OutputCount];
+  size_t _JsonCapacity[JsonCount];         // planned by InitProtocol()
+  size_t _JsonLastCapacity[JsonCount];     // capacity of the last document
+  size_t _JsonLastUsage[JsonCount];        // memory used by it
+  DynamicJsonDocument* _JsonDocument;      // UI, reused across requests
+  // raw values of the last MarkUIValuesSent() and whether they were valid
+  uint32_t* _UIValues;
+  bool* _UIValid;
+#if ENABLE_REGISTER_MAP_FILE == 1
+  RegisterMap _RegisterMap;
+#endif
 
   eDevice_t _InitModbusCommunication();
-  double roundByResolution(const double& value, const float& resolution);
-  double getRegValue(sGrowattModbusReg_t* reg);
+  void beginSerial(HardwareSerial& serial, uint32_t baud, int8_t rxPin,
+                   int8_t txPin);
+  uint32_t responseValue(RegisterSize_t size, uint16_t offset);
+  void buildNameIndex();
+  void internNames(bool namesInRam);
+  void mapRegisterFragments();
+  void mapRegisterGroups();
+  void buildMetricNames();
+  uint16_t jsonValueSlot(uint16_t slot, uint32_t now);
+  bool isUIField(uint16_t slot, sGrowattModbusReg_t& reg);
+  bool isUIValueValid(uint16_t slot);
+  const String& metricsLabels(const String& MacAddress,
+                              const String& Hostname);
+  void metricsAddLine(const char* name, int64_t scaled, uint8_t decimals,
+                      Print& metrics, const String& labels,
+                      uint64_t timestamp);
+  void metricsAddRegister(bool holding, uint16_t index, Print& metrics,
+                          uint64_t timestamp);
+  const char* registerName(bool holding, uint16_t index);
+  size_t valueTextSize(bool holding, uint16_t index);
+  void planJsonCapacity();
+  void recordJsonUsage(eGrowattJson_t type, const JsonDocument& doc);
+  bool fragmentFailed(const sGrowattFragmentCadence_t& cadence);
+  bool fragmentFailedInCycle(const sGrowattFragmentCadence_t& cadence);
+  bool fragmentsFailed();
+  bool fragmentsAttempted();
+  bool fragmentDue(const sGrowattFragmentCadence_t& cadence, uint32_t now);
+  uint32_t nextPollDeadline();
+  uint32_t fragmentNextPoll(const sGrowattFragmentCadence_t& cadence,
+                            uint32_t now);
+  void updateCadence(sGrowattFragmentCadence_t& cadence, uint8_t size,
+                     uint32_t now);
+  void metricsAddBus(eBusClass_t busClass, Print& metrics,
+                     const String& labels);
+  void metricsAddCadence(const sGrowattFragmentCadence_t& cadence,
+                         const char* type, uint16_t address, Print& metrics,
+                         const String& labels);
   void camelCaseToSnakeCase(const String& input, char* output);
-  void metricsAddValue(const String& name, const double& value,
-                       const float& resolution, String& metrics,
+  void metricsAddValue(const String& name, int64_t scaled, uint8_t decimals,
+                       Print& metrics, const String& labels,
+                       uint64_t timestamp = 0);
+#if PUBLISH_VALUE_LABELS == 1
+  void metricsAddLabel(sGrowattModbusReg_t* reg, Print& metrics,
                        const String& labels);
+  void jsonAddLabel(JsonWriter& json, const char* name,
+                    sGrowattModbusReg_t* reg);
+#endif
   std::tuple<bool, String> handleEcho(const JsonDocument& req,
                                       JsonDocument& res, Growatt& inverter);
   std::tuple<bool, String> handleCommandList(const JsonDocument& req,
@@ -58,7 +297,25 @@ class Growatt {
   std::tuple<bool, String> handleModbusGet(const JsonDocument& req,
                                            JsonDocument& res,
                                            Growatt& inverter);
+  std::tuple<bool, String> handleValueGet(const JsonDocument& req,
+                                          JsonDocument& res,
+                                          Growatt& inverter);
   std::tuple<bool, String> handleModbusSet(const JsonDocument& req,
                                            JsonDocument& res,
                                            Growatt& inverter);
 };
+
+// Holds the snapshots of inverters while an output is built from them, see
+// Growatt::LockSnapshot()
+class SnapshotLock {
+ public:
+  SnapshotLock(Growatt* inverters, uint8_t count = 1);
+  ~SnapshotLock();
+  void Unlock();
+  SnapshotLock(const SnapshotLock&) = delete;
+  SnapshotLock& operator=(const SnapshotLock&) = delete;
+
+ private:
+  Growatt* _Inverters;
+  uint8_t _Count;
+};
@@ -9,29 +9,29 @@ typedef enum {
   P120_I_STATUS = 0,
   P120_INPUT_POWER,
   P120_PV1_VOLTAGE,
-  P120_PV1_INPUT_POWER,
   P120_PV1_INPUT_CURRENT,
+  P120_PV1_INPUT_POWER,
   P120_PV2_VOLTAGE,
-  P120_PV2_INPUT_POWER,
   P120_PV2_INPUT_CURRENT,
+  P120_PV2_INPUT_POWER,
   P120_PV3_VOLTAGE,
-  P120_PV3_INPUT_POWER,
   P120_PV3_INPUT_CURRENT,
+  P120_PV3_INPUT_POWER,
   P120_PV4_VOLTAGE,
-  P120_PV4_INPUT_POWER,
   P120_PV4_INPUT_CURRENT,
+  P120_PV4_INPUT_POWER,
   P120_PV5_VOLTAGE,
-  P120_PV5_INPUT_POWER,
   P120_PV5_INPUT_CURRENT,
+  P120_PV5_INPUT_POWER,
   P120_PV6_VOLTAGE,
-  P120_PV6_INPUT_POWER,
   P120_PV6_INPUT_CURRENT,
+  P120_PV6_INPUT_POWER,
   P120_PV7_VOLTAGE,
-  P120_PV7_INPUT_POWER,
   P120_PV7_INPUT_CURRENT,
+  P120_PV7_INPUT_POWER,
   P120_PV8_VOLTAGE,
-  P120_PV8_INPUT_POWER,
   P120_PV8_INPUT_CURRENT,
+  P120_PV8_INPUT_POWER,
   P120_OUTPUT_POWER,
   P120_GRID_FREQUENCY,
   P120_GRID_L1_VOLTAGE,
@@ -75,8 +75,6 @@ typedef enum {
   P120_OUTPUT_MAXPOWER_LIMITED,
   P120_DERATINGMODE,
   P120_FAULT_CODE,
-  P120_REAL_POWER,
-  P120_START_DELAY,
   LASTInput
 } eP120InputRegisters_t;
 
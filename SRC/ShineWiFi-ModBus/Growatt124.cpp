@@ -434,196 +434,212 @@ std::tuple<bool, String> setGridFirstTimeSlot(const JsonDocument& req,
 
 // NOTE: my inverter (SPH4-10KTL3 BH-UP) only manages to read 64 registers in
 // one read!
+static const char P124_I_STATUS_NAME[] PROGMEM = "InverterStatus";
+static const char P124_INPUT_POWER_NAME[] PROGMEM = "InputPower";
+static const char P124_PV1_VOLTAGE_NAME[] PROGMEM = "PV1Voltage";
+static const char P124_PV1_CURRENT_NAME[] PROGMEM = "PV1InputCurrent";
+static const char P124_PV1_POWER_NAME[] PROGMEM = "PV1InputPower";
+static const char P124_PV2_VOLTAGE_NAME[] PROGMEM = "PV2Voltage";
+static const char P124_PV2_CURRENT_NAME[] PROGMEM = "PV2InputCurrent";
+static const char P124_PV2_POWER_NAME[] PROGMEM = "PV2InputPower";
+static const char P124_PAC_NAME[] PROGMEM = "OutputPower";
+static const char P124_FAC_NAME[] PROGMEM = "GridFrequency";
+static const char P124_VAC1_NAME[] PROGMEM = "L1ThreePhaseGridVoltage";
+static const char P124_IAC1_NAME[] PROGMEM = "L1ThreePhaseGridOutputCurrent";
+static const char P124_PAC1_NAME[] PROGMEM = "L1ThreePhaseGridOutputPower";
+static const char P124_VAC2_NAME[] PROGMEM = "L2ThreePhaseGridVoltage";
+static const char P124_IAC2_NAME[] PROGMEM = "L2ThreePhaseGridOutputCurrent";
+static const char P124_PAC2_NAME[] PROGMEM = "L2ThreePhaseGridOutputPower";
+static const char P124_VAC3_NAME[] PROGMEM = "L3ThreePhaseGridVoltage";
+static const char P124_IAC3_NAME[] PROGMEM = "L3ThreePhaseGridOutputCurrent";
+static const char P124_PAC3_NAME[] PROGMEM = "L3ThreePhaseGridOutputPower";
+static const char P124_EAC_TODAY_NAME[] PROGMEM = "TodayGenerateEnergy";
+static const char P124_EAC_TOTAL_NAME[] PROGMEM = "TotalGenerateEnergy";
+static const char P124_TIME_TOTAL_NAME[] PROGMEM = "TWorkTimeTotal";
+static const char P124_EPV1_TODAY_NAME[] PROGMEM = "PV1EnergyToday";
+static const char P124_EPV1_TOTAL_NAME[] PROGMEM = "PV1EnergyTotal";
+static const char P124_EPV2_TODAY_NAME[] PROGMEM = "PV2EnergyToday";
+static const char P124_EPV2_TOTAL_NAME[] PROGMEM = "PV2EnergyTotal";
+static const char P124_EPV_TOTAL_NAME[] PROGMEM = "PVEnergyTotal";
+static const char P124_TEMP1_NAME[] PROGMEM = "InverterTemperature";
+static const char P124_TEMP2_NAME[] PROGMEM = "TemperatureInsideIPM";
+static const char P124_TEMP3_NAME[] PROGMEM = "BoostTemperature";
+static const char P124_PDISCHARGE_NAME[] PROGMEM = "DischargePower";
+static const char P124_PCHARGE_NAME[] PROGMEM = "ChargePower";
+static const char P124_VBAT_NAME[] PROGMEM = "BatteryVoltage";
+static const char P124_SOC_NAME[] PROGMEM = "SOC";
+static const char P124_PAC_TO_USER_NAME[] PROGMEM = "ACPowerToUser";
+static const char P124_PAC_TO_USER_TOTAL_NAME[] PROGMEM = "ACPowerToUserTotal";
+static const char P124_PAC_TO_GRID_NAME[] PROGMEM = "ACPowerToGrid";
+static const char P124_PAC_TO_GRID_TOTAL_NAME[] PROGMEM = "ACPowerToGridTotal";
+static const char P124_PLOCAL_LOAD_NAME[] PROGMEM = "INVPowerToLocalLoad";
+static const char P124_PLOCAL_LOAD_TOTAL_NAME[] PROGMEM =
+    "INVPowerToLocalLoadTotal";
+static const char P124_BATTERY_TEMPERATURE_NAME[] PROGMEM =
+    "BatteryTemperature";
+static const char P124_BATTERY_STATE_NAME[] PROGMEM = "BatteryState";
+static const char P124_ETOUSER_TODAY_NAME[] PROGMEM = "EnergyToUserToday";
+static const char P124_ETOUSER_TOTAL_NAME[] PROGMEM = "EnergyToUserTotal";
+static const char P124_ETOGRID_TODAY_NAME[] PROGMEM = "EnergyToGridToday";
+static const char P124_ETOGRID_TOTAL_NAME[] PROGMEM = "EnergyToGridTotal";
+static const char P124_EDISCHARGE_TODAY_NAME[] PROGMEM = "DischargeEnergyToday";
+static const char P124_EDISCHARGE_TOTAL_NAME[] PROGMEM = "DischargeEnergyTotal";
+static const char P124_ECHARGE_TODAY_NAME[] PROGMEM = "ChargeEnergyToday";
+static const char P124_ECHARGE_TOTAL_NAME[] PROGMEM = "ChargeEnergyTotal";
+static const char P124_ETOLOCALLOAD_TODAY_NAME[] PROGMEM =
+    "LocalLoadEnergyToday";
+static const char P124_ETOLOCALLOAD_TOTAL_NAME[] PROGMEM =
+    "LocalLoadEnergyTotal";
+static const char P124_ACCHARGE_TODAY_NAME[] PROGMEM = "ACChargeEnergyToday";
+static const char P124_ACCHARGE_TOTAL_NAME[] PROGMEM = "ACChargeEnergyTotal";
+static const char P124_Active_P_Rate_NAME[] PROGMEM = "ActivePowerRate";
+
+// address, size, name, multiplier, resolution, unit, frontend, plot
+static constexpr sGrowattRegisterDef_t P124InputRegisters[] PROGMEM = {
+    // FRAGMENT 1: BEGIN
+    {0, SIZE_16BIT, P124_I_STATUS_NAME, 1, 1, NONE, true, false,
+     &LABELS_STATUS},
+    {1, SIZE_32BIT, P124_INPUT_POWER_NAME, 0.1, 0.1, POWER_W, true, true},
+    {3, SIZE_16BIT, P124_PV1_VOLTAGE_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {4, SIZE_16BIT, P124_PV1_CURRENT_NAME, 0.1, 0.1, CURRENT, false, false},
+    {5, SIZE_32BIT, P124_PV1_POWER_NAME, 0.1, 0.1, POWER_W, false, false},
+    {7, SIZE_16BIT, P124_PV2_VOLTAGE_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {8, SIZE_16BIT, P124_PV2_CURRENT_NAME, 0.1, 0.1, CURRENT, false, false},
+    {9, SIZE_32BIT, P124_PV2_POWER_NAME, 0.1, 0.1, POWER_W, false, false},
+    {35, SIZE_32BIT_S, P124_PAC_NAME, 0.1, 0.1, POWER_W, true, true},
+    {37, SIZE_16BIT, P124_FAC_NAME, 0.01, 0.01, FREQUENCY, false, false},
+    {38, SIZE_16BIT, P124_VAC1_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {39, SIZE_16BIT, P124_IAC1_NAME, 0.1, 0.1, CURRENT, false, false},
+    {40, SIZE_32BIT, P124_PAC1_NAME, 0.1, 0.1, VA, false, false},
+    {42, SIZE_16BIT, P124_VAC2_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {43, SIZE_16BIT, P124_IAC2_NAME, 0.1, 0.1, CURRENT, false, false},
+    {44, SIZE_32BIT, P124_PAC2_NAME, 0.1, 0.1, VA, false, false},
+    {46, SIZE_16BIT, P124_VAC3_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {47, SIZE_16BIT, P124_IAC3_NAME, 0.1, 0.1, CURRENT, false, false},
+    {48, SIZE_32BIT, P124_PAC3_NAME, 0.1, 0.1, VA, false, false},
+    // FRAGMENT 1: END
+
+    // FRAGMENT 2: BEGIN
+    {53, SIZE_32BIT, P124_EAC_TODAY_NAME, 0.1, 0.1, POWER_KWH, true, false},
+    {55, SIZE_32BIT, P124_EAC_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true, false},
+    {57, SIZE_32BIT, P124_TIME_TOTAL_NAME, 0.5, 1, SECONDS, false, false},
+    {59, SIZE_32BIT, P124_EPV1_TODAY_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {61, SIZE_32BIT, P124_EPV1_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {63, SIZE_32BIT, P124_EPV2_TODAY_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {65, SIZE_32BIT, P124_EPV2_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {91, SIZE_32BIT, P124_EPV_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {93, SIZE_16BIT, P124_TEMP1_NAME, 0.1, 0.1, TEMPERATURE, true, true},
+    {94, SIZE_16BIT, P124_TEMP2_NAME, 0.1, 0.1, TEMPERATURE, false, false},
+    {95, SIZE_16BIT, P124_TEMP3_NAME, 0.1, 0.1, TEMPERATURE, false, false},
+    // FRAGMENT 2: END
+
+    // FRAGMENT 3: BEGIN
+    {1009, SIZE_32BIT, P124_PDISCHARGE_NAME, 0.1, 0.1, POWER_W, true, true},
+    {1011, SIZE_32BIT, P124_PCHARGE_NAME, 0.1, 0.1, POWER_W, true, true},
+    {1013, SIZE_16BIT, P124_VBAT_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {1014, SIZE_16BIT, P124_SOC_NAME, 1, 1, PERCENTAGE, true, true},
+    {1015, SIZE_32BIT, P124_PAC_TO_USER_NAME, 0.1, 0.1, POWER_W, false, false},
+    {1021, SIZE_32BIT, P124_PAC_TO_USER_TOTAL_NAME, 0.1, 0.1, POWER_W, false,
+     false},
+    {1023, SIZE_32BIT, P124_PAC_TO_GRID_NAME, 0.1, 0.1, POWER_W, false, false},
+    {1029, SIZE_32BIT, P124_PAC_TO_GRID_TOTAL_NAME, 0.1, 0.1, POWER_W, false,
+     false},
+    {1031, SIZE_32BIT, P124_PLOCAL_LOAD_NAME, 0.1, 0.1, POWER_W, false, false},
+    {1037, SIZE_32BIT, P124_PLOCAL_LOAD_TOTAL_NAME, 0.1, 0.1, POWER_W, true,
+     false},
+    {1040, SIZE_16BIT, P124_BATTERY_TEMPERATURE_NAME,
+     TEMPERATURE_WORKAROUND_MULTIPLIER, TEMPERATURE_WORKAROUND_MULTIPLIER,
+     TEMPERATURE, true, true},
+    {1041, SIZE_16BIT, P124_BATTERY_STATE_NAME, 1, 1, NONE, true, false},
+    {1044, SIZE_32BIT, P124_ETOUSER_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1046, SIZE_32BIT, P124_ETOUSER_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1048, SIZE_32BIT, P124_ETOGRID_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1050, SIZE_32BIT, P124_ETOGRID_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1052, SIZE_32BIT, P124_EDISCHARGE_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1054, SIZE_32BIT, P124_EDISCHARGE_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1056, SIZE_32BIT, P124_ECHARGE_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1058, SIZE_32BIT, P124_ECHARGE_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1060, SIZE_32BIT, P124_ETOLOCALLOAD_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1062, SIZE_32BIT, P124_ETOLOCALLOAD_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    // FRAGMENT 3: END
+
+    // FRAGMENT 4: START
+    {1124, SIZE_32BIT, P124_ACCHARGE_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1126, SIZE_32BIT, P124_ACCHARGE_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    // FRAGMENT 4: END
+};
+static constexpr sGrowattReadFragment_t P124InputFragments[] PROGMEM = {
+    {0, 50},
+    {53, 43},
+    {1009, 55},
+    {1124, 4},
+};
+CHECK_PROTOCOL_TABLE(P124InputRegisters, P124_INPUT_REGISTER_COUNT,
+                     P124InputFragments);
+
+// address, size, name, multiplier, resolution, unit, frontend, plot
+static constexpr sGrowattRegisterDef_t P124HoldingRegisters[] PROGMEM = {
+    // FRAGMENT 1: BEGIN
+    {3, SIZE_16BIT, P124_Active_P_Rate_NAME, 1, 1, PERCENTAGE, true, false},
+    // FRAGMENT 1: END
+};
+static constexpr sGrowattReadFragment_t P124HoldingFragments[] PROGMEM = {
+    {3, 1},
+};
+CHECK_PROTOCOL_TABLE(P124HoldingRegisters, P124_HOLDING_REGISTER_COUNT,
+                     P124HoldingFragments);
+
+// first address, last address, groups
+static constexpr sGrowattRegisterGroup_t P124InputGroups[] PROGMEM = {
+    {0, 0, GroupStatus},
+    {1, 9, GroupPv},
+    {35, 48, GroupGrid},
+    {53, 55, GroupEnergy},
+    {57, 57, GroupDiagnostics},
+    {59, 91, GroupPv | GroupEnergy},
+    {93, 95, GroupDiagnostics},
+    {1009, 1014, GroupBattery},
+    {1015, 1029, GroupGrid},
+    {1031, 1037, GroupLoad},
+    {1040, 1041, GroupBattery},
+    {1044, 1050, GroupGrid | GroupEnergy},
+    {1052, 1058, GroupBattery | GroupEnergy},
+    {1060, 1062, GroupLoad | GroupEnergy},
+    {1124, 1126, GroupBattery | GroupEnergy},
+};
+CHECK_GROUP_TABLE(P124InputGroups);
+static constexpr sGrowattRegisterGroup_t P124HoldingGroups[] PROGMEM = {
+    {0, 0xFFFF, GroupSettings},
+};
+CHECK_GROUP_TABLE(P124HoldingGroups);
+
 void init_growatt124(sProtocolDefinition_t& Protocol, Growatt& inverter) {
-  // definition of input registers
   Protocol.InputRegisterCount = P124_INPUT_REGISTER_COUNT;
-  // address, value, size, name, multiplier, unit, frontend, plot
-  // FRAGMENT 1: BEGIN
-  Protocol.InputRegisters[P124_I_STATUS] = sGrowattModbusReg_t{
-      0, 0, SIZE_16BIT, F("InverterStatus"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P124_INPUT_POWER] = sGrowattModbusReg_t{
-      1, 0, SIZE_32BIT, F("InputPower"), 0.1, 0.1, POWER_W, true, true};
-
-  Protocol.InputRegisters[P124_PV1_VOLTAGE] = sGrowattModbusReg_t{
-      3, 0, SIZE_16BIT, F("PV1Voltage"), 0.1, 0.1, VOLTAGE, false, false};
-  Protocol.InputRegisters[P124_PV1_CURRENT] = sGrowattModbusReg_t{
-      4, 0, SIZE_16BIT, F("PV1InputCurrent"), 0.1, 0.1, CURRENT, false, false};
-  Protocol.InputRegisters[P124_PV1_POWER] = sGrowattModbusReg_t{
-      5, 0, SIZE_32BIT, F("PV1InputPower"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P124_PV2_VOLTAGE] = sGrowattModbusReg_t{
-      7, 0, SIZE_16BIT, F("PV2Voltage"), 0.1, 0.1, VOLTAGE, false, false};
-  Protocol.InputRegisters[P124_PV2_CURRENT] = sGrowattModbusReg_t{
-      8, 0, SIZE_16BIT, F("PV2InputCurrent"), 0.1, 0.1, CURRENT, false, false};
-  Protocol.InputRegisters[P124_PV2_POWER] = sGrowattModbusReg_t{
-      9, 0, SIZE_32BIT, F("PV2InputPower"), 0.1, 0.1, POWER_W, false, false};
-
-  Protocol.InputRegisters[P124_PAC] = sGrowattModbusReg_t{
-      35, 0, SIZE_32BIT_S, F("OutputPower"), 0.1, 0.1, POWER_W, true, true};
-  Protocol.InputRegisters[P124_FAC] = sGrowattModbusReg_t{
-      37,        0,     SIZE_16BIT, F("GridFrequency"), 0.01, 0.01,
-      FREQUENCY, false, false};
-
-  Protocol.InputRegisters[P124_VAC1] = sGrowattModbusReg_t{
-      38,      0,     SIZE_16BIT, F("L1ThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P124_IAC1] = sGrowattModbusReg_t{
-      39,      0,     SIZE_16BIT, F("L1ThreePhaseGridOutputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P124_PAC1] = sGrowattModbusReg_t{
-      40, 0,     SIZE_32BIT, F("L1ThreePhaseGridOutputPower"), 0.1, 0.1,
-      VA, false, false};
-  Protocol.InputRegisters[P124_VAC2] = sGrowattModbusReg_t{
-      42,      0,     SIZE_16BIT, F("L2ThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P124_IAC2] = sGrowattModbusReg_t{
-      43,      0,     SIZE_16BIT, F("L2ThreePhaseGridOutputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P124_PAC2] = sGrowattModbusReg_t{
-      44, 0,     SIZE_32BIT, F("L2ThreePhaseGridOutputPower"), 0.1, 0.1,
-      VA, false, false};
-  Protocol.InputRegisters[P124_VAC3] = sGrowattModbusReg_t{
-      46,      0,     SIZE_16BIT, F("L3ThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P124_IAC3] = sGrowattModbusReg_t{
-      47,      0,     SIZE_16BIT, F("L3ThreePhaseGridOutputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P124_PAC3] = sGrowattModbusReg_t{
-      48, 0,     SIZE_32BIT, F("L3ThreePhaseGridOutputPower"), 0.1, 0.1,
-      VA, false, false};
-  // FRAGMENT 1: END
-
-  // FRAGMENT 2: BEGIN
-  Protocol.InputRegisters[P124_EAC_TODAY] = sGrowattModbusReg_t{
-      53,        0,    SIZE_32BIT, F("TodayGenerateEnergy"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_EAC_TOTAL] = sGrowattModbusReg_t{
-      55,        0,    SIZE_32BIT, F("TotalGenerateEnergy"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_TIME_TOTAL] = sGrowattModbusReg_t{
-      57, 0, SIZE_32BIT, F("TWorkTimeTotal"), 0.5, 1, SECONDS, false, false};
-
-  Protocol.InputRegisters[P124_EPV1_TODAY] = sGrowattModbusReg_t{
-      59,        0,     SIZE_32BIT, F("PV1EnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P124_EPV1_TOTAL] = sGrowattModbusReg_t{
-      61,        0,     SIZE_32BIT, F("PV1EnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P124_EPV2_TODAY] = sGrowattModbusReg_t{
-      63,        0,     SIZE_32BIT, F("PV2EnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P124_EPV2_TOTAL] = sGrowattModbusReg_t{
-      65,        0,     SIZE_32BIT, F("PV2EnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P124_EPV_TOTAL] = sGrowattModbusReg_t{
-      91, 0, SIZE_32BIT, F("PVEnergyTotal"), 0.1, 0.1, POWER_KWH, false, false};
-
-  Protocol.InputRegisters[P124_TEMP1] = sGrowattModbusReg_t{
-      93,          0,    SIZE_16BIT, F("InverterTemperature"), 0.1, 0.1,
-      TEMPERATURE, true, true};
-  Protocol.InputRegisters[P124_TEMP2] = sGrowattModbusReg_t{
-      94,          0,     SIZE_16BIT, F("TemperatureInsideIPM"), 0.1, 0.1,
-      TEMPERATURE, false, false};
-  Protocol.InputRegisters[P124_TEMP3] = sGrowattModbusReg_t{
-      95,          0,     SIZE_16BIT, F("BoostTemperature"), 0.1, 0.1,
-      TEMPERATURE, false, false};
-  // FRAGMENT 2: END
-
-  // FRAGMENT 3: BEGIN
-  Protocol.InputRegisters[P124_PDISCHARGE] = sGrowattModbusReg_t{
-      1009, 0, SIZE_32BIT, F("DischargePower"), 0.1, 0.1, POWER_W, true, true};
-  Protocol.InputRegisters[P124_PCHARGE] = sGrowattModbusReg_t{
-      1011, 0, SIZE_32BIT, F("ChargePower"), 0.1, 0.1, POWER_W, true, true};
-  Protocol.InputRegisters[P124_VBAT] = sGrowattModbusReg_t{
-      1013,    0,     SIZE_16BIT, F("BatteryVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P124_SOC] = sGrowattModbusReg_t{
-      1014, 0, SIZE_16BIT, F("SOC"), 1, 1, PERCENTAGE, true, true};
-  Protocol.InputRegisters[P124_PAC_TO_USER] = sGrowattModbusReg_t{
-      1015, 0, SIZE_32BIT, F("ACPowerToUser"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P124_PAC_TO_USER_TOTAL] = sGrowattModbusReg_t{
-      1021,    0,     SIZE_32BIT, F("ACPowerToUserTotal"), 0.1, 0.1,
-      POWER_W, false, false};
-  Protocol.InputRegisters[P124_PAC_TO_GRID] = sGrowattModbusReg_t{
-      1023, 0, SIZE_32BIT, F("ACPowerToGrid"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P124_PAC_TO_GRID_TOTAL] = sGrowattModbusReg_t{
-      1029,    0,     SIZE_32BIT, F("ACPowerToGridTotal"), 0.1, 0.1,
-      POWER_W, false, false};
-  Protocol.InputRegisters[P124_PLOCAL_LOAD] = sGrowattModbusReg_t{
-      1031,    0,     SIZE_32BIT, F("INVPowerToLocalLoad"), 0.1, 0.1,
-      POWER_W, false, false};
-  Protocol.InputRegisters[P124_PLOCAL_LOAD_TOTAL] = sGrowattModbusReg_t{
-      1037,    0,    SIZE_32BIT, F("INVPowerToLocalLoadTotal"), 0.1, 0.1,
-      POWER_W, true, false};
-  Protocol.InputRegisters[P124_BATTERY_TEMPERATURE] =
-      sGrowattModbusReg_t{1040,
-                          0,
-                          SIZE_16BIT,
-                          F("BatteryTemperature"),
-                          TEMPERATURE_WORKAROUND_MULTIPLIER,
-                          TEMPERATURE_WORKAROUND_MULTIPLIER,
-                          TEMPERATURE,
-                          true,
-                          true};
-  Protocol.InputRegisters[P124_BATTERY_STATE] = sGrowattModbusReg_t{
-      1041, 0, SIZE_16BIT, F("BatteryState"), 1, 1, NONE, true, false};
-
-  Protocol.InputRegisters[P124_ETOUSER_TODAY] = sGrowattModbusReg_t{
-      1044,      0,    SIZE_32BIT, F("EnergyToUserToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_ETOUSER_TOTAL] = sGrowattModbusReg_t{
-      1046,      0,    SIZE_32BIT, F("EnergyToUserTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_ETOGRID_TODAY] = sGrowattModbusReg_t{
-      1048,      0,    SIZE_32BIT, F("EnergyToGridToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_ETOGRID_TOTAL] = sGrowattModbusReg_t{
-      1050,      0,    SIZE_32BIT, F("EnergyToGridTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_EDISCHARGE_TODAY] = sGrowattModbusReg_t{
-      1052,      0,    SIZE_32BIT, F("DischargeEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_EDISCHARGE_TOTAL] = sGrowattModbusReg_t{
-      1054,      0,    SIZE_32BIT, F("DischargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_ECHARGE_TODAY] = sGrowattModbusReg_t{
-      1056,      0,    SIZE_32BIT, F("ChargeEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_ECHARGE_TOTAL] = sGrowattModbusReg_t{
-      1058,      0,    SIZE_32BIT, F("ChargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_ETOLOCALLOAD_TODAY] = sGrowattModbusReg_t{
-      1060,      0,    SIZE_32BIT, F("LocalLoadEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_ETOLOCALLOAD_TOTAL] = sGrowattModbusReg_t{
-      1062,      0,    SIZE_32BIT, F("LocalLoadEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  // FRAGMENT 3: END
-
-  // FRAGMENT 4: START
-  Protocol.InputRegisters[P124_ACCHARGE_TODAY] = sGrowattModbusReg_t{
-      1124,      0,    SIZE_32BIT, F("ACChargeEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P124_ACCHARGE_TOTAL] = sGrowattModbusReg_t{
-      1126,      0,    SIZE_32BIT, F("ACChargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  // FRAGMENT 4: END
-
-  Protocol.InputFragmentCount = 4;
-  Protocol.InputReadFragments[0] = sGrowattReadFragment_t{0, 50};
-  Protocol.InputReadFragments[1] = sGrowattReadFragment_t{53, 43};
-  Protocol.InputReadFragments[2] = sGrowattReadFragment_t{1009, 55};
-  Protocol.InputReadFragments[3] = sGrowattReadFragment_t{1124, 4};
-
-  // definition of holding registers
-  Protocol.HoldingRegisterCount = 1;
-
-  // FRAGMENT 1: BEGIN
-  Protocol.HoldingRegisters[P124_Active_P_Rate] = sGrowattModbusReg_t{
-      3, 0, SIZE_16BIT, F("ActivePowerRate"), 1, 1, PERCENTAGE, true, false};
-  // FRAGMENT 1: END
-
-  Protocol.HoldingFragmentCount = 1;
-  Protocol.HoldingReadFragments[0] = sGrowattReadFragment_t{3, 1};
+  Protocol.InputRegisters = P124InputRegisters;
+  Protocol.InputFragmentCount = tableSize(P124InputFragments);
+  Protocol.InputReadFragments = P124InputFragments;
+
+  Protocol.HoldingRegisterCount = P124_HOLDING_REGISTER_COUNT;
+  Protocol.HoldingRegisters = P124HoldingRegisters;
+  Protocol.HoldingFragmentCount = tableSize(P124HoldingFragments);
+  Protocol.HoldingReadFragments = P124HoldingFragments;
+
+  Protocol.InputGroupCount = tableSize(P124InputGroups);
+  Protocol.InputGroups = P124InputGroups;
+  Protocol.HoldingGroupCount = tableSize(P124HoldingGroups);
+  Protocol.HoldingGroups = P124HoldingGroups;
 
   // definition of commands
   inverter.RegisterCommand("datetime/get", getDateTime);
@@ -3,46 +3,67 @@
 #include "Growatt.h"
 #include "Growatt305.h"
 
-void init_growatt305(sProtocolDefinition_t& Protocol, Growatt& inverter) {
-  // definition of input registers
-  Protocol.InputRegisterCount = 12;
-  // address, value, size, name, multiplier, unit, frontend, plot
-  // FRAGMENT 1: BEGIN
-  Protocol.InputRegisters[P305_I_STATUS] = sGrowattModbusReg_t{
-      0, 0, SIZE_16BIT, F("InverterStatus"), 1, 1, NONE, true, false};  // #1
-  Protocol.InputRegisters[P305_DC_POWER] = sGrowattModbusReg_t{
-      1, 0, SIZE_32BIT, F("DcPower"), 0.1, 0.1, POWER_W, true, true};  // #2
-  Protocol.InputRegisters[P305_DC_VOLTAGE] = sGrowattModbusReg_t{
-      3, 0, SIZE_16BIT, F("DcVoltage"), 0.1, 0.1, VOLTAGE, true, false};  // #3
-  Protocol.InputRegisters[P305_DC_INPUT_CURRENT] = sGrowattModbusReg_t{
-      4,       0,    SIZE_16BIT, F("DcInputCurrent"), 0.1, 0.1,
-      CURRENT, true, false};  // #4
-  Protocol.InputRegisters[P305_AC_FREQUENCY] = sGrowattModbusReg_t{
-      13,        0,    SIZE_16BIT, F("AcFrequency"), 0.01, 0.01,
-      FREQUENCY, true, false};  // #5
-  Protocol.InputRegisters[P305_AC_VOLTAGE] = sGrowattModbusReg_t{
-      14, 0, SIZE_16BIT, F("AcVoltage"), 0.1, 0.1, VOLTAGE, true, false};  // #6
-  Protocol.InputRegisters[P305_AC_OUTPUT_CURRENT] = sGrowattModbusReg_t{
-      15,      0,    SIZE_16BIT, F("AcOutputCurrent"), 0.1, 0.1,
-      CURRENT, true, false};  // #7
-  Protocol.InputRegisters[P305_AC_POWER] = sGrowattModbusReg_t{
-      16, 0, SIZE_32BIT, F("AcPower"), 0.1, 0.1, POWER_W, true, true};  // #8
-  Protocol.InputRegisters[P305_ENERGY_TODAY] = sGrowattModbusReg_t{
-      26,        0,    SIZE_32BIT, F("EnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};  // #9
-  Protocol.InputRegisters[P305_ENERGY_TOTAL] = sGrowattModbusReg_t{
-      28,        0,    SIZE_32BIT, F("EnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};  // #10
-  Protocol.InputRegisters[P305_OPERATING_TIME] =
-      sGrowattModbusReg_t{30,      0,    SIZE_32BIT, F("OperatingTime"), 0.5, 1,
-                          SECONDS, true, false};  // #11
-  Protocol.InputRegisters[P305_TEMPERATURE] = sGrowattModbusReg_t{
-      32,          0,    SIZE_16BIT, F("Temperature"), 0.1, 0.1,
-      TEMPERATURE, true, false};  // #12
+static const char P305_I_STATUS_NAME[] PROGMEM = "InverterStatus";
+static const char P305_DC_POWER_NAME[] PROGMEM = "DcPower";
+static const char P305_DC_VOLTAGE_NAME[] PROGMEM = "DcVoltage";
+static const char P305_DC_INPUT_CURRENT_NAME[] PROGMEM = "DcInputCurrent";
+static const char P305_AC_FREQUENCY_NAME[] PROGMEM = "AcFrequency";
+static const char P305_AC_VOLTAGE_NAME[] PROGMEM = "AcVoltage";
+static const char P305_AC_OUTPUT_CURRENT_NAME[] PROGMEM = "AcOutputCurrent";
+static const char P305_AC_POWER_NAME[] PROGMEM = "AcPower";
+static const char P305_ENERGY_TODAY_NAME[] PROGMEM = "EnergyToday";
+static const char P305_ENERGY_TOTAL_NAME[] PROGMEM = "EnergyTotal";
+static const char P305_OPERATING_TIME_NAME[] PROGMEM = "OperatingTime";
+static const char P305_TEMPERATURE_NAME[] PROGMEM = "Temperature";
+
+// address, size, name, multiplier, resolution, unit, frontend, plot
+static constexpr sGrowattRegisterDef_t P305InputRegisters[] PROGMEM = {
+    // FRAGMENT 1: BEGIN
+    {0, SIZE_16BIT, P305_I_STATUS_NAME, 1, 1, NONE, true, false,
+     &LABELS_STATUS},
+    {1, SIZE_32BIT, P305_DC_POWER_NAME, 0.1, 0.1, POWER_W, true, true},
+    {3, SIZE_16BIT, P305_DC_VOLTAGE_NAME, 0.1, 0.1, VOLTAGE, true, false},
+    {4, SIZE_16BIT, P305_DC_INPUT_CURRENT_NAME, 0.1, 0.1, CURRENT, true, false},
+    {13, SIZE_16BIT, P305_AC_FREQUENCY_NAME, 0.01, 0.01, FREQUENCY, true,
+     false},
+    {14, SIZE_16BIT, P305_AC_VOLTAGE_NAME, 0.1, 0.1, VOLTAGE, true, false},
+    {15, SIZE_16BIT, P305_AC_OUTPUT_CURRENT_NAME, 0.1, 0.1, CURRENT, true,
+     false},
+    {16, SIZE_32BIT, P305_AC_POWER_NAME, 0.1, 0.1, POWER_W, true, true},
+    {26, SIZE_32BIT, P305_ENERGY_TODAY_NAME, 0.1, 0.1, POWER_KWH, true, false},
+    {28, SIZE_32BIT, P305_ENERGY_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true, false},
+    {30, SIZE_32BIT, P305_OPERATING_TIME_NAME, 0.5, 1, SECONDS, true, false},
+    {32, SIZE_16BIT, P305_TEMPERATURE_NAME, 0.1, 0.1, TEMPERATURE, true, false},
+};
+static constexpr sGrowattReadFragment_t P305InputFragments[] PROGMEM = {
+    {0, 33},
+};
+CHECK_PROTOCOL_TABLE(P305InputRegisters, P305_INPUT_REGISTER_COUNT,
+                     P305InputFragments);
 
-  Protocol.InputFragmentCount = 1;
-  Protocol.InputReadFragments[0] = sGrowattReadFragment_t{0, 33};
+// first address, last address, groups
+static constexpr sGrowattRegisterGroup_t P305InputGroups[] PROGMEM = {
+    {0, 0, GroupStatus},
+    {1, 4, GroupPv},
+    {13, 16, GroupGrid},
+    {26, 28, GroupEnergy},
+    {30, 32, GroupDiagnostics},
+};
+CHECK_GROUP_TABLE(P305InputGroups);
+
+void init_growatt305(sProtocolDefinition_t& Protocol, Growatt& inverter) {
+  Protocol.InputRegisterCount = P305_INPUT_REGISTER_COUNT;
+  Protocol.InputRegisters = P305InputRegisters;
+  Protocol.InputFragmentCount = tableSize(P305InputFragments);
+  Protocol.InputReadFragments = P305InputFragments;
 
   Protocol.HoldingRegisterCount = 0;
+  Protocol.HoldingRegisters = NULL;
   Protocol.HoldingFragmentCount = 0;
+  Protocol.HoldingReadFragments = NULL;
+
+  Protocol.InputGroupCount = tableSize(P305InputGroups);
+  Protocol.InputGroups = P305InputGroups;
+  Protocol.HoldingGroupCount = 0;
+  Protocol.HoldingGroups = NULL;
 }
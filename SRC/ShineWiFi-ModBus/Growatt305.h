@@ -18,6 +18,7 @@ typedef enum {
   P305_ENERGY_TOTAL,
   P305_OPERATING_TIME,
   P305_TEMPERATURE,
+  P305_INPUT_REGISTER_COUNT
 } eP305InputRegisters_t;
 
 void init_growatt305(sProtocolDefinition_t& Protocol, Growatt& inverter);
@@ -516,318 +516,349 @@ std::tuple<bool, String> setGridFirstTimeSlot307(const JsonDocument& req,
 #define TEMPERATURE_WORKAROUND_MULTIPLIER 0.1
 #endif
 
+static const char P307_I_STATUS_NAME[] PROGMEM = "InverterStatus";
+static const char P307_INPUT_POWER_NAME[] PROGMEM = "InputPower";
+static const char P307_PV1_VOLTAGE_NAME[] PROGMEM = "PV1Voltage";
+static const char P307_PV1_CURRENT_NAME[] PROGMEM = "PV1InputCurrent";
+static const char P307_PV1_POWER_NAME[] PROGMEM = "PV1InputPower";
+static const char P307_PV2_VOLTAGE_NAME[] PROGMEM = "PV2Voltage";
+static const char P307_PV2_CURRENT_NAME[] PROGMEM = "PV2InputCurrent";
+static const char P307_PV2_POWER_NAME[] PROGMEM = "PV2InputPower";
+static const char P307_PAC_NAME[] PROGMEM = "OutputPower";
+static const char P307_FAC_NAME[] PROGMEM = "GridFrequency";
+static const char P307_VAC1_NAME[] PROGMEM = "L1ThreePhaseGridVoltage";
+static const char P307_IAC1_NAME[] PROGMEM = "L1ThreePhaseGridOutputCurrent";
+static const char P307_PAC1_NAME[] PROGMEM = "L1ThreePhaseGridOutputPower";
+static const char P307_VAC2_NAME[] PROGMEM = "L2ThreePhaseGridVoltage";
+static const char P307_IAC2_NAME[] PROGMEM = "L2ThreePhaseGridOutputCurrent";
+static const char P307_PAC2_NAME[] PROGMEM = "L2ThreePhaseGridOutputPower";
+static const char P307_VAC3_NAME[] PROGMEM = "L3ThreePhaseGridVoltage";
+static const char P307_IAC3_NAME[] PROGMEM = "L3ThreePhaseGridOutputCurrent";
+static const char P307_PAC3_NAME[] PROGMEM = "L3ThreePhaseGridOutputPower";
+static const char P307_EAC_TODAY_NAME[] PROGMEM = "TodayGenerateEnergy";
+static const char P307_EAC_TOTAL_NAME[] PROGMEM = "TotalGenerateEnergy";
+static const char P307_TIME_TOTAL_NAME[] PROGMEM = "TWorkTimeTotal";
+static const char P307_EPV1_TODAY_NAME[] PROGMEM = "PV1EnergyToday";
+static const char P307_EPV1_TOTAL_NAME[] PROGMEM = "PV1EnergyTotal";
+static const char P307_EPV2_TODAY_NAME[] PROGMEM = "PV2EnergyToday";
+static const char P307_EPV2_TOTAL_NAME[] PROGMEM = "PV2EnergyTotal";
+static const char P307_EPV_TOTAL_NAME[] PROGMEM = "PVEnergyTotal";
+static const char P307_TEMP1_NAME[] PROGMEM = "InverterTemperature";
+static const char P307_TEMP2_NAME[] PROGMEM = "TemperatureInsideIPM";
+static const char P307_TEMP3_NAME[] PROGMEM = "BoostTemperature";
+static const char P307_PDISCHARGE_NAME[] PROGMEM = "DischargePower";
+static const char P307_PCHARGE_NAME[] PROGMEM = "ChargePower";
+static const char P307_VBAT_NAME[] PROGMEM = "BatteryVoltage";
+static const char P307_SOC_NAME[] PROGMEM = "SOC";
+static const char P307_PAC_TO_USER_NAME[] PROGMEM = "ACPowerToUser";
+static const char P307_PAC_TO_USER_TOTAL_NAME[] PROGMEM = "ACPowerToUserTotal";
+static const char P307_PAC_TO_GRID_NAME[] PROGMEM = "ACPowerToGrid";
+static const char P307_PAC_TO_GRID_TOTAL_NAME[] PROGMEM = "ACPowerToGridTotal";
+static const char P307_PLOCAL_LOAD_NAME[] PROGMEM = "INVPowerToLocalLoad";
+static const char P307_PLOCAL_LOAD_TOTAL_NAME[] PROGMEM =
+    "INVPowerToLocalLoadTotal";
+static const char P307_BATTERY_TEMPERATURE_NAME[] PROGMEM =
+    "BatteryTemperature";
+static const char P307_BATTERY_STATE_NAME[] PROGMEM = "BatteryState";
+static const char P307_ETOUSER_TODAY_NAME[] PROGMEM = "EnergyToUserToday";
+static const char P307_ETOUSER_TOTAL_NAME[] PROGMEM = "EnergyToUserTotal";
+static const char P307_ETOGRID_TODAY_NAME[] PROGMEM = "EnergyToGridToday";
+static const char P307_ETOGRID_TOTAL_NAME[] PROGMEM = "EnergyToGridTotal";
+static const char P307_EDISCHARGE_TODAY_NAME[] PROGMEM = "DischargeEnergyToday";
+static const char P307_EDISCHARGE_TOTAL_NAME[] PROGMEM = "DischargeEnergyTotal";
+static const char P307_ECHARGE_TODAY_NAME[] PROGMEM = "ChargeEnergyToday";
+static const char P307_ECHARGE_TOTAL_NAME[] PROGMEM = "ChargeEnergyTotal";
+static const char P307_ETOLOCALLOAD_TODAY_NAME[] PROGMEM =
+    "LocalLoadEnergyToday";
+static const char P307_ETOLOCALLOAD_TOTAL_NAME[] PROGMEM =
+    "LocalLoadEnergyTotal";
+static const char P307_ACCHARGE_TODAY_NAME[] PROGMEM = "ACChargeEnergyToday";
+static const char P307_ACCHARGE_TOTAL_NAME[] PROGMEM = "ACChargeEnergyTotal";
+static const char P307_CURRENT_MODE_NAME[] PROGMEM = "CurrentMode";
+static const char P307_Active_P_Rate_NAME[] PROGMEM = "ActivePowerRate";
+static const char P307_H_SYSTEM_YEAR_NAME[] PROGMEM = "SystemYear";
+static const char P307_H_SYSTEM_MONTH_NAME[] PROGMEM = "SystemMonth";
+static const char P307_H_SYSTEM_DAY_NAME[] PROGMEM = "SystemDay";
+static const char P307_H_SYSTEM_HOUR_NAME[] PROGMEM = "SystemHour";
+static const char P307_H_SYSTEM_MINUTE_NAME[] PROGMEM = "SystemMinute";
+static const char P307_H_SYSTEM_SECOND_NAME[] PROGMEM = "SystemSecond";
+static const char P307_H_EXPORT_LIMIT_ENABLED_NAME[] PROGMEM =
+    "ExportLimitFlag";
+static const char P307_H_EXPORT_LIMIT_VALUE_NAME[] PROGMEM = "ExportLimitValue";
+static const char P307_H_GRID_FIRST_POWER_RATE_NAME[] PROGMEM =
+    "GridFirstPwrRate";
+static const char P307_H_GRID_FIRST_STOP_SOC_NAME[] PROGMEM = "GridFirstSOC";
+static const char P307_H_GRID_FIRST_SLOT1_START_NAME[] PROGMEM =
+    "GridSlot1Start";
+static const char P307_H_GRID_FIRST_SLOT1_STOP_NAME[] PROGMEM = "GridSlot1Stop";
+static const char P307_H_GRID_FIRST_SLOT1_ENABLED_NAME[] PROGMEM =
+    "GridSlot1En";
+static const char P307_H_GRID_FIRST_SLOT2_START_NAME[] PROGMEM =
+    "GridSlot2Start";
+static const char P307_H_GRID_FIRST_SLOT2_STOP_NAME[] PROGMEM = "GridSlot2Stop";
+static const char P307_H_GRID_FIRST_SLOT2_ENABLED_NAME[] PROGMEM =
+    "GridSlot2En";
+static const char P307_H_GRID_FIRST_SLOT3_START_NAME[] PROGMEM =
+    "GridSlot3Start";
+static const char P307_H_GRID_FIRST_SLOT3_STOP_NAME[] PROGMEM = "GridSlot3Stop";
+static const char P307_H_GRID_FIRST_SLOT3_ENABLED_NAME[] PROGMEM =
+    "GridSlot3En";
+static const char P307_H_BATTERY_FIRST_POWER_RATE_NAME[] PROGMEM =
+    "BattFirstPwrRate";
+static const char P307_H_BATTERY_FIRST_STOP_SOC_NAME[] PROGMEM = "BattFirstSOC";
+static const char P307_H_BATTERY_FIRST_AC_CHARGE_NAME[] PROGMEM =
+    "BattFirstACChrg";
+static const char P307_H_BATTERY_FIRST_SLOT1_START_NAME[] PROGMEM =
+    "BattSlot1Start";
+static const char P307_H_BATTERY_FIRST_SLOT1_STOP_NAME[] PROGMEM =
+    "BattSlot1Stop";
+static const char P307_H_BATTERY_FIRST_SLOT1_ENABLED_NAME[] PROGMEM =
+    "BattSlot1En";
+static const char P307_H_BATTERY_FIRST_SLOT2_START_NAME[] PROGMEM =
+    "BattSlot2Start";
+static const char P307_H_BATTERY_FIRST_SLOT2_STOP_NAME[] PROGMEM =
+    "BattSlot2Stop";
+static const char P307_H_BATTERY_FIRST_SLOT2_ENABLED_NAME[] PROGMEM =
+    "BattSlot2En";
+static const char P307_H_BATTERY_FIRST_SLOT3_START_NAME[] PROGMEM =
+    "BattSlot3Start";
+static const char P307_H_BATTERY_FIRST_SLOT3_STOP_NAME[] PROGMEM =
+    "BattSlot3Stop";
+static const char P307_H_BATTERY_FIRST_SLOT3_ENABLED_NAME[] PROGMEM =
+    "BattSlot3En";
+static const char P307_H_LOAD_FIRST_STOP_SOC_NAME[] PROGMEM =
+    "LoadFirstStopSOC";
+
+// address, size, name, multiplier, resolution, unit, frontend, plot
+static constexpr sGrowattRegisterDef_t P307InputRegisters[] PROGMEM = {
+    // FRAGMENT 1: BEGIN
+    {0, SIZE_16BIT, P307_I_STATUS_NAME, 1, 1, NONE, true, false,
+     &LABELS_STATUS},
+    {1, SIZE_32BIT, P307_INPUT_POWER_NAME, 0.1, 0.1, POWER_W, true, true},
+    {3, SIZE_16BIT, P307_PV1_VOLTAGE_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {4, SIZE_16BIT, P307_PV1_CURRENT_NAME, 0.1, 0.1, CURRENT, false, false},
+    {5, SIZE_32BIT, P307_PV1_POWER_NAME, 0.1, 0.1, POWER_W, false, false},
+    {7, SIZE_16BIT, P307_PV2_VOLTAGE_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {8, SIZE_16BIT, P307_PV2_CURRENT_NAME, 0.1, 0.1, CURRENT, false, false},
+    {9, SIZE_32BIT, P307_PV2_POWER_NAME, 0.1, 0.1, POWER_W, false, false},
+    {35, SIZE_32BIT_S, P307_PAC_NAME, 0.1, 0.1, POWER_W, true, true},
+    {37, SIZE_16BIT, P307_FAC_NAME, 0.01, 0.01, FREQUENCY, false, false},
+    {38, SIZE_16BIT, P307_VAC1_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {39, SIZE_16BIT, P307_IAC1_NAME, 0.1, 0.1, CURRENT, false, false},
+    {40, SIZE_32BIT, P307_PAC1_NAME, 0.1, 0.1, VA, false, false},
+    {42, SIZE_16BIT, P307_VAC2_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {43, SIZE_16BIT, P307_IAC2_NAME, 0.1, 0.1, CURRENT, false, false},
+    {44, SIZE_32BIT, P307_PAC2_NAME, 0.1, 0.1, VA, false, false},
+    {46, SIZE_16BIT, P307_VAC3_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {47, SIZE_16BIT, P307_IAC3_NAME, 0.1, 0.1, CURRENT, false, false},
+    {48, SIZE_32BIT, P307_PAC3_NAME, 0.1, 0.1, VA, false, false},
+    // FRAGMENT 1: END
+
+    // FRAGMENT 2: BEGIN
+    {53, SIZE_32BIT, P307_EAC_TODAY_NAME, 0.1, 0.1, POWER_KWH, true, false},
+    {55, SIZE_32BIT, P307_EAC_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true, false},
+    {57, SIZE_32BIT, P307_TIME_TOTAL_NAME, 0.5, 1, SECONDS, false, false},
+    {59, SIZE_32BIT, P307_EPV1_TODAY_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {61, SIZE_32BIT, P307_EPV1_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {63, SIZE_32BIT, P307_EPV2_TODAY_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {65, SIZE_32BIT, P307_EPV2_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {91, SIZE_32BIT, P307_EPV_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {93, SIZE_16BIT, P307_TEMP1_NAME, 0.1, 0.1, TEMPERATURE, true, true},
+    {94, SIZE_16BIT, P307_TEMP2_NAME, 0.1, 0.1, TEMPERATURE, false, false},
+    {95, SIZE_16BIT, P307_TEMP3_NAME, 0.1, 0.1, TEMPERATURE, false, false},
+    // FRAGMENT 2: END
+
+    // FRAGMENT 3: BEGIN
+    {1009, SIZE_32BIT, P307_PDISCHARGE_NAME, 0.1, 0.1, POWER_W, true, true},
+    {1011, SIZE_32BIT, P307_PCHARGE_NAME, 0.1, 0.1, POWER_W, true, true},
+    {1013, SIZE_16BIT, P307_VBAT_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {1014, SIZE_16BIT, P307_SOC_NAME, 1, 1, PERCENTAGE, true, true},
+    {1015, SIZE_32BIT, P307_PAC_TO_USER_NAME, 0.1, 0.1, POWER_W, false, false},
+    {1021, SIZE_32BIT, P307_PAC_TO_USER_TOTAL_NAME, 0.1, 0.1, POWER_W, false,
+     false},
+    {1023, SIZE_32BIT, P307_PAC_TO_GRID_NAME, 0.1, 0.1, POWER_W, false, false},
+    {1029, SIZE_32BIT, P307_PAC_TO_GRID_TOTAL_NAME, 0.1, 0.1, POWER_W, false,
+     false},
+    {1031, SIZE_32BIT, P307_PLOCAL_LOAD_NAME, 0.1, 0.1, POWER_W, false, false},
+    {1037, SIZE_32BIT, P307_PLOCAL_LOAD_TOTAL_NAME, 0.1, 0.1, POWER_W, true,
+     false},
+    {1040, SIZE_16BIT, P307_BATTERY_TEMPERATURE_NAME,
+     TEMPERATURE_WORKAROUND_MULTIPLIER, TEMPERATURE_WORKAROUND_MULTIPLIER,
+     TEMPERATURE, true, true},
+    {1041, SIZE_16BIT, P307_BATTERY_STATE_NAME, 1, 1, NONE, true, false},
+    {1044, SIZE_32BIT, P307_ETOUSER_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1046, SIZE_32BIT, P307_ETOUSER_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1048, SIZE_32BIT, P307_ETOGRID_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1050, SIZE_32BIT, P307_ETOGRID_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1052, SIZE_32BIT, P307_EDISCHARGE_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1054, SIZE_32BIT, P307_EDISCHARGE_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1056, SIZE_32BIT, P307_ECHARGE_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1058, SIZE_32BIT, P307_ECHARGE_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1060, SIZE_32BIT, P307_ETOLOCALLOAD_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1062, SIZE_32BIT, P307_ETOLOCALLOAD_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    // FRAGMENT 3: END
+
+    // FRAGMENT 4: START
+    {1124, SIZE_32BIT, P307_ACCHARGE_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {1126, SIZE_32BIT, P307_ACCHARGE_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    // FRAGMENT 4: END
+
+    // FRAGMENT 5: Current Mode Register
+    {118, SIZE_16BIT, P307_CURRENT_MODE_NAME, 1, 1, NONE, true, false},
+    // 0=Load-first, 1=Battery-first, 2=Grid-first
+};
+static constexpr sGrowattReadFragment_t P307InputFragments[] PROGMEM = {
+    {0, 50},
+    {53, 43},
+    {118, 1},    // Current mode
+    {1009, 55},
+    {1124, 4},
+};
+CHECK_PROTOCOL_TABLE(P307InputRegisters, P307_INPUT_REGISTER_COUNT,
+                     P307InputFragments);
+
+// address, size, name, multiplier, resolution, unit, frontend, plot
+static constexpr sGrowattRegisterDef_t P307HoldingRegisters[] PROGMEM = {
+    // FRAGMENT 1: Active Power Rate
+    {3, SIZE_16BIT, P307_Active_P_Rate_NAME, 1, 1, PERCENTAGE, true, false},
+
+    // FRAGMENT 2: System Date/Time
+    {45, SIZE_16BIT, P307_H_SYSTEM_YEAR_NAME, 1, 1, NONE, false, false},
+    {46, SIZE_16BIT, P307_H_SYSTEM_MONTH_NAME, 1, 1, NONE, false, false},
+    {47, SIZE_16BIT, P307_H_SYSTEM_DAY_NAME, 1, 1, NONE, false, false},
+    {48, SIZE_16BIT, P307_H_SYSTEM_HOUR_NAME, 1, 1, NONE, false, false},
+    {49, SIZE_16BIT, P307_H_SYSTEM_MINUTE_NAME, 1, 1, NONE, false, false},
+    {50, SIZE_16BIT, P307_H_SYSTEM_SECOND_NAME, 1, 1, NONE, false, false},
+
+    // FRAGMENT 3: Export Limit (122-123 for protocol 3.07)
+    {122, SIZE_16BIT, P307_H_EXPORT_LIMIT_ENABLED_NAME, 1, 1, NONE, true,
+     false},
+    {123, SIZE_16BIT, P307_H_EXPORT_LIMIT_VALUE_NAME, 0.1, 0.1, PERCENTAGE,
+     true, false},
+
+    // FRAGMENT 4: Grid First settings
+    {1070, SIZE_16BIT, P307_H_GRID_FIRST_POWER_RATE_NAME, 1, 1, PERCENTAGE,
+     true, false},
+    {1071, SIZE_16BIT, P307_H_GRID_FIRST_STOP_SOC_NAME, 1, 1, PERCENTAGE, true,
+     false},
+
+    // FRAGMENT 5: Grid First time slots
+    {1080, SIZE_16BIT, P307_H_GRID_FIRST_SLOT1_START_NAME, 1, 1, NONE, false,
+     false},
+    {1081, SIZE_16BIT, P307_H_GRID_FIRST_SLOT1_STOP_NAME, 1, 1, NONE, false,
+     false},
+    {1082, SIZE_16BIT, P307_H_GRID_FIRST_SLOT1_ENABLED_NAME, 1, 1, NONE, false,
+     false},
+    {1083, SIZE_16BIT, P307_H_GRID_FIRST_SLOT2_START_NAME, 1, 1, NONE, false,
+     false},
+    {1084, SIZE_16BIT, P307_H_GRID_FIRST_SLOT2_STOP_NAME, 1, 1, NONE, false,
+     false},
+    {1085, SIZE_16BIT, P307_H_GRID_FIRST_SLOT2_ENABLED_NAME, 1, 1, NONE, false,
+     false},
+    {1086, SIZE_16BIT, P307_H_GRID_FIRST_SLOT3_START_NAME, 1, 1, NONE, false,
+     false},
+    {1087, SIZE_16BIT, P307_H_GRID_FIRST_SLOT3_STOP_NAME, 1, 1, NONE, false,
+     false},
+    {1088, SIZE_16BIT, P307_H_GRID_FIRST_SLOT3_ENABLED_NAME, 1, 1, NONE, false,
+     false},
+
+    // FRAGMENT 6: Battery First settings
+    {1090, SIZE_16BIT, P307_H_BATTERY_FIRST_POWER_RATE_NAME, 1, 1, PERCENTAGE,
+     false, false},
+    {1091, SIZE_16BIT, P307_H_BATTERY_FIRST_STOP_SOC_NAME, 1, 1, PERCENTAGE,
+     false, false},
+    {1092, SIZE_16BIT, P307_H_BATTERY_FIRST_AC_CHARGE_NAME, 1, 1, NONE, false,
+     false},
+
+    // FRAGMENT 7: Battery First time slots
+    {1100, SIZE_16BIT, P307_H_BATTERY_FIRST_SLOT1_START_NAME, 1, 1, NONE, false,
+     false},
+    {1101, SIZE_16BIT, P307_H_BATTERY_FIRST_SLOT1_STOP_NAME, 1, 1, NONE, false,
+     false},
+    {1102, SIZE_16BIT, P307_H_BATTERY_FIRST_SLOT1_ENABLED_NAME, 1, 1, NONE,
+     false, false},
+    {1103, SIZE_16BIT, P307_H_BATTERY_FIRST_SLOT2_START_NAME, 1, 1, NONE, false,
+     false},
+    {1104, SIZE_16BIT, P307_H_BATTERY_FIRST_SLOT2_STOP_NAME, 1, 1, NONE, false,
+     false},
+    {1105, SIZE_16BIT, P307_H_BATTERY_FIRST_SLOT2_ENABLED_NAME, 1, 1, NONE,
+     false, false},
+    {1106, SIZE_16BIT, P307_H_BATTERY_FIRST_SLOT3_START_NAME, 1, 1, NONE, false,
+     false},
+    {1107, SIZE_16BIT, P307_H_BATTERY_FIRST_SLOT3_STOP_NAME, 1, 1, NONE, false,
+     false},
+    {1108, SIZE_16BIT, P307_H_BATTERY_FIRST_SLOT3_ENABLED_NAME, 1, 1, NONE,
+     false, false},
+
+    // FRAGMENT 8: Load First Stop SOC
+    {608, SIZE_16BIT, P307_H_LOAD_FIRST_STOP_SOC_NAME, 1, 1, PERCENTAGE, false,
+     false},
+};
+static constexpr sGrowattReadFragment_t P307HoldingFragments[] PROGMEM = {
+    {3, 1},     // Active Power Rate
+    {45, 6},    // Date/Time
+    {122, 2},   // Export Limit (122-123)
+    {608, 1},   // Load First Stop SOC
+    {1070, 2},  // Grid First settings
+    {1080, 9},  // Grid First time slots
+    {1090, 3},  // Battery First settings
+    {1100, 9},  // Battery First time slots
+};
+CHECK_PROTOCOL_TABLE(P307HoldingRegisters, P307_HOLDING_REGISTER_COUNT,
+                     P307HoldingFragments);
+
+// first address, last address, groups
+static constexpr sGrowattRegisterGroup_t P307InputGroups[] PROGMEM = {
+    {0, 0, GroupStatus},
+    {1, 9, GroupPv},
+    {35, 48, GroupGrid},
+    {53, 55, GroupEnergy},
+    {57, 57, GroupDiagnostics},
+    {59, 91, GroupPv | GroupEnergy},
+    {93, 95, GroupDiagnostics},
+    {118, 118, GroupStatus},
+    {1009, 1014, GroupBattery},
+    {1015, 1029, GroupGrid},
+    {1031, 1037, GroupLoad},
+    {1040, 1041, GroupBattery},
+    {1044, 1050, GroupGrid | GroupEnergy},
+    {1052, 1058, GroupBattery | GroupEnergy},
+    {1060, 1062, GroupLoad | GroupEnergy},
+    {1124, 1126, GroupBattery | GroupEnergy},
+};
+CHECK_GROUP_TABLE(P307InputGroups);
+static constexpr sGrowattRegisterGroup_t P307HoldingGroups[] PROGMEM = {
+    {0, 0xFFFF, GroupSettings},
+};
+CHECK_GROUP_TABLE(P307HoldingGroups);
+
 void init_growatt307(sProtocolDefinition_t& Protocol, Growatt& inverter) {
-  // definition of input registers
   Protocol.InputRegisterCount = P307_INPUT_REGISTER_COUNT;
-  // address, value, size, name, multiplier, unit, frontend, plot
-  // FRAGMENT 1: BEGIN
-  Protocol.InputRegisters[P307_I_STATUS] = sGrowattModbusReg_t{
-      0, 0, SIZE_16BIT, F("InverterStatus"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P307_INPUT_POWER] = sGrowattModbusReg_t{
-      1, 0, SIZE_32BIT, F("InputPower"), 0.1, 0.1, POWER_W, true, true};
-
-  Protocol.InputRegisters[P307_PV1_VOLTAGE] = sGrowattModbusReg_t{
-      3, 0, SIZE_16BIT, F("PV1Voltage"), 0.1, 0.1, VOLTAGE, false, false};
-  Protocol.InputRegisters[P307_PV1_CURRENT] = sGrowattModbusReg_t{
-      4, 0, SIZE_16BIT, F("PV1InputCurrent"), 0.1, 0.1, CURRENT, false, false};
-  Protocol.InputRegisters[P307_PV1_POWER] = sGrowattModbusReg_t{
-      5, 0, SIZE_32BIT, F("PV1InputPower"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P307_PV2_VOLTAGE] = sGrowattModbusReg_t{
-      7, 0, SIZE_16BIT, F("PV2Voltage"), 0.1, 0.1, VOLTAGE, false, false};
-  Protocol.InputRegisters[P307_PV2_CURRENT] = sGrowattModbusReg_t{
-      8, 0, SIZE_16BIT, F("PV2InputCurrent"), 0.1, 0.1, CURRENT, false, false};
-  Protocol.InputRegisters[P307_PV2_POWER] = sGrowattModbusReg_t{
-      9, 0, SIZE_32BIT, F("PV2InputPower"), 0.1, 0.1, POWER_W, false, false};
-
-  Protocol.InputRegisters[P307_PAC] = sGrowattModbusReg_t{
-      35, 0, SIZE_32BIT_S, F("OutputPower"), 0.1, 0.1, POWER_W, true, true};
-  Protocol.InputRegisters[P307_FAC] = sGrowattModbusReg_t{
-      37,        0,     SIZE_16BIT, F("GridFrequency"), 0.01, 0.01,
-      FREQUENCY, false, false};
-
-  Protocol.InputRegisters[P307_VAC1] = sGrowattModbusReg_t{
-      38,      0,     SIZE_16BIT, F("L1ThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P307_IAC1] = sGrowattModbusReg_t{
-      39,      0,     SIZE_16BIT, F("L1ThreePhaseGridOutputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P307_PAC1] = sGrowattModbusReg_t{
-      40, 0,     SIZE_32BIT, F("L1ThreePhaseGridOutputPower"), 0.1, 0.1,
-      VA, false, false};
-  Protocol.InputRegisters[P307_VAC2] = sGrowattModbusReg_t{
-      42,      0,     SIZE_16BIT, F("L2ThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P307_IAC2] = sGrowattModbusReg_t{
-      43,      0,     SIZE_16BIT, F("L2ThreePhaseGridOutputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P307_PAC2] = sGrowattModbusReg_t{
-      44, 0,     SIZE_32BIT, F("L2ThreePhaseGridOutputPower"), 0.1, 0.1,
-      VA, false, false};
-  Protocol.InputRegisters[P307_VAC3] = sGrowattModbusReg_t{
-      46,      0,     SIZE_16BIT, F("L3ThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P307_IAC3] = sGrowattModbusReg_t{
-      47,      0,     SIZE_16BIT, F("L3ThreePhaseGridOutputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P307_PAC3] = sGrowattModbusReg_t{
-      48, 0,     SIZE_32BIT, F("L3ThreePhaseGridOutputPower"), 0.1, 0.1,
-      VA, false, false};
-  // FRAGMENT 1: END
-
-  // FRAGMENT 2: BEGIN
-  Protocol.InputRegisters[P307_EAC_TODAY] = sGrowattModbusReg_t{
-      53,        0,    SIZE_32BIT, F("TodayGenerateEnergy"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_EAC_TOTAL] = sGrowattModbusReg_t{
-      55,        0,    SIZE_32BIT, F("TotalGenerateEnergy"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_TIME_TOTAL] = sGrowattModbusReg_t{
-      57, 0, SIZE_32BIT, F("TWorkTimeTotal"), 0.5, 1, SECONDS, false, false};
-
-  Protocol.InputRegisters[P307_EPV1_TODAY] = sGrowattModbusReg_t{
-      59,        0,     SIZE_32BIT, F("PV1EnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P307_EPV1_TOTAL] = sGrowattModbusReg_t{
-      61,        0,     SIZE_32BIT, F("PV1EnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P307_EPV2_TODAY] = sGrowattModbusReg_t{
-      63,        0,     SIZE_32BIT, F("PV2EnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P307_EPV2_TOTAL] = sGrowattModbusReg_t{
-      65,        0,     SIZE_32BIT, F("PV2EnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P307_EPV_TOTAL] = sGrowattModbusReg_t{
-      91, 0, SIZE_32BIT, F("PVEnergyTotal"), 0.1, 0.1, POWER_KWH, false, false};
-
-  Protocol.InputRegisters[P307_TEMP1] = sGrowattModbusReg_t{
-      93,          0,    SIZE_16BIT, F("InverterTemperature"), 0.1, 0.1,
-      TEMPERATURE, true, true};
-  Protocol.InputRegisters[P307_TEMP2] = sGrowattModbusReg_t{
-      94,          0,     SIZE_16BIT, F("TemperatureInsideIPM"), 0.1, 0.1,
-      TEMPERATURE, false, false};
-  Protocol.InputRegisters[P307_TEMP3] = sGrowattModbusReg_t{
-      95,          0,     SIZE_16BIT, F("BoostTemperature"), 0.1, 0.1,
-      TEMPERATURE, false, false};
-  // FRAGMENT 2: END
-
-  // FRAGMENT 3: BEGIN
-  Protocol.InputRegisters[P307_PDISCHARGE] = sGrowattModbusReg_t{
-      1009, 0, SIZE_32BIT, F("DischargePower"), 0.1, 0.1, POWER_W, true, true};
-  Protocol.InputRegisters[P307_PCHARGE] = sGrowattModbusReg_t{
-      1011, 0, SIZE_32BIT, F("ChargePower"), 0.1, 0.1, POWER_W, true, true};
-  Protocol.InputRegisters[P307_VBAT] = sGrowattModbusReg_t{
-      1013,    0,     SIZE_16BIT, F("BatteryVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P307_SOC] = sGrowattModbusReg_t{
-      1014, 0, SIZE_16BIT, F("SOC"), 1, 1, PERCENTAGE, true, true};
-  Protocol.InputRegisters[P307_PAC_TO_USER] = sGrowattModbusReg_t{
-      1015, 0, SIZE_32BIT, F("ACPowerToUser"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P307_PAC_TO_USER_TOTAL] = sGrowattModbusReg_t{
-      1021,    0,     SIZE_32BIT, F("ACPowerToUserTotal"), 0.1, 0.1,
-      POWER_W, false, false};
-  Protocol.InputRegisters[P307_PAC_TO_GRID] = sGrowattModbusReg_t{
-      1023, 0, SIZE_32BIT, F("ACPowerToGrid"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P307_PAC_TO_GRID_TOTAL] = sGrowattModbusReg_t{
-      1029,    0,     SIZE_32BIT, F("ACPowerToGridTotal"), 0.1, 0.1,
-      POWER_W, false, false};
-  Protocol.InputRegisters[P307_PLOCAL_LOAD] = sGrowattModbusReg_t{
-      1031,    0,     SIZE_32BIT, F("INVPowerToLocalLoad"), 0.1, 0.1,
-      POWER_W, false, false};
-  Protocol.InputRegisters[P307_PLOCAL_LOAD_TOTAL] = sGrowattModbusReg_t{
-      1037,    0,    SIZE_32BIT, F("INVPowerToLocalLoadTotal"), 0.1, 0.1,
-      POWER_W, true, false};
-  Protocol.InputRegisters[P307_BATTERY_TEMPERATURE] =
-      sGrowattModbusReg_t{1040,
-                          0,
-                          SIZE_16BIT,
-                          F("BatteryTemperature"),
-                          TEMPERATURE_WORKAROUND_MULTIPLIER,
-                          TEMPERATURE_WORKAROUND_MULTIPLIER,
-                          TEMPERATURE,
-                          true,
-                          true};
-  Protocol.InputRegisters[P307_BATTERY_STATE] = sGrowattModbusReg_t{
-      1041, 0, SIZE_16BIT, F("BatteryState"), 1, 1, NONE, true, false};
-
-  Protocol.InputRegisters[P307_ETOUSER_TODAY] = sGrowattModbusReg_t{
-      1044,      0,    SIZE_32BIT, F("EnergyToUserToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_ETOUSER_TOTAL] = sGrowattModbusReg_t{
-      1046,      0,    SIZE_32BIT, F("EnergyToUserTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_ETOGRID_TODAY] = sGrowattModbusReg_t{
-      1048,      0,    SIZE_32BIT, F("EnergyToGridToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_ETOGRID_TOTAL] = sGrowattModbusReg_t{
-      1050,      0,    SIZE_32BIT, F("EnergyToGridTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_EDISCHARGE_TODAY] = sGrowattModbusReg_t{
-      1052,      0,    SIZE_32BIT, F("DischargeEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_EDISCHARGE_TOTAL] = sGrowattModbusReg_t{
-      1054,      0,    SIZE_32BIT, F("DischargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_ECHARGE_TODAY] = sGrowattModbusReg_t{
-      1056,      0,    SIZE_32BIT, F("ChargeEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_ECHARGE_TOTAL] = sGrowattModbusReg_t{
-      1058,      0,    SIZE_32BIT, F("ChargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_ETOLOCALLOAD_TODAY] = sGrowattModbusReg_t{
-      1060,      0,    SIZE_32BIT, F("LocalLoadEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_ETOLOCALLOAD_TOTAL] = sGrowattModbusReg_t{
-      1062,      0,    SIZE_32BIT, F("LocalLoadEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  // FRAGMENT 3: END
-
-  // FRAGMENT 4: START
-  Protocol.InputRegisters[P307_ACCHARGE_TODAY] = sGrowattModbusReg_t{
-      1124,      0,    SIZE_32BIT, F("ACChargeEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P307_ACCHARGE_TOTAL] = sGrowattModbusReg_t{
-      1126,      0,    SIZE_32BIT, F("ACChargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  // FRAGMENT 4: END
-
-  // FRAGMENT 5: Current Mode Register
-  Protocol.InputRegisters[P307_CURRENT_MODE] = sGrowattModbusReg_t{
-      118, 0, SIZE_16BIT, F("CurrentMode"), 1, 1, NONE, true, false};
-  // 0=Load-first, 1=Battery-first, 2=Grid-first
-
-  Protocol.InputFragmentCount = 5;
-  Protocol.InputReadFragments[0] = sGrowattReadFragment_t{0, 50};
-  Protocol.InputReadFragments[1] = sGrowattReadFragment_t{53, 43};
-  Protocol.InputReadFragments[2] =
-      sGrowattReadFragment_t{118, 1};  // Current mode
-  Protocol.InputReadFragments[3] = sGrowattReadFragment_t{1009, 55};
-  Protocol.InputReadFragments[4] = sGrowattReadFragment_t{1124, 4};
-
-  // definition of holding registers
-  Protocol.HoldingRegisterCount = P307_HOLDING_REGISTER_COUNT;
+  Protocol.InputRegisters = P307InputRegisters;
+  Protocol.InputFragmentCount = tableSize(P307InputFragments);
+  Protocol.InputReadFragments = P307InputFragments;
 
-  // FRAGMENT 1: Active Power Rate
-  Protocol.HoldingRegisters[P307_Active_P_Rate] = sGrowattModbusReg_t{
-      3, 0, SIZE_16BIT, F("ActivePowerRate"), 1, 1, PERCENTAGE, true, false};
-
-  // FRAGMENT 2: System Date/Time
-  Protocol.HoldingRegisters[P307_H_SYSTEM_YEAR] = sGrowattModbusReg_t{
-      45, 0, SIZE_16BIT, F("SystemYear"), 1, 1, NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_SYSTEM_MONTH] = sGrowattModbusReg_t{
-      46, 0, SIZE_16BIT, F("SystemMonth"), 1, 1, NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_SYSTEM_DAY] = sGrowattModbusReg_t{
-      47, 0, SIZE_16BIT, F("SystemDay"), 1, 1, NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_SYSTEM_HOUR] = sGrowattModbusReg_t{
-      48, 0, SIZE_16BIT, F("SystemHour"), 1, 1, NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_SYSTEM_MINUTE] = sGrowattModbusReg_t{
-      49, 0, SIZE_16BIT, F("SystemMinute"), 1, 1, NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_SYSTEM_SECOND] = sGrowattModbusReg_t{
-      50, 0, SIZE_16BIT, F("SystemSecond"), 1, 1, NONE, false, false};
-
-  // FRAGMENT 3: Export Limit (122-123 for protocol 3.07)
-  Protocol.HoldingRegisters[P307_H_EXPORT_LIMIT_ENABLED] = sGrowattModbusReg_t{
-      122, 0, SIZE_16BIT, F("ExportLimitFlag"), 1, 1, NONE, true, false};
-  Protocol.HoldingRegisters[P307_H_EXPORT_LIMIT_VALUE] = sGrowattModbusReg_t{
-      123,        0,    SIZE_16BIT, F("ExportLimitValue"), 0.1, 0.1,
-      PERCENTAGE, true, false};
-
-  // FRAGMENT 4: Grid First settings
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_POWER_RATE] = sGrowattModbusReg_t{
-      1070,       0,    SIZE_16BIT, F("GridFirstPwrRate"), 1, 1,
-      PERCENTAGE, true, false};
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_STOP_SOC] = sGrowattModbusReg_t{
-      1071, 0, SIZE_16BIT, F("GridFirstSOC"), 1, 1, PERCENTAGE, true, false};
-
-  // FRAGMENT 5: Grid First time slots
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_SLOT1_START] =
-      sGrowattModbusReg_t{1080, 0,     SIZE_16BIT, F("GridSlot1Start"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_SLOT1_STOP] = sGrowattModbusReg_t{
-      1081, 0, SIZE_16BIT, F("GridSlot1Stop"), 1, 1, NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_SLOT1_ENABLED] =
-      sGrowattModbusReg_t{1082, 0,     SIZE_16BIT, F("GridSlot1En"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_SLOT2_START] =
-      sGrowattModbusReg_t{1083, 0,     SIZE_16BIT, F("GridSlot2Start"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_SLOT2_STOP] = sGrowattModbusReg_t{
-      1084, 0, SIZE_16BIT, F("GridSlot2Stop"), 1, 1, NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_SLOT2_ENABLED] =
-      sGrowattModbusReg_t{1085, 0,     SIZE_16BIT, F("GridSlot2En"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_SLOT3_START] =
-      sGrowattModbusReg_t{1086, 0,     SIZE_16BIT, F("GridSlot3Start"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_SLOT3_STOP] = sGrowattModbusReg_t{
-      1087, 0, SIZE_16BIT, F("GridSlot3Stop"), 1, 1, NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_GRID_FIRST_SLOT3_ENABLED] =
-      sGrowattModbusReg_t{1088, 0,     SIZE_16BIT, F("GridSlot3En"), 1, 1,
-                          NONE, false, false};
-
-  // FRAGMENT 6: Battery First settings
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_POWER_RATE] =
-      sGrowattModbusReg_t{1090, 0, SIZE_16BIT, F("BattFirstPwrRate"),
-                          1,    1, PERCENTAGE, false,
-                          false};
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_STOP_SOC] =
-      sGrowattModbusReg_t{1091, 0, SIZE_16BIT, F("BattFirstSOC"),
-                          1,    1, PERCENTAGE, false,
-                          false};
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_AC_CHARGE] =
-      sGrowattModbusReg_t{1092, 0,     SIZE_16BIT, F("BattFirstACChrg"), 1, 1,
-                          NONE, false, false};
-
-  // FRAGMENT 7: Battery First time slots
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_SLOT1_START] =
-      sGrowattModbusReg_t{1100, 0,     SIZE_16BIT, F("BattSlot1Start"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_SLOT1_STOP] =
-      sGrowattModbusReg_t{1101, 0,     SIZE_16BIT, F("BattSlot1Stop"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_SLOT1_ENABLED] =
-      sGrowattModbusReg_t{1102, 0,     SIZE_16BIT, F("BattSlot1En"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_SLOT2_START] =
-      sGrowattModbusReg_t{1103, 0,     SIZE_16BIT, F("BattSlot2Start"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_SLOT2_STOP] =
-      sGrowattModbusReg_t{1104, 0,     SIZE_16BIT, F("BattSlot2Stop"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_SLOT2_ENABLED] =
-      sGrowattModbusReg_t{1105, 0,     SIZE_16BIT, F("BattSlot2En"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_SLOT3_START] =
-      sGrowattModbusReg_t{1106, 0,     SIZE_16BIT, F("BattSlot3Start"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_SLOT3_STOP] =
-      sGrowattModbusReg_t{1107, 0,     SIZE_16BIT, F("BattSlot3Stop"), 1, 1,
-                          NONE, false, false};
-  Protocol.HoldingRegisters[P307_H_BATTERY_FIRST_SLOT3_ENABLED] =
-      sGrowattModbusReg_t{1108, 0,     SIZE_16BIT, F("BattSlot3En"), 1, 1,
-                          NONE, false, false};
-
-  // FRAGMENT 8: Load First Stop SOC
-  Protocol.HoldingRegisters[P307_H_LOAD_FIRST_STOP_SOC] = sGrowattModbusReg_t{
-      608,        0,     SIZE_16BIT, F("LoadFirstStopSOC"), 1, 1,
-      PERCENTAGE, false, false};
-
-  Protocol.HoldingFragmentCount = 8;
-  Protocol.HoldingReadFragments[0] =
-      sGrowattReadFragment_t{3, 1};  // Active Power Rate
-  Protocol.HoldingReadFragments[1] =
-      sGrowattReadFragment_t{45, 6};  // Date/Time
-  Protocol.HoldingReadFragments[2] =
-      sGrowattReadFragment_t{122, 2};  // Export Limit (122-123)
-  Protocol.HoldingReadFragments[3] =
-      sGrowattReadFragment_t{608, 1};  // Load First Stop SOC
-  Protocol.HoldingReadFragments[4] =
-      sGrowattReadFragment_t{1070, 2};  // Grid First settings
-  Protocol.HoldingReadFragments[5] =
-      sGrowattReadFragment_t{1080, 9};  // Grid First time slots
-  Protocol.HoldingReadFragments[6] =
-      sGrowattReadFragment_t{1090, 3};  // Battery First settings
-  Protocol.HoldingReadFragments[7] =
-      sGrowattReadFragment_t{1100, 9};  // Battery First time slots
+  Protocol.HoldingRegisterCount = P307_HOLDING_REGISTER_COUNT;
+  Protocol.HoldingRegisters = P307HoldingRegisters;
+  Protocol.HoldingFragmentCount = tableSize(P307HoldingFragments);
+  Protocol.HoldingReadFragments = P307HoldingFragments;
+
+  Protocol.InputGroupCount = tableSize(P307InputGroups);
+  Protocol.InputGroups = P307InputGroups;
+  Protocol.HoldingGroupCount = tableSize(P307HoldingGroups);
+  Protocol.HoldingGroups = P307HoldingGroups;
 
   // definition of commands
   inverter.RegisterCommand("datetime/get", getDateTime307);
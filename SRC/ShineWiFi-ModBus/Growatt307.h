@@ -73,8 +73,19 @@ typedef enum {
   P307_H_SYSTEM_HOUR,
   P307_H_SYSTEM_MINUTE,
   P307_H_SYSTEM_SECOND,
-  P307_H_EXPORT_LIMIT_VALUE,
   P307_H_EXPORT_LIMIT_ENABLED,
+  P307_H_EXPORT_LIMIT_VALUE,
+  P307_H_GRID_FIRST_POWER_RATE,
+  P307_H_GRID_FIRST_STOP_SOC,
+  P307_H_GRID_FIRST_SLOT1_START,
+  P307_H_GRID_FIRST_SLOT1_STOP,
+  P307_H_GRID_FIRST_SLOT1_ENABLED,
+  P307_H_GRID_FIRST_SLOT2_START,
+  P307_H_GRID_FIRST_SLOT2_STOP,
+  P307_H_GRID_FIRST_SLOT2_ENABLED,
+  P307_H_GRID_FIRST_SLOT3_START,
+  P307_H_GRID_FIRST_SLOT3_STOP,
+  P307_H_GRID_FIRST_SLOT3_ENABLED,
   P307_H_BATTERY_FIRST_POWER_RATE,
   P307_H_BATTERY_FIRST_STOP_SOC,
   P307_H_BATTERY_FIRST_AC_CHARGE,
@@ -87,17 +98,6 @@ typedef enum {
   P307_H_BATTERY_FIRST_SLOT3_START,
   P307_H_BATTERY_FIRST_SLOT3_STOP,
   P307_H_BATTERY_FIRST_SLOT3_ENABLED,
-  P307_H_GRID_FIRST_POWER_RATE,
-  P307_H_GRID_FIRST_STOP_SOC,
-  P307_H_GRID_FIRST_SLOT1_START,
-  P307_H_GRID_FIRST_SLOT1_STOP,
-  P307_H_GRID_FIRST_SLOT1_ENABLED,
-  P307_H_GRID_FIRST_SLOT2_START,
-  P307_H_GRID_FIRST_SLOT2_STOP,
-  P307_H_GRID_FIRST_SLOT2_ENABLED,
-  P307_H_GRID_FIRST_SLOT3_START,
-  P307_H_GRID_FIRST_SLOT3_STOP,
-  P307_H_GRID_FIRST_SLOT3_ENABLED,
   P307_H_LOAD_FIRST_STOP_SOC,
   P307_HOLDING_REGISTER_COUNT
 } eP307HoldingRegisters_t;
@@ -51,6 +51,7 @@ typedef enum {
   BP_BAT_PERCENTAGE,
   BP_BAT_CHARGE_POWER,
   BP_BAT_DISCHARGE_POWER,
-} eP305InputRegisters_t;
+  BP_INPUT_REGISTER_COUNT
+} eBPInputRegisters_t;
 
 void init_growattBP(sProtocolDefinition_t& Protocol, Growatt& inverter);
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "GrowattTypes.h"
+
+// Labels of enum registers, referenced by the protocol tables
+
+static const char LABEL_WAITING[] PROGMEM = "Waiting";
+static const char LABEL_NORMAL[] PROGMEM = "Normal Operation";
+static const char LABEL_ERROR[] PROGMEM = "Error";
+static const char* const STATUS_LABELS[] PROGMEM = {LABEL_WAITING,
+                                                    LABEL_NORMAL, NULL,
+                                                    LABEL_ERROR};
+const sGrowattLabelTable_t LABELS_STATUS PROGMEM = {tableSize(STATUS_LABELS),
+                                                    STATUS_LABELS};
+
+static const char LABEL_LOAD_FIRST[] PROGMEM = "Load First";
+static const char LABEL_BATTERY_FIRST[] PROGMEM = "Battery First";
+static const char LABEL_GRID_FIRST[] PROGMEM = "Grid First";
+static const char* const PRIORITY_LABELS[] PROGMEM = {
+    LABEL_LOAD_FIRST, LABEL_BATTERY_FIRST, LABEL_GRID_FIRST};
+const sGrowattLabelTable_t LABELS_PRIORITY PROGMEM = {
+    tableSize(PRIORITY_LABELS), PRIORITY_LABELS};
+
+static const char LABEL_IDLE[] PROGMEM = "idle";
+static const char LABEL_CHARGING[] PROGMEM = "charging";
+static const char LABEL_DISCHARGING[] PROGMEM = "discharging";
+static const char* const BDC_MODE_LABELS[] PROGMEM = {
+    LABEL_IDLE, LABEL_CHARGING, LABEL_DISCHARGING};
+const sGrowattLabelTable_t LABELS_BDC_MODE PROGMEM = {
+    tableSize(BDC_MODE_LABELS), BDC_MODE_LABELS};
+
+const sGrowattLabelTable_t* const GROWATT_LABEL_TABLES[LabelsCount] = {
+    NULL, &LABELS_STATUS, &LABELS_PRIORITY, &LABELS_BDC_MODE};
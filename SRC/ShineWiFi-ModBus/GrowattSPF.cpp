@@ -7,87 +7,102 @@
    Replacing ShineWifi-F "USB" stick
 */
 
-void init_growattSPF(sProtocolDefinition_t& Protocol, Growatt& inverter) {
-  // definition of input registers
-  Protocol.InputRegisterCount = 27;
-  // address, value, size, name, multiplier, unit, frontend, plot
-  Protocol.InputRegisters[SPF_I_STATUS] = sGrowattModbusReg_t{
-      0, 0, SIZE_16BIT, F("InverterStatus"), 1, 1, NONE, true, false};  // #1
-  Protocol.InputRegisters[SPF_PV1_V] = sGrowattModbusReg_t{
-      1, 0, SIZE_16BIT, F("PV1Voltage"), 0.1, 0.1, VOLTAGE, true, false};  // #2
-  Protocol.InputRegisters[SPF_PV2_V] = sGrowattModbusReg_t{
-      2, 0, SIZE_16BIT, F("PV2Voltage"), 0.1, 0.1, VOLTAGE, true, false};  // #3
-  Protocol.InputRegisters[SPF_PV1_CHGW] = sGrowattModbusReg_t{
-      3,       0,    SIZE_32BIT, F("PV1ChargePwr"), 0.1, 0.1,
-      POWER_W, true, false};  // #4
-  Protocol.InputRegisters[SPF_PV2_CHGW] = sGrowattModbusReg_t{
-      5,       0,    SIZE_32BIT, F("PV2ChargePwr"), 0.1, 0.1,
-      POWER_W, true, false};  // #5
-  Protocol.InputRegisters[SPF_BUCK1_I] = sGrowattModbusReg_t{
-      7,       0,    SIZE_16BIT, F("Buck1Current"), 0.1, 0.1,
-      CURRENT, true, false};  // #6
-  Protocol.InputRegisters[SPF_BUCK2_I] = sGrowattModbusReg_t{
-      8,       0,    SIZE_16BIT, F("Buck2Current"), 0.1, 0.1,
-      CURRENT, true, false};  // #7
-  Protocol.InputRegisters[SPF_OUT_PWR] = sGrowattModbusReg_t{
-      9,       0,    SIZE_32BIT, F("OutActivePwr"), 0.1, 0.1,
-      POWER_W, true, true};  // #8
-  Protocol.InputRegisters[SPF_OUT_VA] = sGrowattModbusReg_t{
-      11, 0, SIZE_32BIT, F("OutVA"), 0.1, 0.1, VA, true, false};  // #9
-  Protocol.InputRegisters[SPF_AC_CHGPWR] =
-      sGrowattModbusReg_t{13,      0,    SIZE_32BIT, F("ACChargePwr"), 0.1, 0.1,
-                          POWER_W, true, true};  // #10
-  Protocol.InputRegisters[SPF_AC_CHGVA] = sGrowattModbusReg_t{
-      15, 0, SIZE_32BIT, F("ACChargeVA"), 0.1, 0.1, VA, true, false};  // #11
-  Protocol.InputRegisters[SPF_BATT_V] = sGrowattModbusReg_t{
-      17,      0,    SIZE_16BIT, F("BattVoltage"), 0.01, 0.01,
-      VOLTAGE, true, false};  // #12
-  Protocol.InputRegisters[SPF_BATT_SOC] = sGrowattModbusReg_t{
-      18, 0, SIZE_16BIT, F("BattSOC"), 1, 1, PERCENTAGE, true, false};  // #13
-  Protocol.InputRegisters[SPF_BUS_V] =
-      sGrowattModbusReg_t{19,      0,    SIZE_16BIT, F("BusVoltage"), 0.1, 0.1,
-                          VOLTAGE, true, false};  // #14
-  Protocol.InputRegisters[SPF_GRID_V] = sGrowattModbusReg_t{
-      20,      0,    SIZE_16BIT, F("GridInVoltage"), 0.1, 0.1,
-      VOLTAGE, true, false};  // #15
-  Protocol.InputRegisters[SPF_LINE_F] = sGrowattModbusReg_t{
-      21,        0,    SIZE_16BIT, F("LineFrequency"), 0.01, 0.01,
-      FREQUENCY, true, false};  // #16
-  Protocol.InputRegisters[SPF_OUT_V] =
-      sGrowattModbusReg_t{22,      0,    SIZE_16BIT, F("OutVoltage"), 0.1, 0.1,
-                          VOLTAGE, true, false};  // #17
-  Protocol.InputRegisters[SPF_OUT_F] = sGrowattModbusReg_t{
-      23,        0,    SIZE_16BIT, F("OutFrequency"), 0.01, 0.01,
-      FREQUENCY, true, false};  // #18
-  Protocol.InputRegisters[SPF_OUT_DCV] = sGrowattModbusReg_t{
-      24,      0,    SIZE_16BIT, F("OutDCVoltage"), 0.1, 0.1,
-      VOLTAGE, true, false};  // #19
-  Protocol.InputRegisters[SPF_INV_T] = sGrowattModbusReg_t{
-      25,          0,    SIZE_16BIT, F("InverterTemp"), 0.1, 0.1,
-      TEMPERATURE, true, false};  // #20
-  Protocol.InputRegisters[SPF_DCDC_T] =
-      sGrowattModbusReg_t{26,  0,           SIZE_16BIT, F("DCDCTemp"), 0.1,
-                          0.1, TEMPERATURE, true,       false};  // #21
-  Protocol.InputRegisters[SPF_LOAD] = sGrowattModbusReg_t{
-      27,         0,    SIZE_16BIT, F("LoadPercent"), 0.1, 0.1,
-      PERCENTAGE, true, false};  // #22
-  Protocol.InputRegisters[SPF_BUCK1_T] =
-      sGrowattModbusReg_t{32,  0,           SIZE_16BIT, F("Buck1Temp"), 0.1,
-                          0.1, TEMPERATURE, true,       false};  // #23
-  Protocol.InputRegisters[SPF_BUCK2_T] =
-      sGrowattModbusReg_t{33,  0,           SIZE_16BIT, F("Buck2Temp"), 0.1,
-                          0.1, TEMPERATURE, true,       false};  // #24
-  Protocol.InputRegisters[SPF_AC_INPWR] = sGrowattModbusReg_t{
-      36, 0, SIZE_32BIT, F("ACInPwr"), 0.1, 0.1, POWER_W, true, true};  // #25
-  Protocol.InputRegisters[SPF_AC_INVA] = sGrowattModbusReg_t{
-      38, 0, SIZE_32BIT, F("ACInVA"), 0.1, 0.1, VA, true, false};  // #26
-  Protocol.InputRegisters[SPF_BATT_PWR] = sGrowattModbusReg_t{
-      77, 0, SIZE_32BIT, F("BattPwr"), 0.1, 0.1, POWER_W, true, false};  // #27
+static const char SPF_I_STATUS_NAME[] PROGMEM = "InverterStatus";
+static const char SPF_PV1_V_NAME[] PROGMEM = "PV1Voltage";
+static const char SPF_PV2_V_NAME[] PROGMEM = "PV2Voltage";
+static const char SPF_PV1_CHGW_NAME[] PROGMEM = "PV1ChargePwr";
+static const char SPF_PV2_CHGW_NAME[] PROGMEM = "PV2ChargePwr";
+static const char SPF_BUCK1_I_NAME[] PROGMEM = "Buck1Current";
+static const char SPF_BUCK2_I_NAME[] PROGMEM = "Buck2Current";
+static const char SPF_OUT_PWR_NAME[] PROGMEM = "OutActivePwr";
+static const char SPF_OUT_VA_NAME[] PROGMEM = "OutVA";
+static const char SPF_AC_CHGPWR_NAME[] PROGMEM = "ACChargePwr";
+static const char SPF_AC_CHGVA_NAME[] PROGMEM = "ACChargeVA";
+static const char SPF_BATT_V_NAME[] PROGMEM = "BattVoltage";
+static const char SPF_BATT_SOC_NAME[] PROGMEM = "BattSOC";
+static const char SPF_BUS_V_NAME[] PROGMEM = "BusVoltage";
+static const char SPF_GRID_V_NAME[] PROGMEM = "GridInVoltage";
+static const char SPF_LINE_F_NAME[] PROGMEM = "LineFrequency";
+static const char SPF_OUT_V_NAME[] PROGMEM = "OutVoltage";
+static const char SPF_OUT_F_NAME[] PROGMEM = "OutFrequency";
+static const char SPF_OUT_DCV_NAME[] PROGMEM = "OutDCVoltage";
+static const char SPF_INV_T_NAME[] PROGMEM = "InverterTemp";
+static const char SPF_DCDC_T_NAME[] PROGMEM = "DCDCTemp";
+static const char SPF_LOAD_NAME[] PROGMEM = "LoadPercent";
+static const char SPF_BUCK1_T_NAME[] PROGMEM = "Buck1Temp";
+static const char SPF_BUCK2_T_NAME[] PROGMEM = "Buck2Temp";
+static const char SPF_AC_INPWR_NAME[] PROGMEM = "ACInPwr";
+static const char SPF_AC_INVA_NAME[] PROGMEM = "ACInVA";
+static const char SPF_BATT_PWR_NAME[] PROGMEM = "BattPwr";
+
+// address, size, name, multiplier, resolution, unit, frontend, plot
+static constexpr sGrowattRegisterDef_t SPFInputRegisters[] PROGMEM = {
+    {0, SIZE_16BIT, SPF_I_STATUS_NAME, 1, 1, NONE, true, false, &LABELS_STATUS},
+    {1, SIZE_16BIT, SPF_PV1_V_NAME, 0.1, 0.1, VOLTAGE, true, false},
+    {2, SIZE_16BIT, SPF_PV2_V_NAME, 0.1, 0.1, VOLTAGE, true, false},
+    {3, SIZE_32BIT, SPF_PV1_CHGW_NAME, 0.1, 0.1, POWER_W, true, false},
+    {5, SIZE_32BIT, SPF_PV2_CHGW_NAME, 0.1, 0.1, POWER_W, true, false},
+    {7, SIZE_16BIT, SPF_BUCK1_I_NAME, 0.1, 0.1, CURRENT, true, false},
+    {8, SIZE_16BIT, SPF_BUCK2_I_NAME, 0.1, 0.1, CURRENT, true, false},
+    {9, SIZE_32BIT, SPF_OUT_PWR_NAME, 0.1, 0.1, POWER_W, true, true},
+    {11, SIZE_32BIT, SPF_OUT_VA_NAME, 0.1, 0.1, VA, true, false},
+    {13, SIZE_32BIT, SPF_AC_CHGPWR_NAME, 0.1, 0.1, POWER_W, true, true},
+    {15, SIZE_32BIT, SPF_AC_CHGVA_NAME, 0.1, 0.1, VA, true, false},
+    {17, SIZE_16BIT, SPF_BATT_V_NAME, 0.01, 0.01, VOLTAGE, true, false},
+    {18, SIZE_16BIT, SPF_BATT_SOC_NAME, 1, 1, PERCENTAGE, true, false},
+    {19, SIZE_16BIT, SPF_BUS_V_NAME, 0.1, 0.1, VOLTAGE, true, false},
+    {20, SIZE_16BIT, SPF_GRID_V_NAME, 0.1, 0.1, VOLTAGE, true, false},
+    {21, SIZE_16BIT, SPF_LINE_F_NAME, 0.01, 0.01, FREQUENCY, true, false},
+    {22, SIZE_16BIT, SPF_OUT_V_NAME, 0.1, 0.1, VOLTAGE, true, false},
+    {23, SIZE_16BIT, SPF_OUT_F_NAME, 0.01, 0.01, FREQUENCY, true, false},
+    {24, SIZE_16BIT, SPF_OUT_DCV_NAME, 0.1, 0.1, VOLTAGE, true, false},
+    {25, SIZE_16BIT, SPF_INV_T_NAME, 0.1, 0.1, TEMPERATURE, true, false},
+    {26, SIZE_16BIT, SPF_DCDC_T_NAME, 0.1, 0.1, TEMPERATURE, true, false},
+    {27, SIZE_16BIT, SPF_LOAD_NAME, 0.1, 0.1, PERCENTAGE, true, false},
+    {32, SIZE_16BIT, SPF_BUCK1_T_NAME, 0.1, 0.1, TEMPERATURE, true, false},
+    {33, SIZE_16BIT, SPF_BUCK2_T_NAME, 0.1, 0.1, TEMPERATURE, true, false},
+    {36, SIZE_32BIT, SPF_AC_INPWR_NAME, 0.1, 0.1, POWER_W, true, true},
+    {38, SIZE_32BIT, SPF_AC_INVA_NAME, 0.1, 0.1, VA, true, false},
+    {77, SIZE_32BIT, SPF_BATT_PWR_NAME, 0.1, 0.1, POWER_W, true, false},
+};
+static constexpr sGrowattReadFragment_t SPFInputFragments[] PROGMEM = {
+    {0, 40},
+    {77, 79},
+};
+CHECK_PROTOCOL_TABLE(SPFInputRegisters, SPF_INPUT_REGISTER_COUNT,
+                     SPFInputFragments);
 
-  Protocol.InputFragmentCount = 2;
-  Protocol.InputReadFragments[0] = sGrowattReadFragment_t{0, 40};
-  Protocol.InputReadFragments[1] = sGrowattReadFragment_t{77, 79};
+// first address, last address, groups
+static constexpr sGrowattRegisterGroup_t SPFInputGroups[] PROGMEM = {
+    {0, 0, GroupStatus},
+    {1, 8, GroupPv},
+    {9, 12, GroupLoad},
+    {13, 16, GroupGrid},
+    {17, 18, GroupBattery},
+    {19, 19, GroupDiagnostics},
+    {20, 21, GroupGrid},
+    {22, 24, GroupLoad},
+    {25, 26, GroupDiagnostics},
+    {27, 27, GroupLoad},
+    {32, 33, GroupDiagnostics},
+    {36, 38, GroupGrid},
+    {77, 77, GroupBattery},
+};
+CHECK_GROUP_TABLE(SPFInputGroups);
+
+void init_growattSPF(sProtocolDefinition_t& Protocol, Growatt& inverter) {
+  Protocol.InputRegisterCount = SPF_INPUT_REGISTER_COUNT;
+  Protocol.InputRegisters = SPFInputRegisters;
+  Protocol.InputFragmentCount = tableSize(SPFInputFragments);
+  Protocol.InputReadFragments = SPFInputFragments;
 
   Protocol.HoldingRegisterCount = 0;
+  Protocol.HoldingRegisters = NULL;
   Protocol.HoldingFragmentCount = 0;
+  Protocol.HoldingReadFragments = NULL;
+
+  Protocol.InputGroupCount = tableSize(SPFInputGroups);
+  Protocol.InputGroups = SPFInputGroups;
+  Protocol.HoldingGroupCount = 0;
+  Protocol.HoldingGroups = NULL;
 }
@@ -34,7 +34,8 @@ typedef enum {
   SPF_BUCK2_T,
   SPF_AC_INPWR,
   SPF_AC_INVA,
-  SPF_BATT_PWR
+  SPF_BATT_PWR,
+  SPF_INPUT_REGISTER_COUNT
 } eSPFInputRegisters_t;
 
 void init_growattSPF(sProtocolDefinition_t& Protocol, Growatt& inverter);
@@ -143,347 +143,361 @@ std::tuple<bool, String> setPriority(const JsonDocument& req, JsonDocument& res,
 
 // TODO: add setters and getters for timeslots.
 
+static const char P3000_INVERTER_STATUS_NAME[] PROGMEM = "InverterStatus";
+static const char P3000_INVERTER_RUNSTATE_NAME[] PROGMEM = "InverterRunState";
+static const char P3000_PPV_NAME[] PROGMEM = "PVTotalPower";
+static const char P3000_VPV1_NAME[] PROGMEM = "PV1Voltage";
+static const char P3000_IPV1_NAME[] PROGMEM = "PV1InputCurrent";
+static const char P3000_PPV1_NAME[] PROGMEM = "PV1Power";
+static const char P3000_VPV2_NAME[] PROGMEM = "PV2Voltage";
+static const char P3000_IPV2_NAME[] PROGMEM = "PV2InputCurrent";
+static const char P3000_PPV2_NAME[] PROGMEM = "PV2Power";
+static const char P3000_VPV3_NAME[] PROGMEM = "PV3Voltage";
+static const char P3000_IPV3_NAME[] PROGMEM = "PV3InputCurrent";
+static const char P3000_PPV3_NAME[] PROGMEM = "PV3Power";
+static const char P3000_VPV4_NAME[] PROGMEM = "PV4Voltage";
+static const char P3000_IPV4_NAME[] PROGMEM = "PV4InputCurrent";
+static const char P3000_PPV4_NAME[] PROGMEM = "PV4Power";
+static const char P3000_PSYS_NAME[] PROGMEM = "SystemOutputPower";
+static const char P3000_QAC_NAME[] PROGMEM = "ReactivePower";
+static const char P3000_PAC_NAME[] PROGMEM = "OutputPower";
+static const char P3000_FAC_NAME[] PROGMEM = "GridFrequency";
+static const char P3000_VAC1_NAME[] PROGMEM = "L1ThreePhaseGridVoltage";
+static const char P3000_IAC1_NAME[] PROGMEM = "L1ThreePhaseGridOutputCurrent";
+static const char P3000_PAC1_NAME[] PROGMEM = "L1ThreePhaseGridOutputPower";
+static const char P3000_VAC2_NAME[] PROGMEM = "L2ThreePhaseGridVoltage";
+static const char P3000_IAC2_NAME[] PROGMEM = "L2ThreePhaseGridOutputCurrent";
+static const char P3000_PAC2_NAME[] PROGMEM = "L2ThreePhaseGridOutputPower";
+static const char P3000_VAC3_NAME[] PROGMEM = "L3ThreePhaseGridVoltage";
+static const char P3000_IAC3_NAME[] PROGMEM = "L3ThreePhaseGridOutputCurrent";
+static const char P3000_PAC3_NAME[] PROGMEM = "L3ThreePhaseGridOutputPower";
+static const char P3000_VAC_RS_NAME[] PROGMEM = "RSThreePhaseGridVoltage";
+static const char P3000_VAC_ST_NAME[] PROGMEM = "STThreePhaseGridVoltage";
+static const char P3000_VAC_TR_NAME[] PROGMEM = "TRThreePhaseGridVoltage";
+static const char P3000_PTOUSER_TOTAL_NAME[] PROGMEM = "TotalForwardPower";
+static const char P3000_PTOGRID_TOTAL_NAME[] PROGMEM = "TotalReversePower";
+static const char P3000_PTOLOAD_TOTAL_NAME[] PROGMEM = "TotalLoadPower";
+static const char P3000_TIME_TOTAL_NAME[] PROGMEM = "WorkTimeTotal";
+static const char P3000_EAC_TODAY_NAME[] PROGMEM = "TodayGenerateEnergy";
+static const char P3000_EAC_TOTAL_NAME[] PROGMEM = "TotalGenerateEnergy";
+static const char P3000_EPV_TOTAL_NAME[] PROGMEM = "PVEnergyTotal";
+static const char P3000_EPV1_TODAY_NAME[] PROGMEM = "PV1EnergyToday";
+static const char P3000_EPV1_TOTAL_NAME[] PROGMEM = "PV1EnergyTotal";
+static const char P3000_EPV2_TODAY_NAME[] PROGMEM = "PV2EnergyToday";
+static const char P3000_EPV2_TOTAL_NAME[] PROGMEM = "PV2EnergyTotal";
+static const char P3000_EPV3_TODAY_NAME[] PROGMEM = "PV3EnergyToday";
+static const char P3000_EPV3_TOTAL_NAME[] PROGMEM = "PV3EnergyTotal";
+static const char P3000_ETOUSER_TODAY_NAME[] PROGMEM = "TodayEnergyToUser";
+static const char P3000_ETOUSER_TOTAL_NAME[] PROGMEM = "TotalEnergyToUser";
+static const char P3000_ETOGRID_TODAY_NAME[] PROGMEM = "TodayEnergyToGrid";
+static const char P3000_ETOGRID_TOTAL_NAME[] PROGMEM = "TotalEnergyToGrid";
+static const char P3000_ELOAD_TODAY_NAME[] PROGMEM = "TodayEnergyOfUserLoad";
+static const char P3000_ELOAD_TOTAL_NAME[] PROGMEM = "TotalEnergyOfUserLoad";
+static const char P3000_EPV4_TODAY_NAME[] PROGMEM = "PV4EnergyToday";
+static const char P3000_EPV4_TOTAL_NAME[] PROGMEM = "PV4EnergyTotal";
+static const char P3000_EPV_TODAY_NAME[] PROGMEM = "PVEnergyToday";
+static const char P3000_DERATING_MODE_NAME[] PROGMEM = "DeratingMode";
+static const char P3000_ISO_NAME[] PROGMEM = "PVISOValue";
+static const char P3000_DCI_R_NAME[] PROGMEM = "RDCICurr";
+static const char P3000_DCI_S_NAME[] PROGMEM = "SDCICurr";
+static const char P3000_DCI_T_NAME[] PROGMEM = "TDCICurr";
+static const char P3000_GFCI_NAME[] PROGMEM = "GFCICurr";
+static const char P3000_BUS_VOLTAGE_NAME[] PROGMEM = "TotalBusVoltage";
+static const char P3000_TEMP1_NAME[] PROGMEM = "InverterTemperature";
+static const char P3000_TEMP2_NAME[] PROGMEM = "TemperatureInsideIPM";
+static const char P3000_TEMP3_NAME[] PROGMEM = "BoostTemperature";
+static const char P3000_TEMP5_NAME[] PROGMEM = "CommunicationBoardTemperature";
+static const char P3000_P_BUS_VOLTAGE_NAME[] PROGMEM = "PBusInsideVoltage";
+static const char P3000_N_BUS_VOLTAGE_NAME[] PROGMEM = "NBusInsideVoltage";
+static const char P3000_IPF_NAME[] PROGMEM = "InverterOutputPFNow";
+static const char P3000_REALOPPERCENT_NAME[] PROGMEM = "RealOutputPercent";
+static const char P3000_OPFULLWATT_NAME[] PROGMEM = "OutputMaxpowerLimited";
+static const char P3000_FAULT_MAINCODE_NAME[] PROGMEM = "InverterFaultMaincode";
+static const char P3000_WARN_MAINCODE_NAME[] PROGMEM = "InverterWarnMaincode";
+static const char P3000_AFCI_STATUS_NAME[] PROGMEM = "AFCIStatus";
+static const char P3000_INV_START_DELAY_NAME[] PROGMEM = "InvStartDelayTime";
+static const char P3000_BDC_ONOFFSTATE_NAME[] PROGMEM = "BDCConnectState";
+static const char P3000_DRYCONTACTSTATE_NAME[] PROGMEM = "DryContactState";
+static const char P3000_PSELF_NAME[] PROGMEM = "SelfUsePower";
+static const char P3000_ESYS_TODAY_NAME[] PROGMEM = "SystemEnergyToday";
+static const char P3000_EDISCHR_TODAY_NAME[] PROGMEM = "DischargeEnergyToday";
+static const char P3000_EDISCHR_TOTAL_NAME[] PROGMEM = "DischargeEnergyTotal";
+static const char P3000_ECHR_TODAY_NAME[] PROGMEM = "ChargeEnergyToday";
+static const char P3000_ECHR_TOTAL_NAME[] PROGMEM = "ChargeEnergyTotal";
+static const char P3000_EACCHR_TODAY_NAME[] PROGMEM = "ACChargeEnergyToday";
+static const char P3000_EACCHR_TOTAL_NAME[] PROGMEM = "ACChargeEnergyTotal";
+static const char P3000_ESYS_TOTAL_NAME[] PROGMEM = "SystemEnergyTotal";
+static const char P3000_ESELF_TODAY_NAME[] PROGMEM = "SelfOutputEnergyToday";
+static const char P3000_ESELF_TOTAL_NAME[] PROGMEM = "SelfOutputEnergyTotal";
+static const char P3000_PRIORITY_NAME[] PROGMEM = "Priority";
+static const char P3000_BDC_DERATINGMODE_NAME[] PROGMEM = "BDCDeratingMode";
+static const char P3000_BDC_SYSSTATE_NAME[] PROGMEM = "BDCSysState";
+static const char P3000_BDC_SYSMODE_NAME[] PROGMEM = "BDCSysMode";
+static const char P3000_BDC_FAULTCODE_NAME[] PROGMEM = "BDCFaultCode";
+static const char P3000_BDC_WARNCODE_NAME[] PROGMEM = "BDCWarnCode";
+static const char P3000_BDC_VBAT_NAME[] PROGMEM = "BDCBatteryVoltage";
+static const char P3000_BDC_IBAT_NAME[] PROGMEM = "BDCBatteryCurrent";
+static const char P3000_BDC_SOC_NAME[] PROGMEM = "BDCStateOfCharge";
+static const char P3000_BDC_VBUS1_NAME[] PROGMEM = "BDCTotalBusVoltage";
+static const char P3000_BDC_VBUS2_NAME[] PROGMEM = "BDCOnTheBusVoltage";
+static const char P3000_BDC_IBB_NAME[] PROGMEM = "BDCBuckBoostCurrent";
+static const char P3000_BDC_ILLC_NAME[] PROGMEM = "BDCLlcCurrent";
+static const char P3000_BDC_TEMPA_NAME[] PROGMEM = "BDCTemperatureA";
+static const char P3000_BDC_TEMPB_NAME[] PROGMEM = "BDCTemperatureB";
+static const char P3000_BDC_PDISCHR_NAME[] PROGMEM = "BDCDischargePower";
+static const char P3000_BDC_PCHR_NAME[] PROGMEM = "BDCChargePower";
+static const char P3000_BDC_EDISCHR_TOTAL_NAME[] PROGMEM =
+    "BDCDischargeEnergyTotal";
+static const char P3000_BDC_ECHR_TOTAL_NAME[] PROGMEM = "BDCChargeEnergyTotal";
+static const char P3000_ACTIVE_P_RATE_NAME[] PROGMEM = "ActivePowerRate";
+static const char P3000_BDC_DISCHARGE_P_RATE_NAME[] PROGMEM =
+    "BDCDischargePowerRate";
+static const char P3000_BDC_DISCHARGE_STOPSOC_NAME[] PROGMEM =
+    "BDCDischargeStopSOC";
+static const char P3000_BDC_CHARGE_P_RATE_NAME[] PROGMEM = "BDCChargePowerRate";
+static const char P3000_BDC_CHARGE_STOPSOC_NAME[] PROGMEM = "BDCChargeStopSOC";
+static const char P3000_BDC_CHARGE_AC_ENABLED_NAME[] PROGMEM =
+    "BDCChargeACEnabled";
+
+// address, size, name, multiplier, resolution, unit, frontend, plot
+static constexpr sGrowattRegisterDef_t P3000InputRegisters[] PROGMEM = {
+    // FRAGMENT 1: BEGIN
+    {3000, SIZE_8BIT_L, P3000_INVERTER_STATUS_NAME, 1, 1, NONE, true, false,
+     &LABELS_STATUS},
+    {3000, SIZE_8BIT_H, P3000_INVERTER_RUNSTATE_NAME, 1, 1, NONE, false, false},
+    {3001, SIZE_32BIT, P3000_PPV_NAME, 0.1, 0.1, POWER_W, true, true},
+    {3003, SIZE_16BIT, P3000_VPV1_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    // TODO: real reg names
+    {3004, SIZE_16BIT, P3000_IPV1_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3005, SIZE_32BIT, P3000_PPV1_NAME, 0.1, 0.1, POWER_W, false, false},
+    {3007, SIZE_16BIT, P3000_VPV2_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {3008, SIZE_16BIT, P3000_IPV2_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3009, SIZE_32BIT, P3000_PPV2_NAME, 0.1, 0.1, POWER_W, false, false},
+    {3011, SIZE_16BIT, P3000_VPV3_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {3012, SIZE_16BIT, P3000_IPV3_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3013, SIZE_32BIT, P3000_PPV3_NAME, 0.1, 0.1, POWER_W, false, false},
+    {3015, SIZE_16BIT, P3000_VPV4_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {3016, SIZE_16BIT, P3000_IPV4_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3017, SIZE_32BIT, P3000_PPV4_NAME, 0.1, 0.1, POWER_W, false, false},
+    {3019, SIZE_32BIT_S, P3000_PSYS_NAME, 0.1, 0.1, POWER_W, false, false},
+    {3021, SIZE_32BIT_S, P3000_QAC_NAME, 0.1, 0.1, POWER_REACTIVE, true, true},
+    {3023, SIZE_32BIT_S, P3000_PAC_NAME, 0.1, 0.1, POWER_W, true, true},
+    {3025, SIZE_16BIT, P3000_FAC_NAME, 0.01, 0.01, FREQUENCY, false, false},
+    {3026, SIZE_16BIT, P3000_VAC1_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {3027, SIZE_16BIT, P3000_IAC1_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3028, SIZE_32BIT, P3000_PAC1_NAME, 0.1, 0.1, VA, false, false},
+    {3030, SIZE_16BIT, P3000_VAC2_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {3031, SIZE_16BIT, P3000_IAC2_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3032, SIZE_32BIT, P3000_PAC2_NAME, 0.1, 0.1, VA, false, false},
+    {3034, SIZE_16BIT, P3000_VAC3_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {3035, SIZE_16BIT, P3000_IAC3_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3036, SIZE_32BIT, P3000_PAC3_NAME, 0.1, 0.1, VA, false, false},
+    {3038, SIZE_16BIT, P3000_VAC_RS_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {3039, SIZE_16BIT, P3000_VAC_ST_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {3040, SIZE_16BIT, P3000_VAC_TR_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {3041, SIZE_32BIT_S, P3000_PTOUSER_TOTAL_NAME, 0.1, 0.1, POWER_W, true,
+     true},
+    {3043, SIZE_32BIT_S, P3000_PTOGRID_TOTAL_NAME, 0.1, 0.1, POWER_W, true,
+     true},
+    {3045, SIZE_32BIT_S, P3000_PTOLOAD_TOTAL_NAME, 0.1, 0.1, POWER_W, true,
+     true},
+    {3047, SIZE_32BIT, P3000_TIME_TOTAL_NAME, 0.5, 1, SECONDS, false, false},
+    {3049, SIZE_32BIT, P3000_EAC_TODAY_NAME, 0.1, 0.1, POWER_KWH, true, false},
+    {3051, SIZE_32BIT, P3000_EAC_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true, false},
+    {3053, SIZE_32BIT, P3000_EPV_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    {3055, SIZE_32BIT, P3000_EPV1_TODAY_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3057, SIZE_32BIT, P3000_EPV1_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3059, SIZE_32BIT, P3000_EPV2_TODAY_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3061, SIZE_32BIT, P3000_EPV2_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    // FRAGMENT 1: END
+
+    // FRAGMENT 2: BEGIN
+    {3063, SIZE_32BIT, P3000_EPV3_TODAY_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3065, SIZE_32BIT, P3000_EPV3_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3067, SIZE_32BIT, P3000_ETOUSER_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {3069, SIZE_32BIT, P3000_ETOUSER_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {3071, SIZE_32BIT, P3000_ETOGRID_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {3073, SIZE_32BIT, P3000_ETOGRID_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {3075, SIZE_32BIT, P3000_ELOAD_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {3077, SIZE_32BIT, P3000_ELOAD_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {3079, SIZE_32BIT, P3000_EPV4_TODAY_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3081, SIZE_32BIT, P3000_EPV4_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3083, SIZE_32BIT, P3000_EPV_TODAY_NAME, 0.1, 0.1, POWER_KWH, false, false},
+    // TODO: decode
+    {3086, SIZE_16BIT, P3000_DERATING_MODE_NAME, 1, 1, NONE, true, false},
+    {3087, SIZE_16BIT, P3000_ISO_NAME, 1, 1, RESISTANCE_K, false, false},
+    {3088, SIZE_16BIT, P3000_DCI_R_NAME, 0.1, 0.1, CURRENT_M, false, false},
+    {3089, SIZE_16BIT, P3000_DCI_S_NAME, 0.1, 0.1, CURRENT_M, false, false},
+    {3090, SIZE_16BIT, P3000_DCI_T_NAME, 0.1, 0.1, CURRENT_M, false, false},
+    {3091, SIZE_16BIT, P3000_GFCI_NAME, 1, 1, CURRENT_M, false, false},
+    {3092, SIZE_16BIT, P3000_BUS_VOLTAGE_NAME, 0.1, 0.1, VOLTAGE, false, false},
+    {3093, SIZE_16BIT, P3000_TEMP1_NAME, 0.1, 0.1, TEMPERATURE, true, false},
+    {3094, SIZE_16BIT, P3000_TEMP2_NAME, 0.1, 0.1, TEMPERATURE, false, false},
+    {3095, SIZE_16BIT, P3000_TEMP3_NAME, 0.1, 0.1, TEMPERATURE, false, false},
+    {3097, SIZE_16BIT, P3000_TEMP5_NAME, 0.1, 0.1, TEMPERATURE, false, false},
+    {3098, SIZE_16BIT, P3000_P_BUS_VOLTAGE_NAME, 0.1, 0.1, VOLTAGE, false,
+     false},
+    {3099, SIZE_16BIT, P3000_N_BUS_VOLTAGE_NAME, 0.1, 0.1, VOLTAGE, false,
+     false},
+    {3100, SIZE_16BIT, P3000_IPF_NAME, 1, 1, NONE, false, false},
+    {3101, SIZE_16BIT_S, P3000_REALOPPERCENT_NAME, 1, 1, PERCENTAGE, true,
+     false},
+    {3102, SIZE_32BIT, P3000_OPFULLWATT_NAME, 0.1, 0.1, POWER_W, true, true},
+    {3105, SIZE_16BIT, P3000_FAULT_MAINCODE_NAME, 1, 1, NONE, true, false},
+    {3106, SIZE_16BIT, P3000_WARN_MAINCODE_NAME, 1, 1, NONE, true, false},
+    {3112, SIZE_16BIT, P3000_AFCI_STATUS_NAME, 1, 1, NONE, false, false},
+    {3115, SIZE_16BIT, P3000_INV_START_DELAY_NAME, 1, 1, SECONDS, false, false},
+    {3118, SIZE_16BIT, P3000_BDC_ONOFFSTATE_NAME, 1, 1, NONE, true, false},
+    {3119, SIZE_16BIT, P3000_DRYCONTACTSTATE_NAME, 1, 1, NONE, false, false},
+    {3121, SIZE_32BIT, P3000_PSELF_NAME, 0.1, 0.1, POWER_W, false, false},
+    {3123, SIZE_32BIT, P3000_ESYS_TODAY_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    // FRAGMENT 2: END
+
+    // FRAGMENT 3: BEGIN
+    {3125, SIZE_32BIT, P3000_EDISCHR_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {3127, SIZE_32BIT, P3000_EDISCHR_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {3129, SIZE_32BIT, P3000_ECHR_TODAY_NAME, 0.1, 0.1, POWER_KWH, true, false},
+    {3131, SIZE_32BIT, P3000_ECHR_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true, false},
+    {3133, SIZE_32BIT, P3000_EACCHR_TODAY_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {3135, SIZE_32BIT, P3000_EACCHR_TOTAL_NAME, 0.1, 0.1, POWER_KWH, true,
+     false},
+    {3137, SIZE_32BIT, P3000_ESYS_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3139, SIZE_32BIT, P3000_ESELF_TODAY_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3141, SIZE_32BIT, P3000_ESELF_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3144, SIZE_16BIT, P3000_PRIORITY_NAME, 1, 1, NONE, true, false,
+     &LABELS_PRIORITY},
+    {3165, SIZE_16BIT, P3000_BDC_DERATINGMODE_NAME, 1, 1, NONE, true, false},
+    {3166, SIZE_8BIT_L, P3000_BDC_SYSSTATE_NAME, 1, 1, NONE, true, false,
+     &LABELS_STATUS},
+    {3166, SIZE_8BIT_H, P3000_BDC_SYSMODE_NAME, 1, 1, NONE, true, false,
+     &LABELS_BDC_MODE},
+    {3167, SIZE_16BIT, P3000_BDC_FAULTCODE_NAME, 1, 1, NONE, true, false},
+    {3168, SIZE_16BIT, P3000_BDC_WARNCODE_NAME, 1, 1, NONE, true, false},
+    {3169, SIZE_16BIT, P3000_BDC_VBAT_NAME, 0.01, 0.01, VOLTAGE, true, false},
+    {3170, SIZE_16BIT_S, P3000_BDC_IBAT_NAME, 0.1, 0.1, CURRENT, true, false},
+    {3171, SIZE_16BIT, P3000_BDC_SOC_NAME, 1, 1, PERCENTAGE, true, false},
+    {3172, SIZE_16BIT, P3000_BDC_VBUS1_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3173, SIZE_16BIT, P3000_BDC_VBUS2_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3174, SIZE_16BIT, P3000_BDC_IBB_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3175, SIZE_16BIT, P3000_BDC_ILLC_NAME, 0.1, 0.1, CURRENT, false, false},
+    {3176, SIZE_16BIT, P3000_BDC_TEMPA_NAME, 0.1, 0.1, TEMPERATURE, true,
+     false},
+    {3177, SIZE_16BIT, P3000_BDC_TEMPB_NAME, 0.1, 0.1, TEMPERATURE, false,
+     false},
+    {3178, SIZE_32BIT, P3000_BDC_PDISCHR_NAME, 0.1, 0.1, POWER_W, true, true},
+    {3180, SIZE_32BIT, P3000_BDC_PCHR_NAME, 0.1, 0.1, POWER_W, true, true},
+    {3182, SIZE_32BIT, P3000_BDC_EDISCHR_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    {3184, SIZE_32BIT, P3000_BDC_ECHR_TOTAL_NAME, 0.1, 0.1, POWER_KWH, false,
+     false},
+    // FRAGMENT 3: END
+};
+static constexpr sGrowattReadFragment_t P3000InputFragments[] PROGMEM = {
+    {3000, 63},
+    {3063, 62},
+    {3125, 61},
+};
+CHECK_PROTOCOL_TABLE(P3000InputRegisters, P3000_INPUT_REGISTER_COUNT,
+                     P3000InputFragments);
+
+// address, size, name, multiplier, resolution, unit, frontend, plot
+static constexpr sGrowattRegisterDef_t P3000HoldingRegisters[] PROGMEM = {
+    // FRAGMENT 1: BEGIN
+    {3, SIZE_16BIT, P3000_ACTIVE_P_RATE_NAME, 1, 1, PERCENTAGE, true, false},
+    // FRAGMENT 1: END
+
+    // FRAGMENT 2: BEGIN
+    // The BDCDischargePowerRate seems to apply to grid first AND load first
+    // mode. The BDCDischargeStopSOC applies to grid first mode only. If you
+    // want to prevent discharging set BDCDischargePowerRate to 0. The
+    // BDCChargePowerRate seems to apply to battery first AND load first mode.
+    // The BDCChargeStopSOC applies to battery first mode AND also to load
+    // first mode. If BDCChargeACEnabled is enabled the battery is charged up
+    // to BDCChargeStopSOC via AC.
+    {3036, SIZE_16BIT, P3000_BDC_DISCHARGE_P_RATE_NAME, 1, 1, PERCENTAGE, true,
+     false},
+    {3037, SIZE_16BIT, P3000_BDC_DISCHARGE_STOPSOC_NAME, 1, 1, PERCENTAGE, true,
+     false},
+    {3047, SIZE_16BIT, P3000_BDC_CHARGE_P_RATE_NAME, 1, 1, PERCENTAGE, true,
+     false},
+    {3048, SIZE_16BIT, P3000_BDC_CHARGE_STOPSOC_NAME, 1, 1, PERCENTAGE, true,
+     false},
+    {3049, SIZE_16BIT, P3000_BDC_CHARGE_AC_ENABLED_NAME, 1, 1, NONE, true,
+     false},
+    // FRAGMENT 2: END
+};
+static constexpr sGrowattReadFragment_t P3000HoldingFragments[] PROGMEM = {
+    {3, 1},
+    {3036, 14},
+};
+CHECK_PROTOCOL_TABLE(P3000HoldingRegisters, P3000_HOLING_REGISTER_COUNT,
+                     P3000HoldingFragments);
+
+// first address, last address, groups
+static constexpr sGrowattRegisterGroup_t P3000InputGroups[] PROGMEM = {
+    {3000, 3000, GroupStatus},
+    {3001, 3017, GroupPv},
+    {3019, 3043, GroupGrid},
+    {3045, 3045, GroupLoad},
+    {3047, 3047, GroupDiagnostics},
+    {3049, 3051, GroupEnergy},
+    {3053, 3065, GroupPv | GroupEnergy},
+    {3067, 3073, GroupGrid | GroupEnergy},
+    {3075, 3077, GroupLoad | GroupEnergy},
+    {3079, 3083, GroupPv | GroupEnergy},
+    {3086, 3119, GroupDiagnostics},
+    {3105, 3106, GroupStatus},
+    {3121, 3121, GroupLoad},
+    {3123, 3123, GroupEnergy},
+    {3125, 3135, GroupBattery | GroupEnergy},
+    {3137, 3141, GroupEnergy},
+    {3144, 3144, GroupStatus},
+    {3165, 3184, GroupBattery},
+    {3165, 3168, GroupStatus},
+    {3182, 3184, GroupEnergy},
+};
+CHECK_GROUP_TABLE(P3000InputGroups);
+static constexpr sGrowattRegisterGroup_t P3000HoldingGroups[] PROGMEM = {
+    {0, 0xFFFF, GroupSettings},
+};
+CHECK_GROUP_TABLE(P3000HoldingGroups);
+
 void init_growattTLXH(sProtocolDefinition_t& Protocol, Growatt& inverter) {
-  // definition of input registers
   Protocol.InputRegisterCount = P3000_INPUT_REGISTER_COUNT;
-  // address, value, size, name, multiplier, resolution, unit, frontend, plot
-
-  // FRAGMENT 1: BEGIN
-  Protocol.InputRegisters[P3000_INVERTER_STATUS] = sGrowattModbusReg_t{
-      3000, 0, SIZE_16BIT, F("InverterStatus"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P3000_INVERTER_RUNSTATE] = sGrowattModbusReg_t{
-      3000, 0, SIZE_16BIT, F("InverterRunState"), 1, 1, NONE, false, false};
-  Protocol.InputRegisters[P3000_PPV] = sGrowattModbusReg_t{
-      3001, 0, SIZE_32BIT, F("PVTotalPower"), 0.1, 0.1, POWER_W, true, true};
-  Protocol.InputRegisters[P3000_VPV1] = sGrowattModbusReg_t{
-      3003, 0, SIZE_16BIT, F("PV1Voltage"), 0.1, 0.1, VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_IPV1] = sGrowattModbusReg_t{
-      // TODO: real reg names
-      3004,    0,     SIZE_16BIT, F("PV1InputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P3000_PPV1] = sGrowattModbusReg_t{
-      3005, 0, SIZE_32BIT, F("PV1Power"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P3000_VPV2] = sGrowattModbusReg_t{
-      3007, 0, SIZE_16BIT, F("PV2Voltage"), 0.1, 0.1, VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_IPV2] = sGrowattModbusReg_t{
-      3008,    0,     SIZE_16BIT, F("PV2InputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P3000_PPV2] = sGrowattModbusReg_t{
-      3009, 0, SIZE_32BIT, F("PV2Power"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P3000_VPV3] = sGrowattModbusReg_t{
-      3011, 0, SIZE_16BIT, F("PV3Voltage"), 0.1, 0.1, VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_IPV3] = sGrowattModbusReg_t{
-      3012,    0,     SIZE_16BIT, F("PV3InputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P3000_PPV3] = sGrowattModbusReg_t{
-      3013, 0, SIZE_32BIT, F("PV3Power"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P3000_VPV4] = sGrowattModbusReg_t{
-      3015, 0, SIZE_16BIT, F("PV4Voltage"), 0.1, 0.1, VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_IPV4] = sGrowattModbusReg_t{
-      3016,    0,     SIZE_16BIT, F("PV4InputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P3000_PPV4] = sGrowattModbusReg_t{
-      3017, 0, SIZE_32BIT, F("PV4Power"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P3000_PSYS] = sGrowattModbusReg_t{
-      3019,    0,     SIZE_32BIT_S, F("SystemOutputPower"), 0.1, 0.1,
-      POWER_W, false, false};
-  Protocol.InputRegisters[P3000_QAC] = sGrowattModbusReg_t{
-      3021,           0,    SIZE_32BIT_S, F("ReactivePower"), 0.1, 0.1,
-      POWER_REACTIVE, true, true};
-  Protocol.InputRegisters[P3000_PAC] = sGrowattModbusReg_t{
-      3023, 0, SIZE_32BIT_S, F("OutputPower"), 0.1, 0.1, POWER_W, true, true};
-  Protocol.InputRegisters[P3000_FAC] = sGrowattModbusReg_t{
-      3025,      0,     SIZE_16BIT, F("GridFrequency"), 0.01, 0.01,
-      FREQUENCY, false, false};
-  Protocol.InputRegisters[P3000_VAC1] = sGrowattModbusReg_t{
-      3026,    0,     SIZE_16BIT, F("L1ThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_IAC1] = sGrowattModbusReg_t{
-      3027,    0,     SIZE_16BIT, F("L1ThreePhaseGridOutputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P3000_PAC1] = sGrowattModbusReg_t{
-      3028, 0,     SIZE_32BIT, F("L1ThreePhaseGridOutputPower"), 0.1, 0.1,
-      VA,   false, false};
-  Protocol.InputRegisters[P3000_VAC2] = sGrowattModbusReg_t{
-      3030,    0,     SIZE_16BIT, F("L2ThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_IAC2] = sGrowattModbusReg_t{
-      3031,    0,     SIZE_16BIT, F("L2ThreePhaseGridOutputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P3000_PAC2] = sGrowattModbusReg_t{
-      3032, 0,     SIZE_32BIT, F("L2ThreePhaseGridOutputPower"), 0.1, 0.1,
-      VA,   false, false};
-  Protocol.InputRegisters[P3000_VAC3] = sGrowattModbusReg_t{
-      3034,    0,     SIZE_16BIT, F("L3ThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_IAC3] = sGrowattModbusReg_t{
-      3035,    0,     SIZE_16BIT, F("L3ThreePhaseGridOutputCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P3000_PAC3] = sGrowattModbusReg_t{
-      3036, 0,     SIZE_32BIT, F("L3ThreePhaseGridOutputPower"), 0.1, 0.1,
-      VA,   false, false};
-  Protocol.InputRegisters[P3000_VAC_RS] = sGrowattModbusReg_t{
-      3038,    0,     SIZE_16BIT, F("RSThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_VAC_ST] = sGrowattModbusReg_t{
-      3039,    0,     SIZE_16BIT, F("STThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_VAC_TR] = sGrowattModbusReg_t{
-      3040,    0,     SIZE_16BIT, F("TRThreePhaseGridVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_PTOUSER_TOTAL] = sGrowattModbusReg_t{
-      3041,    0,    SIZE_32BIT_S, F("TotalForwardPower"), 0.1, 0.1,
-      POWER_W, true, true};
-  Protocol.InputRegisters[P3000_PTOGRID_TOTAL] = sGrowattModbusReg_t{
-      3043,    0,    SIZE_32BIT_S, F("TotalReversePower"), 0.1, 0.1,
-      POWER_W, true, true};
-  Protocol.InputRegisters[P3000_PTOLOAD_TOTAL] = sGrowattModbusReg_t{
-      3045,    0,    SIZE_32BIT_S, F("TotalLoadPower"), 0.1, 0.1,
-      POWER_W, true, true};
-  Protocol.InputRegisters[P3000_TIME_TOTAL] = sGrowattModbusReg_t{
-      3047, 0, SIZE_32BIT, F("WorkTimeTotal"), 0.5, 1, SECONDS, false, false};
-  Protocol.InputRegisters[P3000_EAC_TODAY] = sGrowattModbusReg_t{
-      3049,      0,    SIZE_32BIT, F("TodayGenerateEnergy"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_EAC_TOTAL] = sGrowattModbusReg_t{
-      3051,      0,    SIZE_32BIT, F("TotalGenerateEnergy"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_EPV_TOTAL] = sGrowattModbusReg_t{
-      3053,      0,     SIZE_32BIT, F("PVEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_EPV1_TODAY] = sGrowattModbusReg_t{
-      3055,      0,     SIZE_32BIT, F("PV1EnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_EPV1_TOTAL] = sGrowattModbusReg_t{
-      3057,      0,     SIZE_32BIT, F("PV1EnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_EPV2_TODAY] = sGrowattModbusReg_t{
-      3059,      0,     SIZE_32BIT, F("PV2EnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_EPV2_TOTAL] = sGrowattModbusReg_t{
-      3061,      0,     SIZE_32BIT, F("PV2EnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  // FRAGMENT 1: END
-
-  // FRAGMENT 2: BEGIN
-  Protocol.InputRegisters[P3000_EPV3_TODAY] = sGrowattModbusReg_t{
-      3063,      0,     SIZE_32BIT, F("PV3EnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_EPV3_TOTAL] = sGrowattModbusReg_t{
-      3065,      0,     SIZE_32BIT, F("PV3EnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_ETOUSER_TODAY] = sGrowattModbusReg_t{
-      3067,      0,    SIZE_32BIT, F("TodayEnergyToUser"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_ETOUSER_TOTAL] = sGrowattModbusReg_t{
-      3069,      0,    SIZE_32BIT, F("TotalEnergyToUser"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_ETOGRID_TODAY] = sGrowattModbusReg_t{
-      3071,      0,    SIZE_32BIT, F("TodayEnergyToGrid"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_ETOGRID_TOTAL] = sGrowattModbusReg_t{
-      3073,      0,    SIZE_32BIT, F("TotalEnergyToGrid"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_ELOAD_TODAY] = sGrowattModbusReg_t{
-      3075,      0,    SIZE_32BIT, F("TodayEnergyOfUserLoad"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_ELOAD_TOTAL] = sGrowattModbusReg_t{
-      3077,      0,    SIZE_32BIT, F("TotalEnergyOfUserLoad"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_EPV4_TODAY] = sGrowattModbusReg_t{
-      3079,      0,     SIZE_32BIT, F("PV4EnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_EPV4_TOTAL] = sGrowattModbusReg_t{
-      3081,      0,     SIZE_32BIT, F("PV4EnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_EPV_TODAY] = sGrowattModbusReg_t{
-      3083,      0,     SIZE_32BIT, F("PVEnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_DERATING_MODE] =
-      sGrowattModbusReg_t{3086, 0,    SIZE_16BIT, F("DeratingMode"), 1, 1,
-                          NONE, true, false};  // TODO: decode
-  Protocol.InputRegisters[P3000_ISO] = sGrowattModbusReg_t{
-      3087, 0, SIZE_16BIT, F("PVISOValue"), 1, 1, RESISTANCE_K, false, false};
-  Protocol.InputRegisters[P3000_DCI_R] = sGrowattModbusReg_t{
-      3088, 0, SIZE_16BIT, F("RDCICurr"), 0.1, 0.1, CURRENT_M, false, false};
-  Protocol.InputRegisters[P3000_DCI_S] = sGrowattModbusReg_t{
-      3089, 0, SIZE_16BIT, F("SDCICurr"), 0.1, 0.1, CURRENT_M, false, false};
-  Protocol.InputRegisters[P3000_DCI_T] = sGrowattModbusReg_t{
-      3090, 0, SIZE_16BIT, F("TDCICurr"), 0.1, 0.1, CURRENT_M, false, false};
-  Protocol.InputRegisters[P3000_GFCI] = sGrowattModbusReg_t{
-      3091, 0, SIZE_16BIT, F("GFCICurr"), 1, 1, CURRENT_M, false, false};
-  Protocol.InputRegisters[P3000_BUS_VOLTAGE] = sGrowattModbusReg_t{
-      3092,    0,     SIZE_16BIT, F("TotalBusVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_TEMP1] = sGrowattModbusReg_t{
-      3093,        0,    SIZE_16BIT, F("InverterTemperature"), 0.1, 0.1,
-      TEMPERATURE, true, false};
-  Protocol.InputRegisters[P3000_TEMP2] = sGrowattModbusReg_t{
-      3094,        0,     SIZE_16BIT, F("TemperatureInsideIPM"), 0.1, 0.1,
-      TEMPERATURE, false, false};
-  Protocol.InputRegisters[P3000_TEMP3] = sGrowattModbusReg_t{
-      3095,        0,     SIZE_16BIT, F("BoostTemperature"), 0.1, 0.1,
-      TEMPERATURE, false, false};
-  Protocol.InputRegisters[P3000_TEMP5] = sGrowattModbusReg_t{
-      3097, 0,   SIZE_16BIT,  F("CommunicationBoardTemperature"),
-      0.1,  0.1, TEMPERATURE, false,
-      false};
-  Protocol.InputRegisters[P3000_P_BUS_VOLTAGE] = sGrowattModbusReg_t{
-      3098,    0,     SIZE_16BIT, F("PBusInsideVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_N_BUS_VOLTAGE] = sGrowattModbusReg_t{
-      3099,    0,     SIZE_16BIT, F("NBusInsideVoltage"), 0.1, 0.1,
-      VOLTAGE, false, false};
-  Protocol.InputRegisters[P3000_IPF] = sGrowattModbusReg_t{
-      3100, 0, SIZE_16BIT, F("InverterOutputPFNow"), 1, 1, NONE, false, false};
-  Protocol.InputRegisters[P3000_REALOPPERCENT] = sGrowattModbusReg_t{
-      3101,       0,    SIZE_16BIT_S, F("RealOutputPercent"), 1, 1,
-      PERCENTAGE, true, false};
-  Protocol.InputRegisters[P3000_OPFULLWATT] = sGrowattModbusReg_t{
-      3102,    0,    SIZE_32BIT, F("OutputMaxpowerLimited"), 0.1, 0.1,
-      POWER_W, true, true};
-  Protocol.InputRegisters[P3000_FAULT_MAINCODE] = sGrowattModbusReg_t{
-      3105, 0, SIZE_16BIT, F("InverterFaultMaincode"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P3000_WARN_MAINCODE] = sGrowattModbusReg_t{
-      3106, 0, SIZE_16BIT, F("InverterWarnMaincode"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P3000_AFCI_STATUS] = sGrowattModbusReg_t{
-      3112, 0, SIZE_16BIT, F("AFCIStatus"), 1, 1, NONE, false, false};
-  Protocol.InputRegisters[P3000_INV_START_DELAY] = sGrowattModbusReg_t{
-      3115, 0, SIZE_16BIT, F("InvStartDelayTime"), 1, 1, SECONDS, false, false};
-  Protocol.InputRegisters[P3000_BDC_ONOFFSTATE] = sGrowattModbusReg_t{
-      3118, 0, SIZE_16BIT, F("BDCConnectState"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P3000_DRYCONTACTSTATE] = sGrowattModbusReg_t{
-      3119, 0, SIZE_16BIT, F("DryContactState"), 1, 1, NONE, false, false};
-  Protocol.InputRegisters[P3000_PSELF] = sGrowattModbusReg_t{
-      3121, 0, SIZE_32BIT, F("SelfUsePower"), 0.1, 0.1, POWER_W, false, false};
-  Protocol.InputRegisters[P3000_ESYS_TODAY] = sGrowattModbusReg_t{
-      3123,      0,     SIZE_32BIT, F("SystemEnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  // FRAGMENT 2: END
-
-  // FRAGMENT 3: BEGIN
-  Protocol.InputRegisters[P3000_EDISCHR_TODAY] = sGrowattModbusReg_t{
-      3125,      0,    SIZE_32BIT, F("DischargeEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_EDISCHR_TOTAL] = sGrowattModbusReg_t{
-      3127,      0,    SIZE_32BIT, F("DischargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_ECHR_TODAY] = sGrowattModbusReg_t{
-      3129,      0,    SIZE_32BIT, F("ChargeEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_ECHR_TOTAL] = sGrowattModbusReg_t{
-      3131,      0,    SIZE_32BIT, F("ChargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_EACCHR_TODAY] = sGrowattModbusReg_t{
-      3133,      0,    SIZE_32BIT, F("ACChargeEnergyToday"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_EACCHR_TOTAL] = sGrowattModbusReg_t{
-      3135,      0,    SIZE_32BIT, F("ACChargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, true, false};
-  Protocol.InputRegisters[P3000_ESYS_TOTAL] = sGrowattModbusReg_t{
-      3137,      0,     SIZE_32BIT, F("SystemEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_ESELF_TODAY] = sGrowattModbusReg_t{
-      3139,      0,     SIZE_32BIT, F("SelfOutputEnergyToday"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_ESELF_TOTAL] = sGrowattModbusReg_t{
-      3141,      0,     SIZE_32BIT, F("SelfOutputEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_PRIORITY] = sGrowattModbusReg_t{
-      3144, 0, SIZE_16BIT, F("Priority"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P3000_BDC_DERATINGMODE] = sGrowattModbusReg_t{
-      3165, 0, SIZE_16BIT, F("BDCDeratingMode"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P3000_BDC_SYSSTATE] = sGrowattModbusReg_t{
-      3166, 0, SIZE_16BIT, F("BDCSysState"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P3000_BDC_SYSMODE] = sGrowattModbusReg_t{
-      3166, 0, SIZE_16BIT, F("BDCSysMode"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P3000_BDC_FAULTCODE] = sGrowattModbusReg_t{
-      3167, 0, SIZE_16BIT, F("BDCFaultCode"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P3000_BDC_WARNCODE] = sGrowattModbusReg_t{
-      3168, 0, SIZE_16BIT, F("BDCWarnCode"), 1, 1, NONE, true, false};
-  Protocol.InputRegisters[P3000_BDC_VBAT] = sGrowattModbusReg_t{
-      3169,    0,    SIZE_16BIT, F("BDCBatteryVoltage"), 0.01, 0.01,
-      VOLTAGE, true, false};
-  Protocol.InputRegisters[P3000_BDC_IBAT] = sGrowattModbusReg_t{
-      3170,    0,    SIZE_16BIT_S, F("BDCBatteryCurrent"), 0.1, 0.1,
-      CURRENT, true, false};
-  Protocol.InputRegisters[P3000_BDC_SOC] = sGrowattModbusReg_t{
-      3171,       0,    SIZE_16BIT, F("BDCStateOfCharge"), 1, 1,
-      PERCENTAGE, true, false};
-  Protocol.InputRegisters[P3000_BDC_VBUS1] = sGrowattModbusReg_t{
-      3172,    0,     SIZE_16BIT, F("BDCTotalBusVoltage"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P3000_BDC_VBUS2] = sGrowattModbusReg_t{
-      3173,    0,     SIZE_16BIT, F("BDCOnTheBusVoltage"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P3000_BDC_IBB] = sGrowattModbusReg_t{
-      3174,    0,     SIZE_16BIT, F("BDCBuckBoostCurrent"), 0.1, 0.1,
-      CURRENT, false, false};
-  Protocol.InputRegisters[P3000_BDC_ILLC] = sGrowattModbusReg_t{
-      3175, 0, SIZE_16BIT, F("BDCLlcCurrent"), 0.1, 0.1, CURRENT, false, false};
-  Protocol.InputRegisters[P3000_BDC_TEMPA] = sGrowattModbusReg_t{
-      3176,        0,    SIZE_16BIT, F("BDCTemperatureA"), 0.1, 0.1,
-      TEMPERATURE, true, false};
-  Protocol.InputRegisters[P3000_BDC_TEMPB] = sGrowattModbusReg_t{
-      3177,        0,     SIZE_16BIT, F("BDCTemperatureB"), 0.1, 0.1,
-      TEMPERATURE, false, false};
-  Protocol.InputRegisters[P3000_BDC_PDISCHR] = sGrowattModbusReg_t{
-      3178,    0,    SIZE_32BIT, F("BDCDischargePower"), 0.1, 0.1,
-      POWER_W, true, true};
-  Protocol.InputRegisters[P3000_BDC_PCHR] = sGrowattModbusReg_t{
-      3180, 0, SIZE_32BIT, F("BDCChargePower"), 0.1, 0.1, POWER_W, true, true};
-  Protocol.InputRegisters[P3000_BDC_EDISCHR_TOTAL] = sGrowattModbusReg_t{
-      3182,      0,     SIZE_32BIT, F("BDCDischargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  Protocol.InputRegisters[P3000_BDC_ECHR_TOTAL] = sGrowattModbusReg_t{
-      3184,      0,     SIZE_32BIT, F("BDCChargeEnergyTotal"), 0.1, 0.1,
-      POWER_KWH, false, false};
-  // FRAGMENT 3: END
-
-  Protocol.InputReadFragments[Protocol.InputFragmentCount++] =
-      sGrowattReadFragment_t{3000, 63};
-  Protocol.InputReadFragments[Protocol.InputFragmentCount++] =
-      sGrowattReadFragment_t{3063, 62};
-  Protocol.InputReadFragments[Protocol.InputFragmentCount++] =
-      sGrowattReadFragment_t{3125, 61};
+  Protocol.InputRegisters = P3000InputRegisters;
+  Protocol.InputFragmentCount = tableSize(P3000InputFragments);
+  Protocol.InputReadFragments = P3000InputFragments;
 
   Protocol.HoldingRegisterCount = P3000_HOLING_REGISTER_COUNT;
-
-  // FRAGMENT 1: BEGIN
-  Protocol.HoldingRegisters[P3000_ACTIVE_P_RATE] = sGrowattModbusReg_t{
-      3, 0, SIZE_16BIT, F("ActivePowerRate"), 1, 1, PERCENTAGE, true, false};
-  // FRAGMENT 1: END
-
-  // FRAGMENT 2: BEGIN
-  // The BDCDischargePowerRate seems to apply to grid first AND load first mode.
-  // The BDCDischargeStopSOC applies to grid first mode only. If you want to
-  // prevent discharging set BDCDischargePowerRate to 0. The BDCChargePowerRate
-  // seems to apply to battery first AND load first mode. The BDCChargeStopSOC
-  // applies to battery first mode AND also to load first mode. If
-  // BDCChargeACEnabled is enabled the battery is charged up to BDCChargeStopSOC
-  // via AC.
-  Protocol.HoldingRegisters[P3000_BDC_DISCHARGE_P_RATE] = sGrowattModbusReg_t{
-      3036,       0,    SIZE_16BIT, F("BDCDischargePowerRate"), 1, 1,
-      PERCENTAGE, true, false};
-  Protocol.HoldingRegisters[P3000_BDC_DISCHARGE_STOPSOC] = sGrowattModbusReg_t{
-      3037,       0,    SIZE_16BIT, F("BDCDischargeStopSOC"), 1, 1,
-      PERCENTAGE, true, false};
-  Protocol.HoldingRegisters[P3000_BDC_CHARGE_P_RATE] = sGrowattModbusReg_t{
-      3047,       0,    SIZE_16BIT, F("BDCChargePowerRate"), 1, 1,
-      PERCENTAGE, true, false};
-  Protocol.HoldingRegisters[P3000_BDC_CHARGE_STOPSOC] = sGrowattModbusReg_t{
-      3048,       0,    SIZE_16BIT, F("BDCChargeStopSOC"), 1, 1,
-      PERCENTAGE, true, false};
-  Protocol.HoldingRegisters[P3000_BDC_CHARGE_AC_ENABLED] = sGrowattModbusReg_t{
-      3049, 0, SIZE_16BIT, F("BDCChargeACEnabled"), 1, 1, NONE, true, false};
-  // FRAGMENT 2: END
-
-  Protocol.HoldingRegisterCount = P3000_HOLING_REGISTER_COUNT;
-
-  Protocol.HoldingReadFragments[Protocol.HoldingFragmentCount++] =
-      sGrowattReadFragment_t{3, 1};
-  Protocol.HoldingReadFragments[Protocol.HoldingFragmentCount++] =
-      sGrowattReadFragment_t{3036, 14};
+  Protocol.HoldingRegisters = P3000HoldingRegisters;
+  Protocol.HoldingFragmentCount = tableSize(P3000HoldingFragments);
+  Protocol.HoldingReadFragments = P3000HoldingFragments;
+
+  Protocol.InputGroupCount = tableSize(P3000InputGroups);
+  Protocol.InputGroups = P3000InputGroups;
+  Protocol.HoldingGroupCount = tableSize(P3000HoldingGroups);
+  Protocol.HoldingGroups = P3000HoldingGroups;
 
   // COMMANDS
 
@@ -3,8 +3,8 @@
 #include <ArduinoJson.h>
 #include <StreamUtils.h>
 
-#define JSON_DOCUMENT_SIZE 4096
 #define BUFFER_SIZE 256
+#define MAX_READ_FRAGMENTS 10
 
 typedef enum {
   Undef_stick = 0,
@@ -54,8 +54,34 @@ typedef enum {
   SIZE_32BIT,
   SIZE_16BIT_S,
   SIZE_32BIT_S,
+  SIZE_8BIT_L,  // low byte of a register shared by two values
+  SIZE_8BIT_H,  // high byte of a register shared by two values
 } RegisterSize_t;
 
+// Texts for the values of an enum register, e.g. the inverter status. Table
+// and texts are kept in flash, see Growatt::GetRegLabel().
+typedef struct {
+  uint8_t count;
+  const char* const* labels;  // PROGMEM strings indexed by the value or NULL
+} sGrowattLabelTable_t;
+
+#define GROWATT_LABEL_SIZE 24  // longest label including the terminator
+
+// label tables in GrowattLabels.cpp, the index is used by register map files
+typedef enum {
+  LabelsNone,
+  LabelsStatus,
+  LabelsPriority,
+  LabelsBDCMode,
+  LabelsCount
+} eGrowattLabels_t;
+
+extern const sGrowattLabelTable_t LABELS_STATUS;
+extern const sGrowattLabelTable_t LABELS_PRIORITY;
+extern const sGrowattLabelTable_t LABELS_BDC_MODE;
+extern const sGrowattLabelTable_t* const GROWATT_LABEL_TABLES[LabelsCount];
+
+// Register along with its last value, see Growatt::GetRegister()
 typedef struct {
   uint16_t address;
   uint32_t value;
@@ -66,6 +92,10 @@ typedef struct {
   RegisterUnit_t unit;
   bool frontend;
   bool plot;
+  uint8_t decimals;  // fixed-point scaling, see sGrowattRegisterDef_t
+  int16_t scale;
+  uint16_t divisor;
+  const sGrowattLabelTable_t* labels;  // PROGMEM, NULL without labels
 } sGrowattModbusReg_t;
 
 // Growatt limits maximal number of registers that can be polled
@@ -75,13 +105,264 @@ typedef struct {
   uint8_t FragmentSize;
 } sGrowattReadFragment_t;
 
+// Fixed-point scaling: a register value is round(raw * scale / divisor) with
+// `decimals` digits after the decimal point. The digits follow from the
+// resolution, scale and divisor from the multiplier at that resolution,
+// e.g. 0.1/0.1 -> 1/1 with 1 decimal, 0.5/1 -> 1/2 with 0 decimals.
+// Factors that do not fit get a scale or divisor of 0, factors that are no
+// integer or reciprocal of one are rounded, see scaleExact(). C++11
+// constexpr, see below.
+constexpr uint8_t scaleDecimals(float resolution) {
+  return resolution >= 0.99f     ? 0
+         : resolution >= 0.099f  ? 1
+         : resolution >= 0.0099f ? 2
+                                 : 3;
+}
+
+constexpr float scaleFactor(float multiplier, uint8_t decimals) {
+  return decimals == 0 ? multiplier
+                       : scaleFactor(multiplier * 10, decimals - 1);
+}
+
+constexpr int16_t scaleNumerator(float factor) {
+  return !(factor < INT16_MAX + 0.5f) ? 0
+         : factor >= 0.99f            ? (int16_t)(factor + 0.5f)
+                                      : 1;
+}
+
+constexpr uint16_t scaleDivisor(float factor) {
+  return !(factor > 0) || factor >= 0.99f        ? 1
+         : !(1 / factor < UINT16_MAX + 0.5f) ? 0
+                                              : (uint16_t)(1 / factor + 0.5f);
+}
+
+constexpr bool scaleNear(float value, float expected) {
+  return value - expected <= expected * 1e-4f &&
+         expected - value <= expected * 1e-4f;
+}
+
+// Register definition as stored in the flash resident protocol tables, the
+// value of the register is kept in sProtocolDefinition_t::InputValues or
+// HoldingValues at the same index. The fixed-point scaling is derived from
+// multiplier and resolution when the table is compiled.
+struct sGrowattRegisterDef_t {
+  uint16_t address;
+  RegisterSize_t size;
+  const char* name;  // PROGMEM
+  float multiplier;
+  float resolution;
+  RegisterUnit_t unit;
+  bool frontend;
+  bool plot;
+  uint8_t decimals;
+  int16_t scale;
+  uint16_t divisor;
+  const sGrowattLabelTable_t* labels;  // PROGMEM, optional
+
+  sGrowattRegisterDef_t() = default;
+  constexpr sGrowattRegisterDef_t(
+      uint16_t address, RegisterSize_t size, const char* name,
+      float multiplier, float resolution, RegisterUnit_t unit, bool frontend,
+      bool plot, const sGrowattLabelTable_t* labels = nullptr)
+      : address(address),
+        size(size),
+        name(name),
+        multiplier(multiplier),
+        resolution(resolution),
+        unit(unit),
+        frontend(frontend),
+        plot(plot),
+        decimals(scaleDecimals(resolution)),
+        scale(scaleNumerator(
+            scaleFactor(multiplier, scaleDecimals(resolution)))),
+        divisor(scaleDivisor(
+            scaleFactor(multiplier, scaleDecimals(resolution)))),
+        labels(labels) {}
+};
+
+// Check that scale / divisor is the multiplier at the resolution, a negative
+// or out of range factor is not
+constexpr bool scaleExact(const sGrowattRegisterDef_t& reg) {
+  return reg.scale > 0 && reg.divisor > 0 &&
+         scaleNear(scaleFactor(reg.multiplier, reg.decimals) * reg.divisor,
+                   reg.scale);
+}
+
+// Groups of registers that outputs can be restricted to, e.g.
+// /status?group=pv,grid. A register may belong to several groups.
+typedef enum {
+  GroupPv = 0x01,
+  GroupGrid = 0x02,
+  GroupBattery = 0x04,
+  GroupLoad = 0x08,
+  GroupEnergy = 0x10,
+  GroupStatus = 0x20,
+  GroupDiagnostics = 0x40,  // also the values of the stick itself
+  GroupSettings = 0x80,
+} eGrowattGroup_t;
+
+#define GROUP_COUNT 8
+
+// Groups of the registers in an address range of a protocol. Ranges may
+// overlap, a register gets the groups of all ranges containing it.
+typedef struct {
+  uint16_t FirstAddress;
+  uint16_t LastAddress;
+  uint8_t Groups;  // eGrowattGroup_t bits
+} sGrowattRegisterGroup_t;
+
 typedef struct {
   uint16_t InputRegisterCount;
   uint8_t InputFragmentCount;
   uint16_t HoldingRegisterCount;
   uint8_t HoldingFragmentCount;
-  sGrowattModbusReg_t InputRegisters[125];
-  sGrowattModbusReg_t HoldingRegisters[35];  // Increased for 307 protocol
-  sGrowattReadFragment_t InputReadFragments[10];
-  sGrowattReadFragment_t HoldingReadFragments[10];
+  uint8_t InputGroupCount;
+  uint8_t HoldingGroupCount;
+  // tables in flash, see readRegisterDef() and readFragmentDef()
+  const sGrowattRegisterDef_t* InputRegisters;
+  const sGrowattRegisterDef_t* HoldingRegisters;
+  const sGrowattReadFragment_t* InputReadFragments;
+  const sGrowattReadFragment_t* HoldingReadFragments;
+  const sGrowattRegisterGroup_t* InputGroups;  // kept by register map files
+  const sGrowattRegisterGroup_t* HoldingGroups;
+  // raw values in RAM, one per register of the tables
+  uint32_t* InputValues;
+  uint32_t* HoldingValues;
 } sProtocolDefinition_t;
+
+// Number of entries of a protocol table
+template <typename T, size_t N>
+constexpr uint16_t tableSize(const T (&)[N]) {
+  return N;
+}
+
+// Compile-time checks of the protocol tables. C++11 constexpr functions may
+// only consist of a return statement, hence the recursion.
+constexpr bool fragmentContains(const sGrowattReadFragment_t& fragment,
+                                uint32_t address) {
+  return address >= fragment.StartAddress &&
+         address < (uint32_t)fragment.StartAddress + fragment.FragmentSize;
+}
+
+constexpr int findFragment(const sGrowattReadFragment_t* fragments,
+                           size_t count, uint32_t address, size_t i = 0) {
+  return i >= count ? -1
+         : fragmentContains(fragments[i], address)
+             ? (int)i
+             : findFragment(fragments, count, address, i + 1);
+}
+
+constexpr bool fragmentsDisjoint(const sGrowattReadFragment_t* fragments,
+                                 size_t count, size_t i = 0, size_t j = 1) {
+  return i >= count ? true
+         : j >= count
+             ? fragmentsDisjoint(fragments, count, i + 1, i + 2)
+             : !fragmentContains(fragments[i], fragments[j].StartAddress) &&
+                   !fragmentContains(fragments[j], fragments[i].StartAddress) &&
+                   fragmentsDisjoint(fragments, count, i, j + 1);
+}
+
+constexpr bool registersInFragments(const sGrowattRegisterDef_t* registers,
+                                    size_t count,
+                                    const sGrowattReadFragment_t* fragments,
+                                    size_t fragmentCount, size_t i = 0) {
+  return i >= count ||
+         (findFragment(fragments, fragmentCount, registers[i].address) >= 0 &&
+          registersInFragments(registers, count, fragments, fragmentCount,
+                               i + 1));
+}
+
+constexpr bool is32Bit(RegisterSize_t size) {
+  return size == SIZE_32BIT || size == SIZE_32BIT_S;
+}
+
+constexpr bool registersNotSplit(const sGrowattRegisterDef_t* registers,
+                                 size_t count,
+                                 const sGrowattReadFragment_t* fragments,
+                                 size_t fragmentCount, size_t i = 0) {
+  return i >= count ||
+         ((!is32Bit(registers[i].size) ||
+           findFragment(fragments, fragmentCount, registers[i].address) ==
+               findFragment(fragments, fragmentCount,
+                            registers[i].address + 1u)) &&
+          registersNotSplit(registers, count, fragments, fragmentCount,
+                            i + 1));
+}
+
+constexpr bool scalesExact(const sGrowattRegisterDef_t* registers,
+                           size_t count, size_t i = 0) {
+  return i >= count ||
+         (scaleExact(registers[i]) && scalesExact(registers, count, i + 1));
+}
+
+constexpr bool groupsOrdered(const sGrowattRegisterGroup_t* groups,
+                             size_t count, size_t i = 0) {
+  return i >= count || (groups[i].FirstAddress <= groups[i].LastAddress &&
+                        groupsOrdered(groups, count, i + 1));
+}
+
+constexpr bool groupsSorted(const sGrowattRegisterGroup_t* groups,
+                            size_t count, size_t i = 1) {
+  return i >= count ||
+         (groups[i - 1].FirstAddress <= groups[i].FirstAddress &&
+          groupsSorted(groups, count, i + 1));
+}
+
+// Check the address ranges of a group table, they may overlap
+#define CHECK_GROUP_TABLE(groups)                                \
+  static_assert(groupsOrdered(groups, tableSize(groups)),        \
+                #groups " has a range ending before its start"); \
+  static_assert(groupsSorted(groups, tableSize(groups)),         \
+                #groups " is not sorted by the first address")
+
+// Check a register table against its enum and its read fragments
+#define CHECK_PROTOCOL_TABLE(registers, count, fragments)                    \
+  static_assert(tableSize(registers) == (count),                             \
+                #registers " does not match its enum");                      \
+  static_assert(tableSize(fragments) <= MAX_READ_FRAGMENTS,                  \
+                #fragments " has more than MAX_READ_FRAGMENTS entries");     \
+  static_assert(fragmentsDisjoint(fragments, tableSize(fragments)),          \
+                #fragments " overlap");                                      \
+  static_assert(registersInFragments(registers, tableSize(registers),        \
+                                     fragments, tableSize(fragments)),       \
+                #registers " has a register outside of all fragments");      \
+  static_assert(registersNotSplit(registers, tableSize(registers),           \
+                                  fragments, tableSize(fragments)),          \
+                #registers " has a 32 bit register split across fragments"); \
+  static_assert(scalesExact(registers, tableSize(registers)),                \
+                #registers " has a multiplier that is not exact in fixed point")
+
+// The tables are in flash, on the ESP8266 it has to be read in aligned words
+inline sGrowattRegisterDef_t readRegisterDef(
+    const sGrowattRegisterDef_t* table, uint16_t index) {
+  sGrowattRegisterDef_t def;
+  memcpy_P(&def, &table[index], sizeof(def));
+  return def;
+}
+
+inline sGrowattReadFragment_t readFragmentDef(
+    const sGrowattReadFragment_t* table, uint8_t index) {
+  sGrowattReadFragment_t fragment;
+  memcpy_P(&fragment, &table[index], sizeof(fragment));
+  return fragment;
+}
+
+inline sGrowattRegisterGroup_t readGroupDef(
+    const sGrowattRegisterGroup_t* table, uint8_t index) {
+  sGrowattRegisterGroup_t group;
+  memcpy_P(&group, &table[index], sizeof(group));
+  return group;
+}
+
+// Most registers are refreshed by the inverter only every few seconds. Track
+// when the raw words of a fragment actually change to learn that period.
+// The time of the last read also tells the age of the values.
+typedef struct {
+  uint32_t Checksum;      // checksum over the raw words of the last read
+  uint32_t LastRead;      // millis() of the last successful read
+  uint32_t LastAttempt;   // millis() of the last read, failed ones too
+  uint32_t LastChange;    // millis() of the last read that returned new words
+  uint32_t Period;        // estimated update period of the inverter [ms]
+  uint32_t Changes;       // number of observed changes
+  uint64_t LastReadTime;  // wall clock of the last read [ms], 0 without NTP
+} sGrowattFragmentCadence_t;
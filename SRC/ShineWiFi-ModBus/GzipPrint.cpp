@@ -0,0 +1,194 @@
+#include "GzipPrint.h"
+
+#define GZIP_NO_POSITION 0xFFFF
+#define GZIP_MIN_MATCH 3
+#define GZIP_MAX_MATCH 258
+
+// deflate length codes 257..285 and distance codes 0..29, RFC 1951 3.2.5
+static const uint16_t LENGTH_BASE[] = {3,  4,  5,  6,   7,   8,   9,   10,
+                                       11, 13, 15, 17,  19,  23,  27,  31,
+                                       35, 43, 51, 59,  67,  83,  99,  115,
+                                       131, 163, 195, 227, 258};
+static const uint8_t LENGTH_EXTRA[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                       1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                       4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t DISTANCE_BASE[] = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,    25,
+    33,   49,   65,   97,   129,  193,   257,   385,   513,   769,
+    1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577};
+static const uint8_t DISTANCE_EXTRA[] = {0, 0, 0, 0, 1, 1, 2,  2,  3,  3,
+                                         4, 4, 5, 5, 6, 6, 7,  7,  8,  8,
+                                         9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// CRC-32 of gzip, four bits at a time
+static const uint32_t CRC_TABLE[] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+    0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+
+static uint16_t hashAt(const uint8_t* data) {
+  return (((uint16_t)data[0] << 6) ^ ((uint16_t)data[1] << 3) ^ data[2]) &
+         ((1 << GZIP_HASH_BITS) - 1);
+}
+
+GzipPrint::GzipPrint(Print& out)
+    : _Out(out),
+      _Fill(GZIP_WINDOW_SIZE),
+      _HistoryStart(GZIP_WINDOW_SIZE),
+      _Bits(0),
+      _BitCount(0),
+      _BufferFill(0),
+      _Crc(0xFFFFFFFF),
+      _InputSize(0),
+      _OutputSize(0) {
+  for (uint16_t i = 0; i < (1 << GZIP_HASH_BITS); i++) {
+    _Head[i] = GZIP_NO_POSITION;
+  }
+  // magic, deflate, no flags, no time, no extra flags, unknown OS
+  const uint8_t header[] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+  for (uint8_t b : header) writeByte(b);
+}
+
+size_t GzipPrint::write(uint8_t c) { return write(&c, 1); }
+
+size_t GzipPrint::write(const uint8_t* buffer, size_t size) {
+  _InputSize += size;
+  for (size_t i = 0; i < size; i++) {
+    _Crc ^= buffer[i];
+    _Crc = (_Crc >> 4) ^ CRC_TABLE[_Crc & 0x0F];
+    _Crc = (_Crc >> 4) ^ CRC_TABLE[_Crc & 0x0F];
+  }
+  size_t done = 0;
+  while (done < size) {
+    const size_t n = min(size - done, (size_t)(2 * GZIP_WINDOW_SIZE - _Fill));
+    memcpy(_Window + _Fill, buffer + done, n);
+    _Fill += n;
+    done += n;
+    if (_Fill == 2 * GZIP_WINDOW_SIZE) compressBlock(false);
+  }
+  return size;
+}
+
+void GzipPrint::Finish() {
+  /**
+   * @brief Compress the rest as last block and write the trailer
+   */
+  compressBlock(true);
+  if (_BitCount > 0) writeBits(0, 8 - _BitCount);
+  const uint32_t trailer[] = {~_Crc, (uint32_t)_InputSize};
+  for (uint32_t value : trailer) {
+    for (uint8_t i = 0; i < 4; i++) writeByte(value >> (8 * i));
+  }
+  flushBuffer();
+}
+
+size_t GzipPrint::GetInputSize() { return _InputSize; }
+
+size_t GzipPrint::GetOutputSize() { return _OutputSize + _BufferFill; }
+
+void GzipPrint::compressBlock(bool final) {
+  /**
+   * @brief Compress the new data of the window into a block with the fixed
+   * Huffman codes. Matches may reach back into the previous window.
+   * @param final last block of the stream, the window is not moved on
+   */
+  writeBits(final ? 1 : 0, 1);
+  writeBits(1, 2);  // fixed Huffman codes
+
+  uint16_t p = GZIP_WINDOW_SIZE;
+  while (p < _Fill) {
+    uint16_t length = 0;
+    uint16_t distance = 0;
+    if (p + GZIP_MIN_MATCH <= _Fill) {
+      const uint16_t hash = hashAt(_Window + p);
+      const uint16_t candidate = _Head[hash];
+      _Head[hash] = p;
+      if (candidate != GZIP_NO_POSITION && candidate >= _HistoryStart) {
+        const uint16_t limit = min(GZIP_MAX_MATCH, _Fill - p);
+        uint16_t l = 0;
+        while (l < limit && _Window[candidate + l] == _Window[p + l]) l++;
+        if (l >= GZIP_MIN_MATCH) {
+          length = l;
+          distance = p - candidate;
+        }
+      }
+    }
+    if (length == 0) {
+      writeLiteral(_Window[p++]);
+      continue;
+    }
+    writeMatch(length, distance);
+    for (uint16_t q = p + 1; q < p + length && q + GZIP_MIN_MATCH <= _Fill;
+         q++) {
+      _Head[hashAt(_Window + q)] = q;
+    }
+    p += length;
+  }
+  writeCode(0, 7);  // end of block
+
+  if (final) return;
+  // the new data becomes the history of the next block
+  memmove(_Window, _Window + GZIP_WINDOW_SIZE, GZIP_WINDOW_SIZE);
+  for (uint16_t i = 0; i < (1 << GZIP_HASH_BITS); i++) {
+    _Head[i] = _Head[i] != GZIP_NO_POSITION && _Head[i] >= GZIP_WINDOW_SIZE
+                   ? _Head[i] - GZIP_WINDOW_SIZE
+                   : GZIP_NO_POSITION;
+  }
+  _HistoryStart = 0;
+  _Fill = GZIP_WINDOW_SIZE;
+}
+
+void GzipPrint::writeBits(uint32_t bits, uint8_t count) {
+  _Bits |= bits << _BitCount;
+  _BitCount += count;
+  while (_BitCount >= 8) {
+    writeByte(_Bits);
+    _Bits >>= 8;
+    _BitCount -= 8;
+  }
+}
+
+void GzipPrint::writeCode(uint16_t code, uint8_t length) {
+  // Huffman codes are sent starting with their most significant bit
+  uint16_t reversed = 0;
+  for (uint8_t i = 0; i < length; i++) {
+    reversed = (reversed << 1) | ((code >> i) & 1);
+  }
+  writeBits(reversed, length);
+}
+
+void GzipPrint::writeLiteral(uint8_t literal) {
+  if (literal < 144) {
+    writeCode(0x30 + literal, 8);
+  } else {
+    writeCode(0x190 + literal - 144, 9);
+  }
+}
+
+void GzipPrint::writeMatch(uint16_t length, uint16_t distance) {
+  uint8_t code = sizeof(LENGTH_BASE) / sizeof(LENGTH_BASE[0]) - 1;
+  while (LENGTH_BASE[code] > length) code--;
+  const uint16_t symbol = 257 + code;
+  if (symbol < 280) {
+    writeCode(symbol - 256, 7);
+  } else {
+    writeCode(0xC0 + symbol - 280, 8);
+  }
+  writeBits(length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+
+  code = sizeof(DISTANCE_BASE) / sizeof(DISTANCE_BASE[0]) - 1;
+  while (DISTANCE_BASE[code] > distance) code--;
+  writeCode(code, 5);
+  writeBits(distance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+}
+
+void GzipPrint::writeByte(uint8_t byte) {
+  _Buffer[_BufferFill++] = byte;
+  if (_BufferFill == GZIP_OUT_BUFFER_SIZE) flushBuffer();
+}
+
+void GzipPrint::flushBuffer() {
+  _Out.write(_Buffer, _BufferFill);
+  _OutputSize += _BufferFill;
+  _BufferFill = 0;
+}
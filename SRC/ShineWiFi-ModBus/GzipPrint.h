@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Arduino.h"
+
+// longest distance of a match, RAM use is about 2.75 times this
+#ifndef GZIP_WINDOW_SIZE
+#define GZIP_WINDOW_SIZE 4096
+#endif
+#define GZIP_HASH_BITS 10
+// compressed bytes handed to the output at once
+#define GZIP_OUT_BUFFER_SIZE 1024
+
+// Compresses everything written to it into a gzip stream on another Print.
+// Deflate with the fixed Huffman codes and a sliding window of
+// GZIP_WINDOW_SIZE bytes: the memory use does not depend on the size of the
+// payload, one block is emitted per window. Finish() has to follow the last
+// write.
+class GzipPrint : public Print {
+ public:
+  GzipPrint(Print& out);
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  void Finish();
+  size_t GetInputSize();
+  size_t GetOutputSize();
+
+ private:
+  Print& _Out;
+  uint8_t _Window[2 * GZIP_WINDOW_SIZE];  // history followed by new data
+  uint16_t _Head[1 << GZIP_HASH_BITS];    // last position of a hash
+  uint16_t _Fill;          // end of the data in _Window
+  uint16_t _HistoryStart;  // first valid position of the history
+  uint32_t _Bits;
+  uint8_t _BitCount;
+  uint8_t _Buffer[GZIP_OUT_BUFFER_SIZE];
+  uint16_t _BufferFill;
+  uint32_t _Crc;
+  size_t _InputSize;
+  size_t _OutputSize;
+
+  void compressBlock(bool final);
+  void writeBits(uint32_t bits, uint8_t count);
+  void writeCode(uint16_t code, uint8_t length);
+  void writeLiteral(uint8_t literal);
+  void writeMatch(uint16_t length, uint16_t distance);
+  void writeByte(uint8_t byte);
+  void flushBuffer();
+};
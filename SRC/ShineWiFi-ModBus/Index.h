@@ -142,64 +142,151 @@ copies or substantial portions of the Software. -->
         }
     });
 
-    setInterval(function () {
+    // names, units, plot flags and label tables from /ui/meta
+    let meta = null;
+    // latest value of every field, in the order of meta.Names
+    let values = [];
+
+    function showField(i) {
+        var element = document.getElementById("field" + i);
+        var key = meta.Names[i];
+        var unit = meta.Units[i];
+        var labels = meta.Labels[i];
+        if (labels && labels[values[i]] != null) {
+            unit = "(" + labels[values[i]] + ")";
+        }
+        // values that are too old are sent as null
+        var text = values[i] == null ? "&ndash;" : values[i] + "&#8239;" + unit;
+        element.innerHTML = "<a href=\"/value/" + key + "\">" + key + "</a>: " +
+                            text;
+    }
+
+    // one point per poll, unchanged values are repeated
+    function addChartPoint() {
+        let date = new Date();
+        powerchartData.labels.push(date.getHours() + ":" + date.getMinutes() + ":" + date.getSeconds());
+        for (var dset in powerchartData.datasets) {
+            powerchartData.datasets[dset].data.push(values[powerchartData.datasets[dset].field]);
+        }
+        powerchart.update();
+    }
+
+    // builds the data view and the chart once, the fields only change
+    // with the protocol
+    function showMeta(obj) {
+        meta = obj;
+        container = document.getElementById("DataContainer");
+        container.innerHTML = "";
+        if (meta.Hostname) {
+            var element = document.createElement("p");
+            element.textContent = "Hostname: " + meta.Hostname;
+            container.appendChild(element);
+        }
+        for (var i = 0; i < meta.Names.length; i++) {
+            // Add Data Labels to chart
+            if (meta.Plot[i] == true) {
+                const newDataset = {
+                    label: meta.Names[i],
+                    field: i,
+                    data: [],
+                    fill: false,
+                    borderColor: namedColor(powerchart.data.datasets.length),
+                    tension: 0.1
+                };
+                powerchartData.datasets.push(newDataset);
+            }
+            // init dataview
+            var element = document.createElement("p");
+            element.setAttribute("id", "field" + i);
+            container.appendChild(element);
+        }
+        initialised = true;
+    }
+
+    // all values, from /ui/values or the snapshot event
+    function showSnapshot(arr) {
+        if (!initialised) {
+            return;
+        }
+        if (arr.length != meta.Names.length) {
+            // the protocol changed, the fields are different
+            location.reload();
+            return;
+        }
+        values = arr;
+        for (var i = 0; i < values.length; i++) {
+            showField(i);
+        }
+        addChartPoint();
+    }
+
+    // the [field, value] pairs that changed with a poll
+    function showUpdate(arr) {
+        if (!initialised || values.length == 0) {
+            return;
+        }
+        for (var i = 0; i < arr.length; i++) {
+            if (arr[i][0] < values.length) {
+                values[arr[i][0]] = arr[i][1];
+                showField(arr[i][0]);
+            }
+        }
+        addChartPoint();
+    }
+
+    function startPolling() {
+        setInterval(function () {
+            var xhttp = new XMLHttpRequest();
+            xhttp.onreadystatechange = function () {
+                if (this.readyState == 4 && this.status == 200) {
+                    showSnapshot(JSON.parse(this.responseText));
+                }
+            }
+            xhttp.open("GET", "./ui/values", true);
+            xhttp.send();
+        }, 5000);
+    }
+
+    // the stick pushes the values after every poll, without event support
+    // or if it has too many clients they are fetched every 5 seconds
+    function startUpdates() {
+        if (window.EventSource) {
+            const source = new EventSource("./events");
+            source.addEventListener("snapshot", function (e) {
+                showSnapshot(JSON.parse(e.data));
+            });
+            source.addEventListener("update", function (e) {
+                showUpdate(JSON.parse(e.data));
+            });
+            source.onerror = function () {
+                // reconnects by itself unless the request was refused
+                if (source.readyState == EventSource.CLOSED) {
+                    startPolling();
+                }
+            };
+        } else {
+            startPolling();
+        }
+    }
+
+    // the fields are fetched once, then only their values
+    function loadMeta() {
         var xhttp = new XMLHttpRequest();
         xhttp.onreadystatechange = function () {
-            if (this.readyState == 4 && this.status == 200) {
-                // add data fields to the main page
-                var obj = JSON.parse(this.responseText);
-                // Add Date to chart x Axis
-                let date = new Date();
-                powerchartData.labels.push(date.getHours() + ":" + date.getMinutes() + ":" + date.getSeconds());
-                if (initialised == false) {
-                    initialised = true;
-                    // clear data view container just in case
-                    container = document.getElementById("DataContainer");
-                    container.innerHTML = "";
-                    // Add Data Labels to chart
-                    for (var key in obj) {
-                        if (obj[key][2] == true) {
-                            const newDataset = {
-                                label: key,
-                                data: [obj[key][0]],
-                                fill: false,
-                                borderColor: namedColor(powerchart.data.datasets.length),
-                                tension: 0.1
-                            };
-                            powerchartData.datasets.push(newDataset);
-                            powerchart.update();
-                        }
-                        // init dataview
-                        var element = document.createElement("p");
-                        element.innerHTML = "<a href=\"/value/" + key + "\">" + key + "</a>: " +
-                                            obj[key][0] + "&#8239;" + obj[key][1];
-                        element.setAttribute("id", key);
-                        container.appendChild(element);
-                    }
-                } else {
-                    // Update Data in chart
-                    for (var key in obj) {
-                        // find dataset in array
-                        if (obj[key][2] == true) {
-                            for (var dset in powerchartData.datasets) {
-                                let leb = powerchartData.datasets[dset].label;
-                                if (leb == key) {
-                                    powerchartData.datasets[dset].data.push(obj[key][0]);
-                                }
-                            }
-                        }
-                        // update data view
-                        var element = document.getElementById(key);
-                        element.innerHTML = "<a href=\"/value/" + key + "\">" + key + "</a>: " +
-                                            obj[key][0] + "&#8239;" + obj[key][1];
-                        powerchart.update();
-                    }
-                }
+            if (this.readyState != 4) {
+                return;
+            }
+            if (this.status == 200) {
+                showMeta(JSON.parse(this.responseText));
+                startUpdates();
+            } else {
+                setTimeout(loadMeta, 5000);
             }
         }
-        xhttp.open("GET", "./uiStatus", true);
+        xhttp.open("GET", "./ui/meta", true);
         xhttp.send();
-    }, 5000);
+    }
+    loadMeta();
 </script>
 </body>
 </html>
@@ -0,0 +1,89 @@
+#include "InverterPoller.h"
+
+#if defined(ESP32) && NUM_INVERTERS > 1
+#define POLL_TASK_STACK_SIZE 4096
+#define POLL_TASK_PRIORITY 1
+#endif
+
+InverterPoller::InverterPoller(Growatt* inverters, uint8_t count,
+                               uint8_t retries)
+    : _Inverters(inverters), _Count(count), _Retries(retries) {}
+
+void InverterPoller::begin() {
+  /**
+   * @brief Start one poll task per inverter (ESP32 with several inverters
+   * only), the tasks sleep until ReadAll() is called
+   */
+#if defined(ESP32) && NUM_INVERTERS > 1
+  _Done = xSemaphoreCreateCounting(_Count, 0);
+  for (uint8_t i = 0; i < _Count; i++) {
+    char name[16];
+    snprintf(name, sizeof(name), "poll%d", i + 1);
+    _TaskArgs[i] = {this, i};
+    xTaskCreate(pollTask, name, POLL_TASK_STACK_SIZE, &_TaskArgs[i],
+                POLL_TASK_PRIORITY, &_Tasks[i]);
+  }
+#endif
+}
+
+bool InverterPoller::readInverter(Growatt& inverter, uint8_t retries) {
+  /**
+   * @brief Read the data of one inverter, retry a few times on errors
+   * @param inverter inverter to read
+   * @param retries number of attempts
+   * @returns true if the data was read successfully
+   */
+#if SIMULATE_INVERTER == 1
+  (void)inverter;
+  (void)retries;
+  return true;
+#else
+  if (inverter.GetWiFiStickType() == Undef_stick ||
+      inverter.GetProtocolVersion() == 0) {
+    return false;
+  }
+  for (uint8_t i = 0; i < retries; i++) {
+    if (inverter.ReadData(i > 0)) {
+      return true;
+    }
+  }
+  return false;
+#endif
+}
+
+#if defined(ESP32) && NUM_INVERTERS > 1
+void InverterPoller::pollTask(void* arg) {
+  sPollTaskArg_t* taskArg = (sPollTaskArg_t*)arg;
+  InverterPoller* poller = taskArg->poller;
+
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    poller->_Results[taskArg->index] = readInverter(
+        poller->_Inverters[taskArg->index], poller->_Retries);
+    xSemaphoreGive(poller->_Done);
+  }
+}
+#endif
+
+void InverterPoller::ReadAll(bool* results) {
+  /**
+   * @brief Read all inverters and wait until they are done
+   * @param results array receiving the result of every inverter
+   */
+#if defined(ESP32) && NUM_INVERTERS > 1
+  for (uint8_t i = 0; i < _Count; i++) {
+    xTaskNotifyGive(_Tasks[i]);
+  }
+  // the modbus timeouts bound the time a task can take
+  for (uint8_t i = 0; i < _Count; i++) {
+    xSemaphoreTake(_Done, portMAX_DELAY);
+  }
+  for (uint8_t i = 0; i < _Count; i++) {
+    results[i] = _Results[i];
+  }
+#else
+  for (uint8_t i = 0; i < _Count; i++) {
+    results[i] = readInverter(_Inverters[i], _Retries);
+  }
+#endif
+}
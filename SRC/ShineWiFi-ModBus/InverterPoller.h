@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Growatt.h"
+
+#if defined(ESP32) && NUM_INVERTERS > 1
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#endif
+
+// Reads all inverters of a poll cycle. On ESP32 with several inverters every
+// inverter is read by its own task, so the transfers on the UARTs overlap and
+// a cycle takes about as long as the slowest inverter. The main loop waits
+// until all tasks are done, the register images are never accessed
+// concurrently.
+class InverterPoller {
+ public:
+  InverterPoller(Growatt* inverters, uint8_t count, uint8_t retries);
+  void begin();
+  void ReadAll(bool* results);
+
+ private:
+  Growatt* _Inverters;
+  uint8_t _Count;
+  uint8_t _Retries;
+
+  static bool readInverter(Growatt& inverter, uint8_t retries);
+#if defined(ESP32) && NUM_INVERTERS > 1
+  typedef struct {
+    InverterPoller* poller;
+    uint8_t index;
+  } sPollTaskArg_t;
+
+  TaskHandle_t _Tasks[NUM_INVERTERS];
+  sPollTaskArg_t _TaskArgs[NUM_INVERTERS];
+  bool _Results[NUM_INVERTERS];
+  SemaphoreHandle_t _Done;
+
+  static void pollTask(void* arg);
+#endif
+};
@@ -0,0 +1,117 @@
+#include "JsonWriter.h"
+
+JsonWriter::JsonWriter(Print& out) : _Out(out), _First(true) {}
+
+void JsonWriter::BeginObject() {
+  _Out.print('{');
+  _First = true;
+}
+
+void JsonWriter::EndObject() {
+  _Out.print('}');
+  _First = false;
+}
+
+void JsonWriter::BeginArray() {
+  _Out.print('[');
+  _First = true;
+}
+
+void JsonWriter::EndArray() {
+  _Out.print(']');
+  _First = false;
+}
+
+void JsonWriter::Element() {
+  /**
+   * @brief Start the next array element, its value has to follow
+   */
+  if (!_First) _Out.print(',');
+  _First = false;
+}
+
+void JsonWriter::Key(const char* name, const char* suffix) {
+  /**
+   * @brief Start the next member, its value has to follow
+   * @param name key of the member
+   * @param suffix appended to the key, e.g. for derived members
+   */
+  if (!_First) _Out.print(',');
+  _First = false;
+  _Out.print('"');
+  writeText(name);
+  if (suffix != NULL) writeText(suffix);
+  _Out.print(F("\":"));
+}
+
+void JsonWriter::Raw(const char* text) {
+  /**
+   * @brief Write a value as is, e.g. a formatted number or true/false
+   */
+  _Out.print(text);
+}
+
+void JsonWriter::Text(const char* text) {
+  _Out.print('"');
+  writeText(text);
+  _Out.print('"');
+}
+
+void JsonWriter::TextP(PGM_P text) {
+  _Out.print('"');
+  for (char c = pgm_read_byte(text); c != '\0'; c = pgm_read_byte(++text)) {
+    writeChar(c);
+  }
+  _Out.print('"');
+}
+
+void JsonWriter::writeText(const char* text) {
+  while (*text) writeChar(*text++);
+}
+
+void JsonWriter::writeChar(char c) {
+  // the escape sequences of ArduinoJson, other characters are written as is
+  const char* escape = NULL;
+  switch (c) {
+    case '"':
+      escape = "\\\"";
+      break;
+    case '\\':
+      escape = "\\\\";
+      break;
+    case '\b':
+      escape = "\\b";
+      break;
+    case '\f':
+      escape = "\\f";
+      break;
+    case '\n':
+      escape = "\\n";
+      break;
+    case '\r':
+      escape = "\\r";
+      break;
+    case '\t':
+      escape = "\\t";
+      break;
+  }
+  if (escape != NULL) {
+    _Out.print(escape);
+  } else {
+    _Out.print(c);
+  }
+}
+
+LengthPrint::LengthPrint() : _Length(0) {}
+
+size_t LengthPrint::write(uint8_t) {
+  _Length++;
+  return 1;
+}
+
+size_t LengthPrint::write(const uint8_t*, size_t size) {
+  _Length += size;
+  return size;
+}
+
+size_t LengthPrint::GetLength() { return _Length; }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Arduino.h"
+
+// Writes JSON member by member straight to a Print, without a document in
+// between. The text is the same serializeJson() produces for a JsonDocument
+// with these members. Objects and arrays may be nested, every member starts
+// with Key() and every array element with Element().
+class JsonWriter {
+ public:
+  JsonWriter(Print& out);
+  void BeginObject();
+  void EndObject();
+  void BeginArray();
+  void EndArray();
+  void Element();
+  void Key(const char* name, const char* suffix = NULL);
+  void Raw(const char* text);
+  void Text(const char* text);
+  void TextP(PGM_P text);
+
+ private:
+  Print& _Out;
+  bool _First;
+
+  void writeText(const char* text);
+  void writeChar(char c);
+};
+
+// Counts the bytes written to it, e.g. to announce the length of a stream
+class LengthPrint : public Print {
+ public:
+  LengthPrint();
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  size_t GetLength();
+
+ private:
+  size_t _Length;
+};
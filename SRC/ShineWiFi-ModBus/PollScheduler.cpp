@@ -0,0 +1,77 @@
+#include "PollScheduler.h"
+
+#include <sys/time.h>
+#include <time.h>
+
+PollScheduler::PollScheduler(uint32_t period, bool alignToWallClock)
+    : _Period(period),
+      _AlignToWallClock(alignToWallClock),
+      _Started(false),
+      _Aligned(false),
+      _Deadline(0),
+      _Ticks(0),
+      _MissedTicks(0) {}
+
+bool PollScheduler::Due(uint32_t now) {
+  /**
+   * @brief Check if the next deadline has been reached. If so the deadline
+   * is advanced by one period, deadlines that passed while the previous
+   * cycle was still running are skipped and counted as missed.
+   * @param now current millis()
+   * @returns true once per period
+   */
+  if (!_Started) {
+    _Started = true;
+    _Deadline = now;
+  }
+  if ((int32_t)(now - _Deadline) < 0) {
+    return false;
+  }
+
+  uint32_t missed = (now - _Deadline) / _Period;
+  _MissedTicks += missed;
+  _Deadline += (missed + 1) * _Period;
+  _Ticks++;
+
+  if (_AlignToWallClock) {
+    alignDeadline(now);
+  }
+  return true;
+}
+
+void PollScheduler::alignDeadline(uint32_t now) {
+  /**
+   * @brief Move the next deadline to the closest multiple of the period on
+   * the wall clock. Doing this every tick also compensates the drift between
+   * millis() and the NTP time.
+   * @param now current millis()
+   */
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  if (tv.tv_sec < WALLCLOCK_VALID_EPOCH) {
+    return;
+  }
+
+  uint64_t wallNow = (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+  uint32_t offset = (wallNow + (_Deadline - now)) % _Period;
+  if (offset < _Period / 2) {
+    _Deadline -= offset;
+  } else {
+    _Deadline += _Period - offset;
+  }
+  // never schedule into the past, that would count as a missed tick
+  if ((int32_t)(_Deadline - now) <= 0) {
+    _Deadline += _Period;
+  }
+  _Aligned = true;
+}
+
+uint32_t PollScheduler::GetPeriod() { return _Period; }
+
+uint32_t PollScheduler::GetNextDeadline() { return _Deadline; }
+
+uint32_t PollScheduler::GetTicks() { return _Ticks; }
+
+uint32_t PollScheduler::GetMissedTicks() { return _MissedTicks; }
+
+bool PollScheduler::IsAligned() { return _Aligned; }
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Arduino.h"
+
+// 2021-01-01, anything before means the clock was not set by NTP yet
+#define WALLCLOCK_VALID_EPOCH 1609459200
+
+// Fixed-rate scheduler: keeps a sequence of deadlines that is independent of
+// how long a poll cycle takes. Once the wall clock has been set via NTP the
+// deadlines can be aligned to multiples of the period (e.g. :00, :05, ...),
+// so samples of several sticks line up in time.
+class PollScheduler {
+ public:
+  PollScheduler(uint32_t period, bool alignToWallClock);
+  bool Due(uint32_t now);
+  uint32_t GetPeriod();
+  uint32_t GetNextDeadline();
+  uint32_t GetTicks();
+  uint32_t GetMissedTicks();
+  bool IsAligned();
+
+ private:
+  uint32_t _Period;
+  bool _AlignToWallClock;
+  bool _Started;
+  bool _Aligned;
+  uint32_t _Deadline;
+  uint32_t _Ticks;
+  uint32_t _MissedTicks;
+
+  void alignDeadline(uint32_t now);
+};
@@ -0,0 +1,180 @@
+#include "RegisterMap.h"
+
+#if ENABLE_REGISTER_MAP_FILE == 1
+#include <TLog.h>
+#include <new>
+
+// a modbus read returns at most 125 registers
+#define MAX_FRAGMENT_SIZE 125
+
+RegisterMap::RegisterMap() : _Buffer(NULL), _Version(0) {}
+
+RegisterMap::~RegisterMap() { delete[] _Buffer; }
+
+String RegisterMap::GetPath(uint16_t version) {
+  /**
+   * @brief Name of the map file of a protocol
+   * @param version protocol version
+   * @returns path of the file on LittleFS
+   */
+  return "/regmap" + String(version) + ".bin";
+}
+
+uint16_t RegisterMap::GetVersion() { return _Version; }
+
+bool RegisterMap::fail(const String& path, const __FlashStringHelper* reason) {
+  Log.print(F("Register map "));
+  Log.print(path);
+  Log.print(F(": "));
+  Log.println(reason);
+  return false;
+}
+
+bool RegisterMap::readChecked(File& file, void* data, size_t size,
+                              uint32_t& checksum) {
+  /**
+   * @brief Read the next bytes of the file and add them to the checksum
+   * @returns false if the file is too short
+   */
+  uint8_t* bytes = (uint8_t*)data;
+  if (file.read(bytes, size) != size) return false;
+  for (size_t i = 0; i < size; i++) {
+    checksum = (checksum ^ bytes[i]) * 16777619u;
+  }
+  return true;
+}
+
+bool RegisterMap::Load(const String& path, uint16_t version,
+                       sProtocolDefinition_t& protocol) {
+  /**
+   * @brief Load a map file and point the protocol tables into it. The file
+   * is read once from start to end, the tables share a single allocation.
+   * @param path file on LittleFS
+   * @param version protocol the map has to belong to, 0 accepts any
+   * @param protocol protocol definition to update, it is left untouched if
+   * the file is missing or invalid
+   * @returns true if the map was loaded
+   */
+  if (!LittleFS.exists(path)) return false;
+  File file = LittleFS.open(path, "r");
+  if (!file) return fail(path, F("cannot open"));
+
+  sRegisterMapHeader_t header;
+  if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+      memcmp(header.magic, REGISTER_MAP_MAGIC, sizeof(header.magic)) != 0) {
+    return fail(path, F("not a register map"));
+  }
+  if (version != 0 && header.version != version) {
+    return fail(path, F("belongs to another protocol"));
+  }
+  const uint16_t registerCount =
+      header.inputRegisterCount + header.holdingRegisterCount;
+  const uint8_t fragmentCount =
+      header.inputFragmentCount + header.holdingFragmentCount;
+  if (header.inputFragmentCount > MAX_READ_FRAGMENTS ||
+      header.holdingFragmentCount > MAX_READ_FRAGMENTS ||
+      header.namesSize == 0) {
+    return fail(path, F("invalid header"));
+  }
+  if (file.size() != sizeof(header) +
+                         fragmentCount * sizeof(sRegisterMapFragment_t) +
+                         registerCount * sizeof(sRegisterMapRegister_t) +
+                         header.namesSize) {
+    return fail(path, F("wrong size"));
+  }
+
+  // registers first, they need the strictest alignment
+  const size_t registersSize = registerCount * sizeof(sGrowattRegisterDef_t);
+  const size_t fragmentsSize = fragmentCount * sizeof(sGrowattReadFragment_t);
+  uint8_t* buffer =
+      new (std::nothrow) uint8_t[registersSize + fragmentsSize +
+                                 header.namesSize];
+  if (buffer == NULL) return fail(path, F("out of memory"));
+  sGrowattRegisterDef_t* registers = (sGrowattRegisterDef_t*)buffer;
+  sGrowattReadFragment_t* fragments =
+      (sGrowattReadFragment_t*)(buffer + registersSize);
+  char* names = (char*)(buffer + registersSize + fragmentsSize);
+
+  uint32_t checksum = 2166136261u;
+  const __FlashStringHelper* error = NULL;
+  for (uint8_t i = 0; i < fragmentCount && !error; i++) {
+    sRegisterMapFragment_t entry;
+    if (!readChecked(file, &entry, sizeof(entry), checksum)) {
+      error = F("truncated");
+    } else if (entry.size == 0 || entry.size > MAX_FRAGMENT_SIZE) {
+      error = F("invalid fragment size");
+    }
+    fragments[i] = {entry.start, entry.size};
+  }
+  const sGrowattReadFragment_t* holdingFragments =
+      fragments + header.inputFragmentCount;
+  if (!error &&
+      (!fragmentsDisjoint(fragments, header.inputFragmentCount) ||
+       !fragmentsDisjoint(holdingFragments, header.holdingFragmentCount))) {
+    error = F("overlapping fragments");
+  }
+
+  for (uint16_t i = 0; i < registerCount && !error; i++) {
+    sRegisterMapRegister_t entry;
+    if (!readChecked(file, &entry, sizeof(entry), checksum)) {
+      error = F("truncated");
+      break;
+    }
+    const bool holding = i >= header.inputRegisterCount;
+    const sGrowattReadFragment_t* frags =
+        holding ? holdingFragments : fragments;
+    const uint8_t count =
+        holding ? header.holdingFragmentCount : header.inputFragmentCount;
+    const int fragment = findFragment(frags, count, entry.address);
+    if (entry.size > SIZE_8BIT_H || entry.unit > POWER_REACTIVE ||
+        entry.name >= header.namesSize || entry.labels >= LabelsCount) {
+      error = F("invalid register");
+    } else if (fragment < 0) {
+      error = F("register outside of all fragments");
+    } else if (is32Bit((RegisterSize_t)entry.size) &&
+               findFragment(frags, count, entry.address + 1u) != fragment) {
+      error = F("32 bit register split across fragments");
+    }
+    registers[i] = {entry.address,
+                    (RegisterSize_t)entry.size,
+                    names + entry.name,
+                    entry.multiplier,
+                    entry.resolution,
+                    (RegisterUnit_t)entry.unit,
+                    (entry.flags & REGISTER_MAP_FRONTEND) != 0,
+                    (entry.flags & REGISTER_MAP_PLOT) != 0,
+                    entry.labels < LabelsCount
+                        ? GROWATT_LABEL_TABLES[entry.labels]
+                        : NULL};
+    if (!error && (!(entry.resolution > 0) || !scaleExact(registers[i]))) {
+      error = F("invalid multiplier or resolution");
+    }
+  }
+
+  if (!error && (!readChecked(file, names, header.namesSize, checksum) ||
+                 names[header.namesSize - 1] != '\0')) {
+    error = F("invalid name pool");
+  }
+  if (!error && checksum != header.checksum) {
+    error = F("checksum mismatch");
+  }
+  file.close();
+  if (error) {
+    delete[] buffer;
+    return fail(path, error);
+  }
+
+  delete[] _Buffer;
+  _Buffer = buffer;
+  _Version = header.version;
+  protocol.InputRegisterCount = header.inputRegisterCount;
+  protocol.HoldingRegisterCount = header.holdingRegisterCount;
+  protocol.InputFragmentCount = header.inputFragmentCount;
+  protocol.HoldingFragmentCount = header.holdingFragmentCount;
+  protocol.InputRegisters = registers;
+  protocol.HoldingRegisters = registers + header.inputRegisterCount;
+  protocol.InputReadFragments = fragments;
+  protocol.HoldingReadFragments = holdingFragments;
+  return true;
+}
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Config.h"
+
+#ifndef ENABLE_REGISTER_MAP_FILE
+#define ENABLE_REGISTER_MAP_FILE 0
+#endif
+
+#if ENABLE_REGISTER_MAP_FILE == 1
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "GrowattTypes.h"
+
+#define REGISTER_MAP_MAGIC "GRM1"
+
+// Register map file, created by Tools/regmap_compiler.py. All values are
+// little endian, the file consists of:
+//   sRegisterMapHeader_t
+//   input fragments, holding fragments    sRegisterMapFragment_t
+//   input registers, holding registers    sRegisterMapRegister_t
+//   name pool                             zero terminated strings
+typedef struct __attribute__((packed)) {
+  char magic[4];     // REGISTER_MAP_MAGIC
+  uint16_t version;  // protocol the map replaces the tables of
+  uint16_t inputRegisterCount;
+  uint16_t holdingRegisterCount;
+  uint8_t inputFragmentCount;
+  uint8_t holdingFragmentCount;
+  uint16_t namesSize;
+  uint16_t reserved;
+  uint32_t checksum;  // FNV-1a over everything after the header
+} sRegisterMapHeader_t;
+
+typedef struct __attribute__((packed)) {
+  uint16_t start;
+  uint8_t size;
+} sRegisterMapFragment_t;
+
+typedef struct __attribute__((packed)) {
+  uint16_t address;
+  uint8_t size;   // RegisterSize_t
+  uint8_t unit;   // RegisterUnit_t
+  uint16_t name;  // offset in the name pool
+  uint8_t flags;   // REGISTER_MAP_FRONTEND | REGISTER_MAP_PLOT
+  uint8_t labels;  // eGrowattLabels_t
+  float multiplier;
+  float resolution;
+} sRegisterMapRegister_t;
+
+#define REGISTER_MAP_FRONTEND 0x01
+#define REGISTER_MAP_PLOT 0x02
+
+// Replaces the flash resident tables of a protocol with the ones of a map
+// file. The file is checked and converted in a single pass into one buffer,
+// the protocol struct points into it until the next Load().
+class RegisterMap {
+ public:
+  RegisterMap();
+  ~RegisterMap();
+  bool Load(const String& path, uint16_t version,
+            sProtocolDefinition_t& protocol);
+  uint16_t GetVersion();
+  static String GetPath(uint16_t version);
+
+ private:
+  uint8_t* _Buffer;
+  uint16_t _Version;
+
+  bool readChecked(File& file, void* data, size_t size, uint32_t& checksum);
+  bool fail(const String& path, const __FlashStringHelper* reason);
+};
+#endif
@@ -0,0 +1,117 @@
+#include "ResponseCache.h"
+
+#include <new>
+
+#ifdef ESP32
+#include <esp_random.h>
+#endif
+
+ResponseCache::ResponseCache() : _Used(0), _BootId(0) {
+  for (uint8_t t = 0; t < CachedCount; t++) {
+    for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+      _Entries[t][i] = {NULL, 0, 0};
+    }
+  }
+}
+
+void ResponseCache::begin() {
+#ifdef ESP32
+  _BootId = esp_random();
+#else
+  _BootId = ESP.random();
+#endif
+}
+
+void ResponseCache::FormatETag(uint32_t generation, bool gzip, char* etag) {
+  /**
+   * @brief Entity tag of the outputs built from a poll generation
+   * @param gzip tag of the gzip compressed body, it is a different entity
+   * @param etag buffer of RESPONSE_ETAG_SIZE bytes
+   */
+  snprintf_P(etag, RESPONSE_ETAG_SIZE, PSTR("\"%08x-%x%s\""),
+             (unsigned)_BootId, (unsigned)generation, gzip ? "-gz" : "");
+}
+
+const char* ResponseCache::Get(eCachedResponse_t type, uint8_t inverter,
+                               uint32_t generation, size_t& size) {
+  /**
+   * @brief Look up the body of an output
+   * @param inverter index of the inverter, 0 for outputs of all inverters
+   * @param generation generation the body has to be built from
+   * @param size set to the size of the body
+   * @returns the body, NULL if it is not cached
+   */
+  const sCacheEntry_t& entry = _Entries[type][inverter];
+  if (entry.body == NULL || entry.generation != generation) return NULL;
+  size = entry.size;
+  return entry.body;
+}
+
+char* ResponseCache::Reserve(eCachedResponse_t type, uint8_t inverter,
+                             uint32_t generation, size_t size) {
+  /**
+   * @brief Allocate the body of an output, the previous one is dropped.
+   * The other bodies are dropped if there is no room for it.
+   * @param size size of the body
+   * @returns buffer to write the body to, NULL if it does not fit
+   */
+  Drop(type, inverter);
+  if (size == 0 || size > RESPONSE_CACHE_SIZE) return NULL;
+  for (uint8_t t = 0; t < CachedCount && _Used + size > RESPONSE_CACHE_SIZE;
+       t++) {
+    for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+      Drop((eCachedResponse_t)t, i);
+    }
+  }
+  if (_Used + size > RESPONSE_CACHE_SIZE ||
+      maxAllocation() < size + RESPONSE_CACHE_HEAP_RESERVE) {
+    return NULL;
+  }
+  char* body = new (std::nothrow) char[size];
+  if (body == NULL) return NULL;
+  _Entries[type][inverter] = {body, size, generation};
+  _Used += size;
+  return body;
+}
+
+void ResponseCache::Drop(eCachedResponse_t type, uint8_t inverter) {
+  sCacheEntry_t& entry = _Entries[type][inverter];
+  if (entry.body == NULL) return;
+  delete[] entry.body;
+  _Used -= entry.size;
+  entry = {NULL, 0, 0};
+}
+
+bool ResponseCache::CanAllocate(size_t size) {
+  /**
+   * @brief Check if a body that is not cached may be built in memory
+   * @param size size of the body
+   * @returns true if RESPONSE_CACHE_HEAP_RESERVE bytes are left after it
+   */
+  return maxAllocation() >= size + RESPONSE_CACHE_HEAP_RESERVE;
+}
+
+uint32_t ResponseCache::maxAllocation() {
+#ifdef ESP32
+  return ESP.getMaxAllocHeap();
+#else
+  return ESP.getMaxFreeBlockSize();
+#endif
+}
+
+BufferPrint::BufferPrint(char* buffer, size_t size)
+    : _Buffer(buffer), _Size(size), _Length(0) {}
+
+size_t BufferPrint::write(uint8_t c) { return write(&c, 1); }
+
+size_t BufferPrint::write(const uint8_t* buffer, size_t size) {
+  if (_Length < _Size) {
+    memcpy(_Buffer + _Length, buffer, min(size, _Size - _Length));
+  }
+  _Length += size;
+  return size;
+}
+
+size_t BufferPrint::GetLength() { return _Length; }
+
+bool BufferPrint::IsOverflowed() { return _Length > _Size; }
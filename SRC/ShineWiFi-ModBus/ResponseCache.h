@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Arduino.h"
+#include "Config.h"
+
+#ifndef RESPONSE_CACHE_SIZE
+#define RESPONSE_CACHE_SIZE 12288
+#endif
+#ifndef RESPONSE_CACHE_HEAP_RESERVE
+#define RESPONSE_CACHE_HEAP_RESERVE 8192
+#endif
+#ifndef NUM_INVERTERS
+#define NUM_INVERTERS 1
+#endif
+
+// "<boot id>-<generation>[-gz]" in quotes
+#define RESPONSE_ETAG_SIZE 24
+
+// outputs that only change with a poll
+typedef enum {
+  CachedStatus,    // /status
+  CachedUI,        // /uiStatus
+  CachedUIMeta,    // /ui/meta, changes with the protocol only
+  CachedUIValues,  // /ui/values
+  CachedMetrics,   // /metrics, all inverters
+  CachedCount
+} eCachedResponse_t;
+
+// Keeps the last body of every output until the poll generation it was built
+// from changes. The bodies are allocated on a miss and bounded by
+// RESPONSE_CACHE_SIZE in total.
+class ResponseCache {
+ public:
+  ResponseCache();
+  void begin();
+  void FormatETag(uint32_t generation, bool gzip, char* etag);
+  const char* Get(eCachedResponse_t type, uint8_t inverter,
+                  uint32_t generation, size_t& size);
+  char* Reserve(eCachedResponse_t type, uint8_t inverter, uint32_t generation,
+                size_t size);
+  void Drop(eCachedResponse_t type, uint8_t inverter);
+  bool CanAllocate(size_t size);
+
+ private:
+  typedef struct {
+    char* body;
+    size_t size;
+    uint32_t generation;
+  } sCacheEntry_t;
+
+  sCacheEntry_t _Entries[CachedCount][NUM_INVERTERS];
+  size_t _Used;      // bytes of all bodies
+  uint32_t _BootId;  // keeps the ETags of a previous boot from matching
+
+  uint32_t maxAllocation();
+};
+
+// Writes into a fixed buffer, text beyond its end is counted but dropped
+class BufferPrint : public Print {
+ public:
+  BufferPrint(char* buffer, size_t size);
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  size_t GetLength();
+  bool IsOverflowed();
+
+ private:
+  char* _Buffer;
+  size_t _Size;
+  size_t _Length;
+};
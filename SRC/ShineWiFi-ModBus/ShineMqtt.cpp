@@ -3,6 +3,7 @@
 #if MQTT_SUPPORTED == 1
 #include <TLog.h>
 #include <StreamUtils.h>
+#include <vector>
 #include "PubSubClient.h"
 
 ShineMqtt::ShineMqtt(WiFiClient& wc, Growatt& inverter)
@@ -118,16 +119,53 @@ boolean ShineMqtt::mqttPublish(JsonDocument& doc, String topic) {
   }
 
   if (this->mqttclient.connected()) {
-    bool res =
-        this->mqttclient.beginPublish(topic.c_str(), measureJson(doc), true);
+    if (!this->mqttclient.beginPublish(topic.c_str(), measureJson(doc),
+                                       true)) {
+      Log.println(F("failed"));
+      return false;
+    }
     BufferingPrint bufferedClient(this->mqttclient, BUFFER_SIZE);
     serializeJson(doc, this->mqttclient);
     bufferedClient.flush();
     this->mqttclient.endPublish();
 
-    Log.println(res ? "succeed" : "failed");
+    Log.println(F("succeed"));
 
-    return res;
+    return true;
+  } else {
+    Log.println(F("not connected"));
+
+    return false;
+  }
+}
+
+boolean ShineMqtt::mqttPublish(size_t length, std::function<void(Print&)> write,
+                               String topic) {
+  /**
+   * @brief Publish a message that is written straight into the client
+   * @param length size of the message, write() has to produce exactly that
+   * @param write writes the message
+   */
+  Log.print(F("publish MQTT message... "));
+
+  if (topic.isEmpty()) {
+    topic = this->mqttconfig.topic;
+  }
+
+  if (this->mqttclient.connected()) {
+    // without the packet header the payload would corrupt the stream
+    if (!this->mqttclient.beginPublish(topic.c_str(), length, true)) {
+      Log.println(F("failed"));
+      return false;
+    }
+    BufferingPrint bufferedClient(this->mqttclient, BUFFER_SIZE);
+    write(bufferedClient);
+    bufferedClient.flush();
+    this->mqttclient.endPublish();
+
+    Log.println(F("succeed"));
+
+    return true;
   } else {
     Log.println(F("not connected"));
 
@@ -136,8 +174,6 @@ boolean ShineMqtt::mqttPublish(JsonDocument& doc, String topic) {
 }
 
 void ShineMqtt::onMqttMessage(char* topic, byte* payload, unsigned int length) {
-  StaticJsonDocument<1024> req;
-  StaticJsonDocument<1024> res;
   String strTopic(topic);
 
   Log.print(F("MQTT message arrived ["));
@@ -150,8 +186,29 @@ void ShineMqtt::onMqttMessage(char* topic, byte* payload, unsigned int length) {
     return;
   }
 
-  this->inverter.HandleCommand(command, payload, length, req, res);
-  mqttPublish(res, this->mqttconfig.topic + "/result");
+  // commands are run by the bus arbiter ahead of the telemetry, the payload
+  // is only valid during this callback
+  std::vector<byte> data(payload, payload + length);
+  bool queued =
+      this->inverter.QueueBusJob(BusControl, [this, command, data]() {
+        // sized for the worst case of the payload and the protocol
+        DynamicJsonDocument req(
+            Growatt::GetCommandRequestCapacity(data.size()));
+        DynamicJsonDocument res(
+            this->inverter.GetCommandResultCapacity(command, data.size()));
+        this->inverter.HandleCommand(command, data.data(), data.size(), req,
+                                     res);
+        mqttPublish(res, this->mqttconfig.topic + "/result");
+      });
+  if (!queued) {
+    Log.println(F("Command queue full, rejected"));
+    DynamicJsonDocument res(
+        this->inverter.GetCommandResultCapacity(command, 0));
+    res["command"] = command;
+    res["success"] = false;
+    res["message"] = "Command queue full";
+    mqttPublish(res, this->mqttconfig.topic + "/result");
+  }
 }
 
 void ShineMqtt::loop() { this->mqttclient.loop(); }
@@ -15,6 +15,7 @@ typedef struct {
   String topic;
   String user;
   String pwd;
+  String groups;  // register groups to publish, empty for all
 } MqttConfig;
 
 class ShineMqtt {
@@ -24,6 +25,8 @@ class ShineMqtt {
   bool mqttReconnect();
   boolean mqttPublish(const String& JsonString);
   boolean mqttPublish(JsonDocument& doc, String topic = "");
+  boolean mqttPublish(size_t length, std::function<void(Print&)> write,
+                      String topic = "");
   boolean mqttEnabled();
   boolean mqttConnected();
   void onMqttMessage(char* topic, byte* payload, unsigned int length);
@@ -6,15 +6,34 @@
 #include "ShineWifi.h"
 #include <TLog.h>
 #include "Index.h"
+#if __has_include("WebAssets.h")
+// generated by Tools/web_assets.py
+#include "WebAssets.h"
+#endif
 #include "Growatt.h"
+#include "InverterPoller.h"
+#include "ResponseCache.h"
+#include "GzipPrint.h"
+#include "EventStream.h"
 #include <Preferences.h>
 #include <WiFiManager.h>
 #include <StreamUtils.h>
+#include <memory>
+#include <new>
 
 #ifdef ESP32
 #include <esp_task_wdt.h>
 #endif
 
+#if HTTP_SERVER_TASK == 1 && defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#define HTTP_TASK_STACK_SIZE 8192
+#define HTTP_TASK_PRIORITY 1
+#endif
+
 #if PINGER_SUPPORTED == 1
 #ifdef ESP8266
 #include <Pinger.h>
@@ -41,13 +60,37 @@ DoubleResetDetector* drd;
 #include <ArduinoOTA.h>
 #endif
 
+#if ENABLE_CAPTURE == 1
+#include "Capture.h"
+#endif
+
+#if ENABLE_REGISTER_MAP_FILE == 1
+#include <LittleFS.h>
+#include "RegisterMap.h"
+#define REGISTER_MAP_UPLOAD "/regmap.tmp"
+#endif
+
 #if defined(DEFAULT_NTP_SERVER) && defined(DEFAULT_TZ_INFO)
 #include <time.h>
 extern "C" uint8_t sntp_getreachability(uint8_t);
 #endif
 
+#if NUM_INVERTERS > 1 && !defined(ESP32)
+#error Several inverters are only supported on ESP32
+#endif
+#if NUM_INVERTERS > 3
+#error At most three inverters are supported
+#endif
+
+#define NUM_OF_RETRIES 5
+
 Preferences prefs;
-Growatt Inverter;
+Growatt Inverters[NUM_INVERTERS];
+// the first inverter, the only one on single inverter setups
+Growatt& Inverter = Inverters[0];
+InverterPoller Poller(Inverters, NUM_INVERTERS, NUM_OF_RETRIES);
+ResponseCache responseCache;
+EventStream events(Inverters, NUM_INVERTERS);
 bool StartedConfigAfterBoot = false;
 
 #if MQTT_SUPPORTED == 1
@@ -59,12 +102,19 @@ WiFiClient espClient;
 ShineMqtt shineMqtt(espClient, Inverter);
 #endif
 
+#if ENABLE_CAPTURE == 1
+Capture inverterCapture(Inverter);
+#endif
+
 #ifdef AP_BUTTON_PRESSED
 byte btnPressed = 0;
 #endif
 
-#define NUM_OF_RETRIES 5
-boolean readoutSucceeded = false;
+#if ENABLE_REGISTER_MAP_FILE == 1
+File registerMapUpload;
+#endif
+
+boolean readoutSucceeded[NUM_INVERTERS] = {false};
 
 uint16_t u16PacketCnt = 0;
 #if PINGER_SUPPORTED == 1
@@ -79,6 +129,14 @@ ESP8266WebServer httpServer(80);
 WebServer httpServer(80);
 #endif
 
+// loop() polls or reconnects the inverters, work handed to it has to wait
+volatile bool loopBusy = false;
+#if HTTP_SERVER_TASK == 1 && defined(ESP32)
+TaskHandle_t httpTask = NULL;
+QueueHandle_t loopWork;  // handlers waiting for loop(), see runInLoop()
+SemaphoreHandle_t loopWorkDone;
+#endif
+
 struct {
   WiFiManagerParameter* hostname = NULL;
   WiFiManagerParameter* static_ip = NULL;
@@ -91,8 +149,10 @@ struct {
   WiFiManagerParameter* mqtt_topic = NULL;
   WiFiManagerParameter* mqtt_user = NULL;
   WiFiManagerParameter* mqtt_pwd = NULL;
+  WiFiManagerParameter* mqtt_groups = NULL;
 #endif
   WiFiManagerParameter* syslog_ip = NULL;
+  WiFiManagerParameter* protocol = NULL;
 } customWMParams;
 
 static const struct {
@@ -107,9 +167,11 @@ static const struct {
   const char* mqtt_topic = "/mqttt";
   const char* mqtt_user = "/mqttu";
   const char* mqtt_pwd = "/mqttw";
+  const char* mqtt_groups = "/mqttg";
 #endif
   const char* syslog_ip = "/syslogip";
   const char* force_ap = "/forceap";
+  const char* protocol = "/protocol";
 } ConfigFiles;
 
 struct {
@@ -123,6 +185,7 @@ struct {
 #endif
   String syslog_ip;
   bool force_ap;
+  String protocol;
 } Config;
 
 #define CONFIG_PORTAL_MAX_TIME_SECONDS 300
@@ -132,11 +195,13 @@ struct {
 // -------------------------------------------------------
 void updateRedLed() {
   uint8_t state = 0;
-  if (!readoutSucceeded) {
-    state = 1;
-  }
-  if (Inverter.GetWiFiStickType() == Undef_stick) {
-    state = 1;
+  for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+    if (!readoutSucceeded[i]) {
+      state = 1;
+    }
+    if (Inverters[i].GetWiFiStickType() == Undef_stick) {
+      state = 1;
+    }
   }
 #if MQTT_SUPPORTED == 1
   if (shineMqtt.mqttEnabled() && !shineMqtt.mqttConnected()) {
@@ -180,16 +245,77 @@ void WiFi_Reconnect() {
 // read access (and we do several of them). The WiFi can crash during this
 // function. Perhaps we can fix this by using the callback function of the
 // ModBus-Lib
-void InverterReconnect(void) {
+void selectProtocol(uint8_t index);
+
+void InverterReconnect(uint8_t index) {
+  Growatt& inverter = Inverters[index];
   // Baudrate will be set here, depending on the version of the stick
-  Inverter.begin(Serial);
+  if (index == 0) {
+    inverter.begin(Serial);
+  }
+#if NUM_INVERTERS > 1
+  else if (index == 1) {
+    inverter.begin(Serial2, INVERTER2_RX_PIN, INVERTER2_TX_PIN);
+  }
+#endif
+#if NUM_INVERTERS > 2
+  else if (index == 2) {
+    inverter.begin(Serial1, INVERTER3_RX_PIN, INVERTER3_TX_PIN);
+  }
+#endif
 
-  if (Inverter.GetWiFiStickType() == ShineWiFi_S)
+#if NUM_INVERTERS > 1
+  Log.print(F("Inverter "));
+  Log.print(index + 1);
+  Log.print(F(": "));
+#endif
+  if (inverter.GetWiFiStickType() == ShineWiFi_S)
     Log.println(F("ShineWiFi-S (Serial) found"));
-  else if (Inverter.GetWiFiStickType() == ShineWiFi_X)
+  else if (inverter.GetWiFiStickType() == ShineWiFi_X)
     Log.println(F("ShineWiFi-X (USB) found"));
   else
     Log.println(F("Error: Unknown Shine Stick"));
+
+  if (inverter.GetProtocolVersion() == 0) {
+    selectProtocol(index);
+  }
+}
+
+// The modbus protocol is taken from the config portal, from an earlier
+// detection or from Config.h, in this order. Otherwise it is detected once and
+// remembered, so later boots skip the detection.
+void selectProtocol(uint8_t index) {
+  Growatt& inverter = Inverters[index];
+  char key[12];
+  snprintf(key, sizeof(key), "/protocol%d", index + 1);
+
+  uint16_t version = Config.protocol.toInt();
+  if (version == 0) {
+    version = prefs.getUShort(key, GROWATT_MODBUS_VERSION);
+  }
+  if (version == 0 && inverter.GetWiFiStickType() != Undef_stick) {
+    version = inverter.DetectProtocol();
+    if (version != 0) {
+      Log.print(F("Detected modbus protocol "));
+      Log.println(version);
+      prefs.putUShort(key, version);
+    }
+  }
+  if (version == 0) {
+    // no answer from the inverter, try again on the next reconnect
+    return;
+  }
+  if (!inverter.InitProtocol(version)) {
+    Log.print(F("Error: Unsupported modbus protocol "));
+    Log.println(version);
+    return;
+  }
+#if ENABLE_CAPTURE == 1
+  // the capture resolves its register names in the protocol tables
+  if (index == 0) {
+    inverterCapture.begin();
+  }
+#endif
 }
 
 void loadConfig();
@@ -209,9 +335,11 @@ void loadConfig() {
   Config.mqtt.topic = prefs.getString(ConfigFiles.mqtt_topic, "energy/solar");
   Config.mqtt.user = prefs.getString(ConfigFiles.mqtt_user, "");
   Config.mqtt.pwd = prefs.getString(ConfigFiles.mqtt_pwd, "");
+  Config.mqtt.groups = prefs.getString(ConfigFiles.mqtt_groups, "");
 #endif
   Config.syslog_ip = prefs.getString(ConfigFiles.syslog_ip, "");
   Config.force_ap = prefs.getBool(ConfigFiles.force_ap, false);
+  Config.protocol = prefs.getString(ConfigFiles.protocol, "");
 }
 
 void saveConfig() {
@@ -226,8 +354,10 @@ void saveConfig() {
   prefs.putString(ConfigFiles.mqtt_topic, Config.mqtt.topic);
   prefs.putString(ConfigFiles.mqtt_user, Config.mqtt.user);
   prefs.putString(ConfigFiles.mqtt_pwd, Config.mqtt.pwd);
+  prefs.putString(ConfigFiles.mqtt_groups, Config.mqtt.groups);
 #endif
   prefs.putString(ConfigFiles.syslog_ip, Config.syslog_ip);
+  prefs.putString(ConfigFiles.protocol, Config.protocol);
 }
 
 void saveParamCallback() {
@@ -247,8 +377,18 @@ void saveParamCallback() {
   Config.mqtt.topic = customWMParams.mqtt_topic->getValue();
   Config.mqtt.user = customWMParams.mqtt_user->getValue();
   Config.mqtt.pwd = customWMParams.mqtt_pwd->getValue();
+  Config.mqtt.groups = customWMParams.mqtt_groups->getValue();
 #endif
   Config.syslog_ip = customWMParams.syslog_ip->getValue();
+  if (Config.protocol != customWMParams.protocol->getValue()) {
+    // forget the detected protocols, an emptied field detects them again
+    char key[12];
+    for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+      snprintf(key, sizeof(key), "/protocol%d", i + 1);
+      prefs.remove(key);
+    }
+  }
+  Config.protocol = customWMParams.protocol->getValue();
 
   saveConfig();
 
@@ -460,22 +600,64 @@ void setup() {
 
   httpServer.on("/status", sendJsonSite);
   httpServer.on("/uiStatus", sendUiJsonSite);
+  httpServer.on("/ui/meta", sendUiMeta);
+  httpServer.on("/ui/values", sendUiValues);
   httpServer.on("/metrics", sendMetrics);
+  httpServer.on("/values", sendValues);
+  httpServer.on("/events", sendEvents);
   httpServer.on("/startAp", startConfigAccessPoint);
   httpServer.on("/reboot", rebootESP);
 #if ENABLE_MODBUS_COMMUNICATION == 1
   httpServer.on("/postCommunicationModbus", sendPostSite);
-  httpServer.on("/postCommunicationModbus_p", HTTP_POST, handlePostData);
+  httpServer.on("/postCommunicationModbus_p", HTTP_POST,
+                [] { runInLoop(handlePostData); });
 #endif
   httpServer.on("/", sendMainPage);
+#ifdef WEB_CHART_JS_PATH
+  httpServer.on(WEB_CHART_JS_PATH, sendChartJs);
+#endif
 #ifdef ENABLE_WEB_DEBUG
   httpServer.on("/debug", sendDebug);
+#endif
+#if ENABLE_CAPTURE == 1
+  // the capture is run by loop()
+  httpServer.on("/capture", [] { runInLoop(sendCaptureStatus); });
+  httpServer.on("/capture/trigger", [] { runInLoop(handleCaptureTrigger); });
+  httpServer.on("/capture/arm", [] { runInLoop(handleCaptureArm); });
+  httpServer.on("/capture.csv", [] { runInLoop(sendCaptureCsv); });
+  httpServer.on("/capture.bin", [] { runInLoop(sendCaptureBinary); });
+#endif
+#if ENABLE_REGISTER_MAP_FILE == 1
+  httpServer.on("/regmap", HTTP_POST, handleRegisterMap,
+                handleRegisterMapUpload);
+  httpServer.on("/regmap/remove", handleRegisterMapRemove);
 #endif
   httpServer.onNotFound(handleNotFound);
 
-  Inverter.InitProtocol();
-  InverterReconnect();
+#if ENABLE_REGISTER_MAP_FILE == 1
+#ifdef ESP32
+  // the ESP8266 core formats a filesystem that can not be mounted by itself
+  const bool fsMounted = LittleFS.begin(true);
+#else
+  const bool fsMounted = LittleFS.begin();
+#endif
+  if (!fsMounted) {
+    Log.println(F("Error: LittleFS not available, no register maps"));
+  }
+#endif
+
+  for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+    Inverters[i].SetInverterId(i + 1);
+    InverterReconnect(i);
+  }
+  Poller.begin();
+  responseCache.begin();
+  const char* headers[] = {"If-None-Match", "Accept-Encoding"};
+  httpServer.collectHeaders(headers, 2);
   httpServer.begin();
+#if HTTP_SERVER_TASK == 1 && defined(ESP32)
+  startHttpServerTask();
+#endif
 
 #if defined(DEFAULT_NTP_SERVER) && defined(DEFAULT_TZ_INFO)
 #ifdef ESP32
@@ -510,10 +692,16 @@ void setupWifiManagerConfigMenu(WiFiManager& wm) {
       "mqttusername", "username", Config.mqtt.user.c_str(), 40);
   customWMParams.mqtt_pwd = new WiFiManagerParameter(
       "mqttpassword", "password", Config.mqtt.pwd.c_str(), 64);
+  customWMParams.mqtt_groups = new WiFiManagerParameter(
+      "mqttgroups", "groups, e.g. pv,energy (leave blank for all values)",
+      Config.mqtt.groups.c_str(), 64);
 #endif
   customWMParams.syslog_ip = new WiFiManagerParameter(
       "syslogip", "syslog server IP (leave blank for none)",
       Config.syslog_ip.c_str(), 15);
+  customWMParams.protocol = new WiFiManagerParameter(
+      "protocol", "modbus protocol, e.g. 124 or 3000 (leave blank to detect)",
+      Config.protocol.c_str(), 4);
   wm.addParameter(customWMParams.hostname);
 #if MQTT_SUPPORTED == 1
   wm.addParameter(new WiFiManagerParameter(
@@ -523,6 +711,7 @@ void setupWifiManagerConfigMenu(WiFiManager& wm) {
   wm.addParameter(customWMParams.mqtt_topic);
   wm.addParameter(customWMParams.mqtt_user);
   wm.addParameter(customWMParams.mqtt_pwd);
+  wm.addParameter(customWMParams.mqtt_groups);
 #endif
   wm.addParameter(new WiFiManagerParameter(
       "<p><b>Static IP</b> (leave blank for DHCP)</p>"));
@@ -532,6 +721,7 @@ void setupWifiManagerConfigMenu(WiFiManager& wm) {
   wm.addParameter(customWMParams.static_dns);
   wm.addParameter(new WiFiManagerParameter("<p><b>Advanced Settings</b></p>"));
   wm.addParameter(customWMParams.syslog_ip);
+  wm.addParameter(customWMParams.protocol);
 
   wm.setSaveParamsCallback(saveParamCallback);
 
@@ -556,6 +746,77 @@ void setupMenu(WiFiManager& wm, bool enableCustomParams) {
   wm.setMenu(menu);  // custom menu, pass vector
 }
 
+#if HTTP_SERVER_TASK == 1 && defined(ESP32)
+// Serves the web server independent of loop(), the outputs are built from
+// the snapshots the polls publish (see Growatt::PublishValues()), a request
+// does not wait for the modbus
+void httpServerTask(void*) {
+  for (;;) {
+    httpServer.handleClient();
+    events.loop();
+    // handleClient() returns at once without a request
+    vTaskDelay(1);
+  }
+}
+
+void startHttpServerTask() {
+  loopWork = xQueueCreate(1, sizeof(std::function<void()>*));
+  loopWorkDone = xSemaphoreCreateBinary();
+  xTaskCreate(httpServerTask, "http", HTTP_TASK_STACK_SIZE, NULL,
+              HTTP_TASK_PRIORITY, &httpTask);
+}
+#endif
+
+// Runs a handler that uses the modbus or state of loop() in loop(), the
+// server task waits for it meanwhile. It is answered with 503 while loop()
+// is busy with the inverters. Without the server task it runs at once.
+void runInLoop(std::function<void()> work) {
+#if HTTP_SERVER_TASK == 1 && defined(ESP32)
+  if (xTaskGetCurrentTaskHandle() == httpTask) {
+    if (loopBusy) {
+      httpServer.sendHeader(F("Retry-After"), F("5"));
+      httpServer.send(503, F("text/plain"), F("Busy, try again later"));
+      return;
+    }
+    std::function<void()>* item = &work;
+    xQueueSend(loopWork, &item, portMAX_DELAY);
+    xSemaphoreTake(loopWorkDone, portMAX_DELAY);
+    return;
+  }
+#endif
+  work();
+}
+
+// Serves the web server in loop(), with the server task only the handlers
+// it hands over
+void serviceHttp() {
+#if HTTP_SERVER_TASK == 1 && defined(ESP32)
+  std::function<void()>* work;
+  if (xQueueReceive(loopWork, &work, 0) == pdTRUE) {
+    (*work)();
+    xSemaphoreGive(loopWorkDone);
+  }
+#else
+  httpServer.handleClient();
+  events.loop();
+#endif
+}
+
+// every write is sent as one chunk of a chunked response
+class HttpChunkPrint : public Print {
+ public:
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    httpServer.sendContent((const char*)buffer, size);
+    _Length += size;
+    return size;
+  }
+  size_t GetLength() { return _Length; }
+
+ private:
+  size_t _Length = 0;
+};
+
 void sendJson(JsonDocument& doc) {
   httpServer.setContentLength(measureJson(doc));
   httpServer.send(200, "application/json", "");
@@ -564,54 +825,348 @@ void sendJson(JsonDocument& doc) {
   serializeJson(doc, bufferedWifiClient);
 }
 
+#if GZIP_RESPONSES == 1 && defined(ESP32)
+// whether the client takes gzip and the last body of the output was large
+// enough to be worth it
+bool wantsGzip(size_t lastSize) {
+  return lastSize >= GZIP_MIN_SIZE &&
+         httpServer.header(F("Accept-Encoding")).indexOf(F("gzip")) >= 0;
+}
+#endif
+
+// Sends an output that only changes with the poll generation: a bodyless 304
+// if the client already has it, else the cached body or the one write()
+// produces, which is cached if it fits and cacheable is set. Outputs
+// restricted by query arguments are not, the cache keeps one body per
+// output. Any other body is built in memory if there is room, else it is
+// streamed, with a Content-Length if write() produces the same text every
+// time. With GZIP_RESPONSES the body is compressed while it is sent. The
+// snapshots are released before a body from memory is sent, a slow client
+// does not hold up the next poll.
+void sendGenerated(eCachedResponse_t type, uint8_t index, uint32_t generation,
+                   const char* contentType, std::function<void(Print&)> write,
+                   bool sameLength, bool cacheable, SnapshotLock& lock) {
+  HttpChunkPrint chunks;
+  std::unique_ptr<GzipPrint> gzip;
+  char etag[RESPONSE_ETAG_SIZE];
+#if GZIP_RESPONSES == 1 && defined(ESP32)
+  // the size of a body is only known once it is built, the one of the
+  // previous response decides
+  static size_t lastSize[CachedCount] = {0};
+  const bool compress = wantsGzip(lastSize[type]);
+  httpServer.sendHeader(F("Vary"), F("Accept-Encoding"));
+#else
+  const bool compress = false;
+#endif
+  responseCache.FormatETag(generation, compress, etag);
+  httpServer.sendHeader(F("Cache-Control"), F("no-cache"));
+  if (httpServer.header(F("If-None-Match")) == etag) {
+    httpServer.sendHeader(F("ETag"), etag);
+    httpServer.send(304, "text/plain", "");
+    return;
+  }
+#if GZIP_RESPONSES == 1 && defined(ESP32)
+  if (compress && ESP.getMaxAllocHeap() >=
+                      sizeof(GzipPrint) + RESPONSE_CACHE_HEAP_RESERVE) {
+    gzip.reset(new (std::nothrow) GzipPrint(chunks));
+  }
+  if (compress && !gzip) {
+    // no room for the compressor, sent as is
+    responseCache.FormatETag(generation, false, etag);
+  }
+#endif
+  httpServer.sendHeader(F("ETag"), etag);
+
+  size_t size = 0;
+  const char* body =
+      cacheable ? responseCache.Get(type, index, generation, size) : NULL;
+  std::unique_ptr<char[]> scratch;
+  if (body == NULL) {
+    LengthPrint length;
+    write(length);
+    size = length.GetLength();
+    char* buffer = cacheable
+                       ? responseCache.Reserve(type, index, generation, size)
+                       : NULL;
+    if (buffer == NULL && responseCache.CanAllocate(size)) {
+      scratch.reset(new (std::nothrow) char[size]);
+      buffer = scratch.get();
+    }
+    if (buffer != NULL) {
+      BufferPrint out(buffer, size);
+      write(out);
+      if (out.GetLength() == size) {
+        body = buffer;
+      } else if (!scratch) {
+        // the values of the stick changed in between
+        responseCache.Drop(type, index);
+      }
+    }
+  }
+  if (body != NULL) lock.Unlock();
+
+  if (gzip) {
+    // unknown compressed size, chunks of GZIP_OUT_BUFFER_SIZE bytes
+    const uint32_t start = micros();
+    httpServer.sendHeader(F("Content-Encoding"), F("gzip"));
+    httpServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    httpServer.send(200, contentType, "");
+    if (body != NULL) {
+      gzip->write((const uint8_t*)body, size);
+    } else {
+      write(*gzip);
+    }
+    gzip->Finish();
+    httpServer.sendContent("");
+    const eGrowattOutput_t outputs[CachedCount] = {
+        OutputStatus, OutputUI, OutputUIMeta, OutputUIValues, OutputMetrics};
+    Inverters[index].RecordGzip(outputs[type], gzip->GetInputSize(),
+                                gzip->GetOutputSize(), micros() - start);
+    size = gzip->GetInputSize();
+  } else if (body != NULL) {
+    httpServer.setContentLength(size);
+    httpServer.send(200, contentType, "");
+    WiFiClient client = httpServer.client();
+    for (size_t i = 0; i < size; i += TCP_MSS) {
+      client.write((const uint8_t*)body + i, min((size_t)TCP_MSS, size - i));
+    }
+  } else if (sameLength) {
+    httpServer.setContentLength(size);
+    httpServer.send(200, contentType, "");
+    WiFiClient client = httpServer.client();
+    WriteBufferingStream bufferedWifiClient{client, BUFFER_SIZE};
+    write(bufferedWifiClient);
+  } else {
+    // streamed in TCP_MSS sized chunks, the memory use does not depend on
+    // the number of registers
+    httpServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    httpServer.send(200, contentType, "");
+    BufferingPrint out(chunks, TCP_MSS);
+    write(out);
+    out.flush();
+    // empty last chunk
+    httpServer.sendContent("");
+    size = chunks.GetLength();
+  }
+#if GZIP_RESPONSES == 1 && defined(ESP32)
+  lastSize[type] = size;
+#endif
+}
+
+// Get the inverter selected with the optional "inverter" argument (1 based),
+// sends an error and returns -1 if there is no such inverter
+int8_t selectInverter(void) {
+  if (!httpServer.hasArg(F("inverter"))) {
+    return 0;
+  }
+  long id = httpServer.arg(F("inverter")).toInt();
+  if (id < 1 || id > NUM_INVERTERS) {
+    httpServer.send(404, F("text/plain"), F("Unknown inverter"));
+    return -1;
+  }
+  return id - 1;
+}
+
+// Restrict an output of an inverter to register groups and names, sends an
+// error and returns false if one of them does not exist
+bool selectRegisters(uint8_t index, const String& groups, const String& names,
+                     RegisterSelection& selection) {
+  String unknown;
+  if (Inverters[index].Select(selection, groups, names, unknown)) {
+    return true;
+  }
+  httpServer.send(400, F("text/plain"),
+                  "Unknown group or register: " + unknown);
+  return false;
+}
+
 void sendJsonSite(void) {
-  if (!readoutSucceeded) {
+  int8_t index = selectInverter();
+  if (index < 0) return;
+  // no poll publishes its values while the response is built
+  SnapshotLock lock(&Inverters[index]);
+  // the last values are served after a failed poll until they are too old
+  if (!Inverters[index].HasValidValues()) {
     httpServer.send(503, F("text/plain"), F("Service Unavailable"));
     return;
   }
 
-  DynamicJsonDocument doc(JSON_DOCUMENT_SIZE);
-  Inverter.CreateJson(doc, WiFi.macAddress(), Config.hostname);
+  // ?group=pv,grid and ?fields=<register>,... restrict the values
+  RegisterSelection selection;
+  if (!selectRegisters(index, httpServer.arg(F("group")),
+                       httpServer.arg(F("fields")), selection)) {
+    return;
+  }
 
-  sendJson(doc);
+  // every pass writes the same sample, to measure and to send it
+  const String mac = WiFi.macAddress();
+  bool sampled = false;
+  sGrowattSystemSample_t sample;
+  auto write = [&](Print& out) {
+    if (!sampled) Growatt::SampleSystem(sample);
+    sampled = true;
+    Inverters[index].WriteJson(out, mac, Config.hostname, sample, &selection);
+  };
+  sendGenerated(CachedStatus, index, Inverters[index].GetGeneration(),
+                "application/json", write, true, selection.IsAll(), lock);
+}
+
+// /values?names=<register>,... the values of some registers in one request
+void sendValues(void) {
+  int8_t index = selectInverter();
+  if (index < 0) return;
+  SnapshotLock lock(&Inverters[index]);
+  if (httpServer.arg(F("names")).isEmpty()) {
+    httpServer.send(400, F("text/plain"), F("Missing argument: names"));
+    return;
+  }
+  if (!Inverters[index].HasValidValues()) {
+    httpServer.send(503, F("text/plain"), F("Service Unavailable"));
+    return;
+  }
+  RegisterSelection selection;
+  if (!selectRegisters(index, "", httpServer.arg(F("names")), selection)) {
+    return;
+  }
+
+  const String mac = WiFi.macAddress();
+  bool sampled = false;
+  sGrowattSystemSample_t sample;
+  auto write = [&](Print& out) {
+    if (!sampled) Growatt::SampleSystem(sample);
+    sampled = true;
+    Inverters[index].WriteJson(out, mac, "", sample, &selection);
+  };
+  sendGenerated(CachedStatus, index, Inverters[index].GetGeneration(),
+                "application/json", write, true, false, lock);
 }
 
 void sendUiJsonSite(void) {
-  DynamicJsonDocument doc(JSON_DOCUMENT_SIZE);
-  Inverter.CreateUIJson(doc, Config.hostname);
+  int8_t index = selectInverter();
+  if (index < 0) return;
+  SnapshotLock lock(&Inverters[index]);
+  // only built if it is not cached
+  JsonDocument* doc = NULL;
+  auto write = [&](Print& out) {
+    if (doc == NULL) {
+      doc = &Inverters[index].GetJsonDocument(JsonUI);
+      Inverters[index].CreateUIJson(*doc, Config.hostname);
+    }
+    serializeJson(*doc, out);
+  };
+  sendGenerated(CachedUI, index, Inverters[index].GetGeneration(),
+                "application/json", write, true, true, lock);
+}
 
-  sendJson(doc);
+// /ui/meta describes the fields of /ui/values, it is tagged with the
+// protocol instead of the poll generation
+void sendUiMeta(void) {
+  int8_t index = selectInverter();
+  if (index < 0) return;
+  SnapshotLock lock(&Inverters[index]);
+  auto write = [&](Print& out) {
+    Inverters[index].WriteUIMeta(out, Config.hostname);
+  };
+  sendGenerated(CachedUIMeta, index, Inverters[index].GetProtocolVersion(),
+                "application/json", write, true, true, lock);
+}
+
+void sendUiValues(void) {
+  int8_t index = selectInverter();
+  if (index < 0) return;
+  SnapshotLock lock(&Inverters[index]);
+  auto write = [&](Print& out) { Inverters[index].WriteUIValues(out); };
+  sendGenerated(CachedUIValues, index, Inverters[index].GetGeneration(),
+                "application/json", write, true, true, lock);
+}
+
+// /events pushes the values of the UI after every poll, see EventStream
+void sendEvents(void) {
+  int8_t index = selectInverter();
+  if (index < 0) return;
+  WiFiClient client = httpServer.client();
+  if (!events.Add(client, index)) {
+    httpServer.send(503, F("text/plain"), F("Too many event clients"));
+  }
 }
 
 void sendMetrics(void) {
-  if (!readoutSucceeded) {
+  SnapshotLock lock(Inverters, NUM_INVERTERS);
+  boolean anyValid = false;
+  for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+    anyValid = anyValid || Inverters[i].HasValidValues();
+  }
+  if (!anyValid) {
     httpServer.send(503, F("text/plain"), F("Service Unavailable"));
     return;
   }
-  static unsigned maxMetricsSize = 0;
-  String metrics;
-  if (maxMetricsSize) {
-    metrics.reserve(maxMetricsSize);
-  }
 
-  Inverter.CreateMetrics(metrics, WiFi.macAddress(), Config.hostname);
+  // ?group=pv,grid restricts the metrics, the slots of the registers
+  // differ between the protocols of the inverters
+  RegisterSelection selections[NUM_INVERTERS];
+  for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+    if (!selectRegisters(i, httpServer.arg(F("group")), "", selections[i])) {
+      return;
+    }
+  }
 
-  httpServer.setContentLength(metrics.length());
-  httpServer.send(200, "text/plain", "");
-  WiFiClient client = httpServer.client();
-  for (uint16_t i = 0; i < metrics.length(); i += TCP_MSS) {
-    int len = min(TCP_MSS, (int)metrics.length() - i);
-    client.write(metrics.c_str() + i, len);
+  // the generations of all inverters only grow, so does their sum
+  uint32_t generation = 0;
+  for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+    generation += Inverters[i].GetGeneration();
   }
-  maxMetricsSize = max(maxMetricsSize, metrics.length());
+  const String mac = WiFi.macAddress();
+  auto write = [&](Print& metrics) {
+    // inverters without valid data are left out
+    for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+      if (Inverters[i].HasValidValues()) {
+        Inverters[i].CreateMetrics(metrics, mac, Config.hostname,
+                                   &selections[i]);
+      }
+    }
+  };
+  // the uptime and heap of the stick may change between two passes
+  sendGenerated(CachedMetrics, 0, generation, "text/plain", write, false,
+                selections[0].IsAll(), lock);
 }
 
 #if MQTT_SUPPORTED == 1
-boolean sendMqttJson(void) {
-  DynamicJsonDocument doc(JSON_DOCUMENT_SIZE);
-
-  Inverter.CreateJson(doc, WiFi.macAddress(), "");
-  return shineMqtt.mqttPublish(doc);
+boolean sendMqttJson(uint8_t index) {
+  Growatt& inverter = Inverters[index];
+  const String mac = WiFi.macAddress();
+  sGrowattSystemSample_t sample;
+  Growatt::SampleSystem(sample);
+  // unknown groups of the portal setting are left out, without a known
+  // one all registers are published
+  String unknown;
+  const uint8_t groups = Growatt::ParseGroups(Config.mqtt.groups, unknown);
+  if (!unknown.isEmpty()) {
+    static bool logged = false;
+    if (!logged) {
+      Log.print(F("MQTT register groups \""));
+      Log.print(Config.mqtt.groups);
+      Log.print(F("\": unknown group "));
+      Log.println(unknown);
+      logged = true;
+    }
+  }
+  RegisterSelection selection;
+  if (groups != 0) {
+    inverter.Select(selection, Config.mqtt.groups, "", unknown);
+  }
+  LengthPrint length;
+  inverter.WriteJson(length, mac, "", sample, &selection);
+  auto write = [&](Print& out) {
+    inverter.WriteJson(out, mac, "", sample, &selection);
+  };
+#if NUM_INVERTERS > 1
+  // every inverter publishes to its own sub topic
+  return shineMqtt.mqttPublish(
+      length.GetLength(), write,
+      Config.mqtt.topic + "/inverter" + String(index + 1));
+#else
+  return shineMqtt.mqttPublish(length.GetLength(), write);
+#endif
 }
 #endif
 
@@ -646,7 +1201,114 @@ void sendDebug(void) {
 }
 #endif
 
+#if ENABLE_CAPTURE == 1
+void sendCaptureStatus(void) {
+  DynamicJsonDocument doc(1024);
+  inverterCapture.CreateJson(doc);
+
+  sendJson(doc);
+}
+
+void handleCaptureTrigger(void) {
+  inverterCapture.Trigger(F("http"));
+  sendCaptureStatus();
+}
+
+void handleCaptureArm(void) {
+  inverterCapture.Arm();
+  sendCaptureStatus();
+}
+
+void sendCaptureCsv(void) {
+  httpServer.setContentLength(inverterCapture.GetCsvSize());
+  httpServer.send(200, "text/csv", "");
+  WiFiClient client = httpServer.client();
+  WriteBufferingStream bufferedWifiClient{client, BUFFER_SIZE};
+  inverterCapture.WriteCsv(bufferedWifiClient);
+}
+
+void sendCaptureBinary(void) {
+  httpServer.setContentLength(inverterCapture.GetBinarySize());
+  httpServer.send(200, "application/octet-stream", "");
+  WiFiClient client = httpServer.client();
+  WriteBufferingStream bufferedWifiClient{client, BUFFER_SIZE};
+  inverterCapture.WriteBinary(bufferedWifiClient);
+}
+#endif
+
+#if ENABLE_REGISTER_MAP_FILE == 1
+void handleRegisterMapUpload(void) {
+  HTTPUpload& upload = httpServer.upload();
+  if (upload.status == UPLOAD_FILE_START) {
+    registerMapUpload = LittleFS.open(REGISTER_MAP_UPLOAD, "w");
+  } else if (upload.status == UPLOAD_FILE_WRITE) {
+    if (registerMapUpload) {
+      registerMapUpload.write(upload.buf, upload.currentSize);
+    }
+  } else if (registerMapUpload) {
+    registerMapUpload.close();
+  }
+}
+
+void handleRegisterMap(void) {
+  // check the upload with the loader used at boot, the map takes effect on
+  // the next boot
+  RegisterMap map;
+  sProtocolDefinition_t protocol;
+  if (!map.Load(REGISTER_MAP_UPLOAD, 0, protocol)) {
+    LittleFS.remove(REGISTER_MAP_UPLOAD);
+    httpServer.send(400, F("text/plain"), F("Invalid register map"));
+    return;
+  }
+  String path = RegisterMap::GetPath(map.GetVersion());
+  LittleFS.remove(path);
+  LittleFS.rename(REGISTER_MAP_UPLOAD, path);
+  httpServer.send(200, "text/plain", "Stored " + path + ", reboot to use it");
+}
+
+void handleRegisterMapRemove(void) {
+  String path = RegisterMap::GetPath(httpServer.arg("protocol").toInt());
+  if (!LittleFS.remove(path)) {
+    httpServer.send(404, F("text/plain"), F("No register map"));
+    return;
+  }
+  httpServer.send(200, "text/plain",
+                  "Removed " + path + ", reboot to use the built-in tables");
+}
+#endif
+
+#ifdef WEB_ASSETS
+// Sends a gzip compressed asset from flash, or a bodyless 304 if the client
+// has it already
+void sendAsset(const char* contentType, const uint8_t* data, size_t size,
+               PGM_P etag, const __FlashStringHelper* cacheControl) {
+  const String tag = FPSTR(etag);
+  httpServer.sendHeader(F("ETag"), tag);
+  httpServer.sendHeader(F("Cache-Control"), cacheControl);
+  if (httpServer.header(F("If-None-Match")) == tag) {
+    httpServer.send(304, contentType, "");
+    return;
+  }
+  httpServer.sendHeader(F("Content-Encoding"), F("gzip"));
+  httpServer.send_P(200, contentType, (PGM_P)data, size);
+}
+
+void sendMainPage(void) {
+  // revalidated on every load, it changes with the firmware
+  sendAsset("text/html", WEB_MAIN_PAGE, sizeof(WEB_MAIN_PAGE),
+            WEB_MAIN_PAGE_ETAG, F("no-cache"));
+}
+#else
 void sendMainPage(void) { httpServer.send(200, "text/html", MAIN_page); }
+#endif
+
+#ifdef WEB_CHART_JS_PATH
+void sendChartJs(void) {
+  // the path carries the version, it never changes
+  sendAsset("application/javascript", WEB_CHART_JS, sizeof(WEB_CHART_JS),
+            WEB_CHART_JS_ETAG, F("public, max-age=31536000, immutable"));
+}
+#endif
 
 void sendPostSite(void) {
   httpServer.send(200, "text/html", SendPostSite_page);
@@ -664,6 +1326,11 @@ void handlePostData() {
                                                  // send HTTP status 400
     return;
   } else {
+    // manual register access must not delay the telemetry
+    if (!Inverter.AcquireBus(BusDiagnostic)) {
+      httpServer.send(503, F("text/plain"), F("Bus busy, try again later"));
+      return;
+    }
     if (httpServer.arg(F("operation")) == "R") {
       if (httpServer.arg(F("registerType")) == "I") {
         if (httpServer.arg(F("type")) == "16b") {
@@ -742,23 +1409,30 @@ void handlePostData() {
                    PSTR("It is not possible to write into input registers"));
       }
     }
+    Inverter.ReleaseBus(BusDiagnostic);
     httpServer.send(200, F("text/plain"), msg);
     return;
   }
 }
 
 bool sendSingleValue(void) {
-  if (!readoutSucceeded) {
-    httpServer.send(503, F("text/plain"), F("Service Unavailable"));
-    return true;
-  }
+  int8_t index = selectInverter();
+  if (index < 0) return true;
+  SnapshotLock lock(&Inverters[index]);
   const String& key = httpServer.uri().substring(7);
-  double value;
-  if (Inverter.GetSingleValueByName(key, value)) {
-    httpServer.send(200, "text/plain", String(value));
+  bool holding;
+  uint16_t reg;
+  if (!Inverters[index].FindRegister(key, holding, reg)) return false;
+  // like /status and /metrics a value is not served once it is too old
+  if (!Inverters[index].IsValueValid(holding, reg, millis())) {
+    httpServer.send(503, F("text/plain"), F("Value expired"));
     return true;
   }
-  return false;
+  sGrowattModbusReg_t regDef = Inverters[index].GetRegister(holding, reg);
+  char value[SCALED_TEXT_SIZE];
+  Inverters[index].FormatRegValue(&regDef, value);
+  httpServer.send(200, "text/plain", value);
+  return true;
 }
 
 void handleNotFound() {
@@ -785,7 +1459,6 @@ void handleNTPSync() {
     Log.print(F(" reachable "));
     Log.println(reachable & 1);
     if (reachable & 1) {  // last SNTP request was successful
-      StaticJsonDocument<128> req, res;
       char buff[32];
       struct tm tm;
       time_t t = time(NULL);
@@ -793,9 +1466,23 @@ void handleNTPSync() {
       strftime(buff, sizeof(buff), "{\"value\":\"%Y-%m-%d %T\"}", &tm);
       Log.print(F("Trying to set inverter datetime: "));
       Log.println(buff);
-      Inverter.HandleCommand("datetime/set", (byte*)&buff, strlen(buff), req,
-                             res);
-      Log.println(res["message"].as<String>());
+      const String value(buff);
+      for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+        Growatt& inverter = Inverters[i];
+        bool queued = inverter.QueueBusJob(BusControl, [&inverter, value]() {
+          const String command = F("datetime/set");
+          DynamicJsonDocument req(
+              Growatt::GetCommandRequestCapacity(value.length()));
+          DynamicJsonDocument res(
+              inverter.GetCommandResultCapacity(command, value.length()));
+          inverter.HandleCommand(command, (const byte*)value.c_str(),
+                                 value.length(), req, res);
+          Log.println(res["message"].as<String>());
+        });
+        if (!queued) {
+          Log.println(F("Command queue full, datetime not set"));
+        }
+      }
     }
     lastNTPSync = now;
   }
@@ -807,7 +1494,6 @@ void handleNTPSync() {
 // -------------------------------------------------------
 unsigned long ButtonTimer = 0;
 unsigned long LEDTimer = 0;
-unsigned long RefreshTimer = 0;
 unsigned long WifiRetryTimer = 0;
 
 void loop() {
@@ -851,7 +1537,12 @@ void loop() {
   }
 #endif
 
-  httpServer.handleClient();
+  serviceHttp();
+
+  // run queued bus work (commands, time sync) in between the polls
+  for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+    Inverters[i].ServiceBus();
+  }
 
   // Toggle green LED with 1 Hz (alive)
   // ------------------------------------------------------------
@@ -867,48 +1558,53 @@ void loop() {
   // InverterReconnect() takes a long time --> wifi will crash
   // Do it only every two minutes
   if ((now - WifiRetryTimer) > WIFI_RETRY_TIMER) {
-    if (Inverter.GetWiFiStickType() == Undef_stick) InverterReconnect();
+    loopBusy = true;
+    for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+      if (Inverters[i].GetWiFiStickType() == Undef_stick ||
+          Inverters[i].GetProtocolVersion() == 0) {
+        InverterReconnect(i);
+      }
+    }
+    loopBusy = false;
     WifiRetryTimer = now;
   }
 
-  // Read Inverter every REFRESH_TIMER ms [defined in config.h]
+  // Read Inverter every REFRESH_TIMER ms [defined in config.h] at a fixed
+  // rate, or when the next fragment is due if cadence tuning is enabled
   // ------------------------------------------------------------
-  if ((now - RefreshTimer) > REFRESH_TIMER) {
-    if ((WiFi.status() == WL_CONNECTED) && (Inverter.GetWiFiStickType())) {
-      uint8_t u8RetryCounter = NUM_OF_RETRIES;
-      readoutSucceeded = false;
-      while ((u8RetryCounter) && !(readoutSucceeded)) {
-#if SIMULATE_INVERTER == 1
-        if (1)  // do it always
-#else
-        if (Inverter.ReadData())  // get new data from inverter
-#endif
-        {
-          Log.println(F("ReadData() successful"));
-          u16PacketCnt++;
-          u8RetryCounter = NUM_OF_RETRIES;
-          boolean mqttSuccess = false;
-
-#if MQTT_SUPPORTED == 1
-          if (shineMqtt.mqttEnabled()) {
-            mqttSuccess = sendMqttJson();
-          }
-#endif
-          handleWdtReset(mqttSuccess);
-
-          // leave while-loop
-          readoutSucceeded = true;
-        } else {
+  bool pollDue = false;
+  for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+    pollDue |= Inverters[i].PollDue(now);
+  }
+  if (pollDue) {
+    if (WiFi.status() == WL_CONNECTED) {
+      // all inverters are read at the same time, each one retries
+      // NUM_OF_RETRIES times
+      bool results[NUM_INVERTERS];
+      boolean anySucceeded = false;
+      boolean mqttSuccess = false;
+      loopBusy = true;
+      Poller.ReadAll(results);
+      loopBusy = false;
+
+      for (uint8_t i = 0; i < NUM_INVERTERS; i++) {
+        if (Inverters[i].GetWiFiStickType() == Undef_stick) continue;
+        readoutSucceeded[i] = results[i];
+        if (!results[i]) {
           Log.println(F("ReadData() NOT successful"));
-          if (u8RetryCounter) {
-            u8RetryCounter--;
-          } else {
-            Log.println(F("Retry counter"));
+          continue;
+        }
+        Log.println(F("ReadData() successful"));
+        u16PacketCnt++;
+        anySucceeded = true;
 #if MQTT_SUPPORTED == 1
-            shineMqtt.mqttPublish(String(F("{\"InverterStatus\": -1 }")));
-#endif
-          }
+        if (shineMqtt.mqttEnabled()) {
+          mqttSuccess = sendMqttJson(i) || mqttSuccess;
         }
+#endif
+      }
+      if (anySucceeded) {
+        handleWdtReset(mqttSuccess);
       }
     }
 
@@ -940,9 +1636,14 @@ void loop() {
     // set inverter datetime
     handleNTPSync();
 #endif
+  }
 
-    RefreshTimer = now;
+#if ENABLE_CAPTURE == 1
+  // poll the capture registers in between, at full rate after a trigger
+  if ((WiFi.status() == WL_CONNECTED) && (Inverter.GetWiFiStickType())) {
+    inverterCapture.loop(millis());
   }
+#endif
 
 #if OTA_SUPPORTED == 1
   // check for OTA updates
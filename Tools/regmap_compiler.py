@@ -0,0 +1,342 @@
+#!/usr/bin/env python3
+"""Compile a register map for the OpenInverterGateway firmware.
+
+The firmware loads /regmap<version>.bin from LittleFS (ENABLE_REGISTER_MAP_FILE)
+and uses it instead of the built-in tables of that protocol. The binary layout
+is described in SRC/ShineWiFi-ModBus/RegisterMap.h.
+
+Definitions are written as CSV or JSON:
+
+  CSV, one row per line, '#' starts a comment:
+    version,124
+    input_fragment,0,50
+    input,0,16bit,InverterStatus,1,1,NONE,1,0,status
+    holding_fragment,3,1
+    holding,3,16bit,PowerActiveRate,1,1,PERCENTAGE,1,0
+  register columns: address, size, name, multiplier, resolution, unit,
+  frontend, plot and optionally the value labels
+
+  JSON:
+    {"version": 124,
+     "input": {"fragments": [[0, 50]],
+               "registers": [{"address": 0, "size": "16bit",
+                              "name": "InverterStatus", "multiplier": 1,
+                              "resolution": 1, "unit": "NONE",
+                              "frontend": true, "plot": false,
+                              "labels": "status"}]},
+     "holding": {...}}
+
+Usage:
+  regmap_compiler.py growatt124.csv -o regmap124.bin
+  regmap_compiler.py --export SRC/ShineWiFi-ModBus/Growatt124.cpp \\
+      --version 124 -o growatt124.csv
+
+--export writes the built-in tables of a protocol file as CSV, which is the
+easiest start for a field fix.
+"""
+
+import argparse
+import csv
+import json
+import os
+import re
+import struct
+import sys
+
+MAGIC = b"GRM1"
+MAX_FRAGMENT_SIZE = 125
+INT16_MAX = 32767
+UINT16_MAX = 65535
+
+
+def firmware_define(name, default):
+    """Read a numeric #define of GrowattTypes.h, so the limits follow the
+    firmware. The default is used if the script is run outside the tree."""
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+                        "SRC", "ShineWiFi-ModBus", "GrowattTypes.h")
+    try:
+        with open(path) as f:
+            match = re.search(r"^#define %s (\d+)" % name, f.read(), re.M)
+    except OSError:
+        match = None
+    return int(match.group(1)) if match else default
+
+
+MAX_READ_FRAGMENTS = firmware_define("MAX_READ_FRAGMENTS", 10)
+
+# order of RegisterSize_t and RegisterUnit_t in GrowattTypes.h
+SIZES = ["16bit", "32bit", "16bit_s", "32bit_s", "8bit_l", "8bit_h"]
+UNITS = ["NONE", "POWER_W", "POWER_KWH", "VOLTAGE", "CURRENT", "SECONDS",
+         "PERCENTAGE", "FREQUENCY", "TEMPERATURE", "VA", "CURRENT_M",
+         "RESISTANCE_K", "POWER_REACTIVE"]
+# order of eGrowattLabels_t, the tables are part of the firmware
+LABELS = ["none", "status", "priority", "bdc_mode"]
+
+HEADER = struct.Struct("<4sHHHBBHHI")
+FRAGMENT = struct.Struct("<HB")
+REGISTER = struct.Struct("<HBBHBBff")
+FLAG_FRONTEND = 0x01
+FLAG_PLOT = 0x02
+
+
+class MapError(Exception):
+    pass
+
+
+def parse_bool(value):
+    return str(value).strip().lower() in ("1", "true", "yes")
+
+
+def make_register(address, size, name, multiplier, resolution, unit,
+                  frontend, plot, labels="none"):
+    size = str(size).strip().lower()
+    unit = str(unit).strip().upper()
+    labels = str(labels).strip().lower() or "none"
+    if size not in SIZES:
+        raise MapError("unknown size '%s' of %s" % (size, name))
+    if unit not in UNITS:
+        raise MapError("unknown unit '%s' of %s" % (unit, name))
+    if labels not in LABELS:
+        raise MapError("unknown labels '%s' of %s" % (labels, name))
+    return {"address": int(address), "size": size, "name": str(name).strip(),
+            "multiplier": float(multiplier),
+            "resolution": float(resolution), "unit": unit,
+            "frontend": parse_bool(frontend), "plot": parse_bool(plot),
+            "labels": labels}
+
+
+def read_csv(path):
+    result = {"version": None,
+              "input": {"fragments": [], "registers": []},
+              "holding": {"fragments": [], "registers": []}}
+    with open(path, newline="") as f:
+        for line, row in enumerate(csv.reader(f), 1):
+            if not row or row[0].strip().startswith("#"):
+                continue
+            kind = row[0].strip().lower()
+            try:
+                if kind == "version":
+                    result["version"] = int(row[1])
+                elif kind in ("input_fragment", "holding_fragment"):
+                    table = result[kind.split("_")[0]]
+                    table["fragments"].append((int(row[1]), int(row[2])))
+                elif kind in ("input", "holding"):
+                    result[kind]["registers"].append(
+                        make_register(*row[1:10]))
+                else:
+                    raise MapError("unknown row type '%s'" % kind)
+            except (IndexError, ValueError, TypeError) as e:
+                raise MapError("%s:%d: %s" % (path, line, e))
+    return result
+
+
+def read_json(path):
+    with open(path) as f:
+        data = json.load(f)
+    result = {"version": data.get("version")}
+    for table in ("input", "holding"):
+        src = data.get(table, {})
+        result[table] = {
+            "fragments": [tuple(x) for x in src.get("fragments", [])],
+            "registers": [make_register(r["address"], r["size"], r["name"],
+                                        r.get("multiplier", 1),
+                                        r.get("resolution", 1),
+                                        r.get("unit", "NONE"),
+                                        r.get("frontend", False),
+                                        r.get("plot", False),
+                                        r.get("labels", "none"))
+                          for r in src.get("registers", [])]}
+    return result
+
+
+def find_fragment(fragments, address):
+    for i, (start, size) in enumerate(fragments):
+        if start <= address < start + size:
+            return i
+    return -1
+
+
+def f32(value):
+    """Round to single precision, the firmware computes the scaling in
+    float."""
+    return struct.unpack("<f", struct.pack("<f", value))[0]
+
+
+def scale_exact(multiplier, resolution):
+    """Port of scaleExact() in GrowattTypes.h: the multiplier at the
+    resolution of the register has to be an integer or the reciprocal of
+    one that fits the fixed-point scaling."""
+    resolution = f32(resolution)
+    decimals = (0 if resolution >= f32(0.99) else
+                1 if resolution >= f32(0.099) else
+                2 if resolution >= f32(0.0099) else 3)
+    factor = f32(multiplier)
+    for _ in range(decimals):
+        factor = f32(factor * 10)
+    if not factor < INT16_MAX + 0.5:
+        scale = 0
+    elif factor >= f32(0.99):
+        scale = int(f32(factor + 0.5))
+    else:
+        scale = 1
+    if not factor > 0 or factor >= f32(0.99):
+        divisor = 1
+    elif not f32(1 / factor) < UINT16_MAX + 0.5:
+        divisor = 0
+    else:
+        divisor = int(f32(f32(1 / factor) + 0.5))
+    if scale <= 0 or divisor <= 0:
+        return False
+    value = f32(factor * divisor)
+    tolerance = f32(scale * f32(1e-4))
+    return f32(value - scale) <= tolerance and f32(scale - value) <= tolerance
+
+
+def validate(definition):
+    """Apply the same checks as CHECK_PROTOCOL_TABLE and the firmware."""
+    if not definition["version"]:
+        raise MapError("missing protocol version")
+    for name in ("input", "holding"):
+        table = definition[name]
+        fragments = table["fragments"]
+        if len(fragments) > MAX_READ_FRAGMENTS:
+            raise MapError("too many %s fragments" % name)
+        for start, size in fragments:
+            if not 0 < size <= MAX_FRAGMENT_SIZE:
+                raise MapError("%s fragment %d has size %d"
+                               % (name, start, size))
+        for i, a in enumerate(fragments):
+            for b in fragments[i + 1:]:
+                if a[0] < b[0] + b[1] and b[0] < a[0] + a[1]:
+                    raise MapError("%s fragments %d and %d overlap"
+                                   % (name, a[0], b[0]))
+        for reg in table["registers"]:
+            fragment = find_fragment(fragments, reg["address"])
+            if fragment < 0:
+                raise MapError("%s register %s (%d) is outside of all "
+                               "fragments" % (name, reg["name"],
+                                              reg["address"]))
+            if reg["size"] in ("32bit", "32bit_s") and \
+                    find_fragment(fragments, reg["address"] + 1) != fragment:
+                raise MapError("%s register %s is split across fragments"
+                               % (name, reg["name"]))
+            if not reg["resolution"] > 0 or \
+                    not scale_exact(reg["multiplier"], reg["resolution"]):
+                raise MapError("%s register %s has an invalid multiplier or "
+                               "resolution" % (name, reg["name"]))
+
+
+def compile_map(definition):
+    validate(definition)
+    names = bytearray()
+    offsets = {}
+    fragments = bytearray()
+    registers = bytearray()
+    for name in ("input", "holding"):
+        for start, size in definition[name]["fragments"]:
+            fragments += FRAGMENT.pack(start, size)
+    for name in ("input", "holding"):
+        for reg in definition[name]["registers"]:
+            # registers sharing a name share the string
+            if reg["name"] not in offsets:
+                offsets[reg["name"]] = len(names)
+                names += reg["name"].encode("ascii") + b"\0"
+            flags = (FLAG_FRONTEND if reg["frontend"] else 0) | \
+                (FLAG_PLOT if reg["plot"] else 0)
+            registers += REGISTER.pack(
+                reg["address"], SIZES.index(reg["size"]),
+                UNITS.index(reg["unit"]), offsets[reg["name"]], flags,
+                LABELS.index(reg["labels"]),
+                reg["multiplier"], reg["resolution"])
+    if len(names) > 0xffff:
+        raise MapError("name pool too large")
+    body = bytes(fragments + registers + names)
+    checksum = 2166136261
+    for b in body:
+        checksum = ((checksum ^ b) * 16777619) & 0xffffffff
+    header = HEADER.pack(MAGIC, definition["version"],
+                         len(definition["input"]["registers"]),
+                         len(definition["holding"]["registers"]),
+                         len(definition["input"]["fragments"]),
+                         len(definition["holding"]["fragments"]),
+                         len(names), 0, checksum)
+    return header + body
+
+
+def export_source(path, version):
+    """Extract the built-in tables of a Growatt<version>.cpp file."""
+    with open(path) as f:
+        source = f.read()
+    strings = dict(re.findall(
+        r'static const char (\w+)\[\] PROGMEM =\s*"([^"]*)";', source))
+    rows = [["version", version]]
+    for table in ("Input", "Holding"):
+        kind = table.lower()
+        match = re.search(r"\w+%sFragments\[\] PROGMEM = \{(.*?)\n\};"
+                          % table, source, re.S)
+        if match:
+            for start, size in re.findall(r"\{\s*(\d+),\s*(\d+)\s*\}",
+                                          match.group(1)):
+                rows.append([kind + "_fragment", start, size])
+        match = re.search(r"\w+%sRegisters\[\] PROGMEM = \{(.*?)\n\};"
+                          % table, source, re.S)
+        if not match:
+            continue
+        body = re.sub(r"//[^\n]*", "", match.group(1))
+        for entry in re.findall(r"\{([^{}]*)\}", body):
+            f = [x.strip() for x in entry.split(",")]
+            # build time multipliers (TEMPERATURE_WORKAROUND_MULTIPLIER) use
+            # their documented default
+            num = [x if re.match(r"^[-\d.eE]+$", x) else "0.1"
+                   for x in f[3:5]]
+            row = [kind, f[0], f[1][len("SIZE_"):].lower(), strings[f[2]],
+                   num[0], num[1], f[5], int(f[6] == "true"),
+                   int(f[7] == "true")]
+            if len(f) > 8:
+                row.append(f[8][len("&LABELS_"):].lower())
+            rows.append(row)
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compile a CSV/JSON register map into the binary format "
+                    "loaded by the firmware.")
+    parser.add_argument("input", nargs="?", help="CSV or JSON definition")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--export", metavar="SOURCE",
+                        help="write the tables of a protocol .cpp as CSV")
+    parser.add_argument("--version", type=int,
+                        help="protocol version, overrides the definition")
+    args = parser.parse_args()
+
+    try:
+        if args.export:
+            if not args.version:
+                raise MapError("--export needs --version")
+            with open(args.output, "w", newline="") as f:
+                csv.writer(f).writerows(export_source(args.export,
+                                                      args.version))
+            return 0
+        if not args.input:
+            parser.error("missing input definition")
+        if args.input.lower().endswith(".json"):
+            definition = read_json(args.input)
+        else:
+            definition = read_csv(args.input)
+        if args.version:
+            definition["version"] = args.version
+        data = compile_map(definition)
+    except (MapError, OSError, KeyError) as e:
+        print("error: %s" % e, file=sys.stderr)
+        return 1
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print("%s: %d input and %d holding registers, %d bytes"
+          % (args.output, len(definition["input"]["registers"]),
+             len(definition["holding"]["registers"]), len(data)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
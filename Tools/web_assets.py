@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Generate the gzip compressed web assets of the OpenInverterGateway firmware.
+
+The main page is taken from MAIN_page in SRC/ShineWiFi-ModBus/Index.h, its
+Chart.js <script> tag from cdnjs is pointed to a copy served by the stick.
+Chart.js is downloaded once, checked against the integrity hash of that tag
+and kept in .pio/web_assets. Both are written gzip compressed into
+SRC/ShineWiFi-ModBus/WebAssets.h, each with an ETag of its content hash.
+
+Without the download (e.g. offline) only the main page is bundled and it
+keeps loading Chart.js from cdnjs. Without WebAssets.h the firmware serves
+MAIN_page uncompressed.
+
+PlatformIO runs this script before every build (extra_scripts), it can also
+be run by hand for the Arduino IDE:
+  Tools/web_assets.py
+"""
+
+import base64
+import gzip
+import hashlib
+import os
+import re
+import sys
+import urllib.request
+
+SOURCE = os.path.join("SRC", "ShineWiFi-ModBus", "Index.h")
+OUTPUT = os.path.join("SRC", "ShineWiFi-ModBus", "WebAssets.h")
+CACHE = os.path.join(".pio", "web_assets")
+SCRIPT_TAG = re.compile(
+    r'<script src="(https://cdnjs\.cloudflare\.com/ajax/libs/Chart\.js/'
+    r'([\d.]+)/chart\.umd\.min\.js)" integrity="sha512-([^"]+)"[^>]*>'
+    r'</script>')
+
+
+def fetch_chart(root, url, version, integrity):
+    """Return Chart.js from the cache or cdnjs, None if not available."""
+    path = os.path.join(root, CACHE, "chart-%s.umd.min.js" % version)
+    data = None
+    if os.path.exists(path):
+        with open(path, "rb") as f:
+            data = f.read()
+    else:
+        try:
+            with urllib.request.urlopen(url, timeout=10) as response:
+                data = response.read()
+        except OSError as e:
+            print("web_assets: cannot download %s: %s" % (url, e))
+            return None
+    digest = base64.b64encode(hashlib.sha512(data).digest()).decode()
+    if digest != integrity:
+        print("web_assets: %s does not match its integrity hash" % url)
+        return None
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "wb") as f:
+        f.write(data)
+    return data
+
+
+def c_array(name, data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16])
+                     + ",")
+    return ("const uint8_t %s[] PROGMEM = {\n%s\n};\n"
+            % (name, "\n".join(lines)))
+
+
+def asset(name, data):
+    """Compress an asset, the ETag is the hash of its content."""
+    compressed = gzip.compress(data, 9, mtime=0)
+    etag = '"%s"' % hashlib.sha256(data).hexdigest()[:16]
+    return ('const char %s_ETAG[] PROGMEM = "%s";\n%s'
+            % (name, etag.replace('"', '\\"'), c_array(name, compressed)),
+            len(data), len(compressed))
+
+
+def generate(root):
+    with open(os.path.join(root, SOURCE)) as f:
+        source = f.read()
+    match = re.search(r'MAIN_page\[\] PROGMEM = R"=====\((.*?)\)=====";',
+                      source, re.S)
+    if not match:
+        raise RuntimeError("MAIN_page not found in %s" % SOURCE)
+    page = match.group(1)
+
+    parts = ["// generated by Tools/web_assets.py from Index.h, do not edit",
+             "#pragma once", "", "#include <Arduino.h>", "",
+             "#define WEB_ASSETS 1"]
+    tag = SCRIPT_TAG.search(page)
+    chart = fetch_chart(root, tag.group(1), tag.group(2),
+                        tag.group(3)) if tag else None
+    if chart is not None:
+        path = "/chart-%s.umd.min.js" % tag.group(2)
+        page = page.replace(tag.group(0), '<script src="%s"></script>' % path)
+        text, size, compressed = asset("WEB_CHART_JS", chart)
+        parts += ['#define WEB_CHART_JS_PATH "%s"' % path, "", text]
+        print("web_assets: Chart.js %d -> %d bytes" % (size, compressed))
+    text, size, compressed = asset("WEB_MAIN_PAGE", page.encode())
+    parts += ["", text]
+    print("web_assets: main page %d -> %d bytes" % (size, compressed))
+
+    output = "\n".join(parts)
+    path = os.path.join(root, OUTPUT)
+    # keep the timestamp if nothing changed, no needless rebuilds
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == output:
+                return
+    with open(path, "w") as f:
+        f.write(output)
+
+
+try:
+    Import("env")  # noqa: F821, PlatformIO extra script
+except NameError:
+    env = None
+
+if env is not None:
+    generate(env.subst("$PROJECT_DIR"))
+elif __name__ == "__main__":
+    try:
+        generate(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+    except (OSError, RuntimeError) as e:
+        print("error: %s" % e, file=sys.stderr)
+        sys.exit(1)